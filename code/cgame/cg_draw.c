@@ -1404,7 +1404,7 @@ static void CG_DrawTeamOverlay ( qboolean right, qboolean upper ) {
 
                     if ( item ) {
                         CG_DrawPic ( x, y, hudelement.fontWidth, hudelement.fontWidth,
-                                     trap_R_RegisterShader ( item->icon ) );
+                                     CG_ItemIcon( item ) );
                         x += hudelement.fontWidth;
                     }
                 }
@@ -1510,7 +1510,7 @@ static void CG_DrawTeamOverlay ( qboolean right, qboolean upper ) {
 
             		if (item) {
             			CG_DrawPic( xx, y, TINYCHAR_WIDTH, TINYCHAR_HEIGHT,
-            			trap_R_RegisterShader( item->icon ) );
+            			CG_ItemIcon( item ) );
             			if (right) {
             				xx -= TINYCHAR_WIDTH;
             			} else {
@@ -1827,7 +1827,7 @@ static void CG_DrawPowerups ( void ) {
 
             if ( i < 4 ) {
                 CG_DrawFieldHud ( sortedTime[ i ] / 1000, HUD_PU1+i );
-                CG_DrawHudIcon ( HUD_PU1ICON + i, qfalse, trap_R_RegisterShader ( item->icon ) );
+                CG_DrawHudIcon ( HUD_PU1ICON + i, qfalse, CG_ItemIcon( item ) );
                 if ( sorted[i] == PW_QUAD ) {
                     CG_DrawFieldFontsize(cgs.hud[HUD_PU1ICON + i].xpos, cgs.hud[HUD_PU1ICON + i].ypos, 2, cg.quadKills, 10, 10);
                 }
@@ -3009,7 +3009,7 @@ static void CG_DrawDisconnect ( void ) {
         return;
     }
 
-    CG_DrawHudIcon ( HUD_NETGRAPH, qfalse, trap_R_RegisterShader ( "gfx/2d/net.tga" ) );
+    CG_DrawHudIcon ( HUD_NETGRAPH, qfalse, CG_CachedShader ( "gfx/2d/net.tga" ) );
 }
 
 
@@ -3811,10 +3811,7 @@ static void CG_DrawVoteMap ( void ) {
             }
         }
 
-        levelshot = trap_R_RegisterShaderNoMip( va( "levelshots/%s.tga", mapstring ) );
-        if ( !levelshot ) {
-                levelshot = trap_R_RegisterShaderNoMip( "menu/art/unknownmap" );
-        }
+        levelshot = CG_LevelshotShader( mapstring );
         trap_R_SetColor( NULL );
         CG_DrawPic( 0, 0, 100, 100 , levelshot );
     }
@@ -3863,10 +3860,7 @@ static void CG_DrawVoteMap ( void ) {
 
 
             //CG_Printf("%i %s found\n",nummaps,mapstring);
-            levelshot = trap_R_RegisterShaderNoMip( va( "levelshots/%s.tga", mapstring ) );
-            if ( !levelshot ) {
-                levelshot = trap_R_RegisterShaderNoMip( "menu/art/unknownmap" );
-            }
+            levelshot = CG_LevelshotShader( mapstring );
             trap_R_SetColor( NULL );
             //CG_DrawPic( 0, 0, 100, 100 , levelshot );
             CG_DrawPic( j*xsize, yoffset, xsize, xsize , levelshot );
@@ -4651,7 +4645,7 @@ void CG_DrawActive ( stereoFrame_t stereoView, qboolean draw2d ) {
     }
     
     if( cg_mapoverview.integer /*&& cgs.clientinfo[cg.clientNum].team == TEAM_SPECTATOR*/ ){
-	    picture = trap_R_RegisterShader("mapoverview/ztn3tourney1.tga");
+	    picture = CG_CachedShader("mapoverview/ztn3tourney1.tga");
 	    CG_DrawPic(0,0,640,480,picture);
 	    //CG_FillRect(0, 0, 640, 480, colorBlack);
 	    CG_DrawOverviewEntities();
@@ -137,97 +137,629 @@ void CG_DrawLine( float x1, float y1, float x2, float y2, float* color ) {
 
 /*
 ================
-CG_DrawHudIcon
+CG_CharsetShader
 
-Draws an icon defined 
-in the hudfile
+Picks the font resolution for characters of the given virtual height
+================
+*/
+static qhandle_t CG_CharsetShader( int height ) {
+	if ( !cg_hiResCharset.integer || height * cgs.screenYScale <= 16 ) {
+		return cgs.media.charsetShader;
+	} else if ( height * cgs.screenYScale <= 32 ) {
+		return cgs.media.charsetShader32;
+	} else if ( height * cgs.screenYScale <= 64 ) {
+		return cgs.media.charsetShader64;
+	}
+	return cgs.media.charsetShader128;
+}
 
-TODO: add function CG_SetTeamColor( vec4_t *color )
-and CG_SetTeamBGColor( vec4_t *color )
-=================
+/*
+================
+Glyph runs
+
+A string is preprocessed once into the characters that are actually
+drawn plus the colour index each of them is drawn with, with the colour
+escapes removed. Runs of short strings are kept in a direct mapped
+cache keyed by the string, so text that is drawn every frame (chat,
+scoreboard, obituaries, hud) is not rescanned for colour codes and its
+width is known without another pass. Size, position and style are
+applied when the run is drawn.
+================
 */
-void CG_DrawHudIcon( int hudnumber, qboolean override, qhandle_t hShader ) {
-	hudElements_t hudelement = cgs.hud[hudnumber];
-	vec4_t color;
-	
-	if( !hudelement.inuse )
+#define	GLYPH_RUN_CACHE		256		// must be a power of two
+#define	MAX_CACHED_GLYPHS	256
+#define	GLYPH_BASE_COLOR	255		// the colour passed in by the caller
+
+typedef struct {
+	int		numGlyphs;
+	byte	*glyphs;
+	byte	*colors;
+} glyphRun_t;
+
+typedef struct {
+	char		text[MAX_CACHED_GLYPHS];
+	byte		glyphs[MAX_CACHED_GLYPHS];
+	byte		colors[MAX_CACHED_GLYPHS];
+	glyphRun_t	run;
+} cachedGlyphRun_t;
+
+static cachedGlyphRun_t	glyphRunCache[GLYPH_RUN_CACHE];
+static byte				scratchGlyphs[MAX_STRING_CHARS];
+static byte				scratchColors[MAX_STRING_CHARS];
+static glyphRun_t		scratchRun;
+
+static void CG_LayoutGlyphRun( glyphRun_t *run, const char *string, int maxGlyphs ) {
+	const char	*s;
+	int			color;
+
+	color = GLYPH_BASE_COLOR;
+	run->numGlyphs = 0;
+	for ( s = string ; *s && run->numGlyphs < maxGlyphs ; s++ ) {
+		if ( Q_IsColorString( s ) ) {
+			color = ColorIndex( *(s+1) );
+			s++;
+			continue;
+		}
+		run->glyphs[run->numGlyphs] = *s;
+		run->colors[run->numGlyphs] = color;
+		run->numGlyphs++;
+	}
+}
+
+/*
+================
+CG_GlyphRun
+
+Strings too long for the cache are laid out into a scratch run that is
+only valid until the next call. Anything past MAX_STRING_CHARS glyphs
+would be off screen anyway.
+================
+*/
+static const glyphRun_t *CG_GlyphRun( const char *string ) {
+	cachedGlyphRun_t	*entry;
+	unsigned			hash;
+	int					len;
+
+	hash = 0;
+	for ( len = 0 ; string[len] ; len++ ) {
+		hash = hash * 31 + (byte)string[len];
+	}
+
+	if ( len >= MAX_CACHED_GLYPHS ) {
+		scratchRun.glyphs = scratchGlyphs;
+		scratchRun.colors = scratchColors;
+		CG_LayoutGlyphRun( &scratchRun, string, MAX_STRING_CHARS );
+		return &scratchRun;
+	}
+
+	entry = &glyphRunCache[ hash & ( GLYPH_RUN_CACHE - 1 ) ];
+	if ( entry->run.glyphs && !strcmp( entry->text, string ) ) {
+		return &entry->run;
+	}
+
+	strcpy( entry->text, string );
+	entry->run.glyphs = entry->glyphs;
+	entry->run.colors = entry->colors;
+	CG_LayoutGlyphRun( &entry->run, string, MAX_CACHED_GLYPHS );
+	return &entry->run;
+}
+
+/*
+================
+CG_DrawGlyphRun
+
+Draws the first maxChars glyphs of a run. The colour is only changed
+where it actually differs from the previous glyph.
+================
+*/
+static void CG_DrawGlyphRun( const glyphRun_t *run, int x, int y, const float *setColor,
+		qboolean forceColor, qboolean shadow, int charWidth, int charHeight, int maxChars ) {
+	vec4_t		color;
+	qhandle_t	shader;
+	float		xscale, yscale;
+	float		ax, ay, aw, ah, sx, sy;
+	float		frow, fcol;
+	int			i, count, ch, current;
+
+	count = run->numGlyphs;
+	if ( maxChars > 0 && maxChars < count ) {
+		count = maxChars;
+	}
+	if ( !count ) {
 		return;
-	
-	if( cgs.gametype >= GT_TEAM && hudelement.teamBgColor == 1 ){
-		if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-			color[0] = 1;
-			color[1] = 0;
-			color[2] = 0;
-		} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-			color[0] = 0;
-			color[1] = 0;
-			color[2] = 1;
+	}
+
+	xscale = ( (float)cg.refdef.width ) / 640.0f;
+	yscale = ( (float)cg.refdef.height ) / 480.0f;
+	ax = cg.refdef.x + x * xscale;
+	ay = cg.refdef.y + y * yscale;
+	aw = charWidth * xscale;
+	ah = charHeight * yscale;
+	shader = CG_CharsetShader( charHeight );
+
+	if ( shadow ) {
+		color[0] = color[1] = color[2] = 0;
+		color[3] = setColor[3];
+		trap_R_SetColor( color );
+		sx = ax + 2 * xscale;
+		sy = ay + 2 * yscale;
+		for ( i = 0 ; i < count ; i++, sx += aw ) {
+			ch = run->glyphs[i];
+			if ( ch == ' ' ) {
+				continue;
+			}
+			frow = ( ch >> 4 ) * 0.0625;
+			fcol = ( ch & 15 ) * 0.0625;
+			trap_R_DrawStretchPic( sx, sy, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, shader );
 		}
 	}
-	else if( cgs.gametype >= GT_TEAM && hudelement.teamBgColor == 2 ){
-		if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-			color[0] = 1;
-			color[1] = 0;
-			color[2] = 0;
-		} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-			color[0] = 0;
-			color[1] = 0;
-			color[2] = 1;
+
+	trap_R_SetColor( setColor );
+	current = GLYPH_BASE_COLOR;
+	for ( i = 0 ; i < count ; i++, ax += aw ) {
+		if ( !forceColor && run->colors[i] != current ) {
+			current = run->colors[i];
+			if ( current == GLYPH_BASE_COLOR ) {
+				trap_R_SetColor( setColor );
+			} else {
+				memcpy( color, g_color_table[current], sizeof( color ) );
+				color[3] = setColor[3];
+				trap_R_SetColor( color );
+			}
+		}
+		ch = run->glyphs[i];
+		if ( ch == ' ' ) {
+			continue;
+		}
+		frow = ( ch >> 4 ) * 0.0625;
+		fcol = ( ch & 15 ) * 0.0625;
+		trap_R_DrawStretchPic( ax, ay, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, shader );
+	}
+	trap_R_SetColor( NULL );
+}
+
+/*
+================
+Retained superhud draw lists
+
+Every hud element remembers the draw calls it issued, already adjusted
+to screen coordinates. While the element definition, its bound text,
+the team colouring and the viewport stay the same, the calls are
+replayed as they are instead of resolving colours, alignment and colour
+escapes for every glyph again. Elements whose values change (health,
+ammo, timers) rebuild only their own list.
+
+An element has a list for each way it is drawn (icon, string, scores)
+and for each multiview window, so drawing it several times in a frame
+does not throw the other lists away.
+================
+*/
+#define MAX_HUD_OPS		8192
+#define MAX_HUD_TEXT	256
+#define MAX_HUD_VIEWS	4		// the main view and three multiview windows
+
+typedef enum {
+	HOP_COLOR,
+	HOP_NOCOLOR,
+	HOP_PIC
+} hudOpType_t;
+
+typedef struct {
+	hudOpType_t	type;
+	float		v[8];		// x y w h s1 t1 s2 t2, or the color
+	qhandle_t	shader;
+} hudOp_t;
+
+typedef enum {
+	HUDLIST_ICON,
+	HUDLIST_STRING,
+	HUDLIST_SCORES,
+	HUDLIST_NUMTYPES
+} hudListType_t;
+
+typedef struct {
+	qboolean		built;
+	int				generation;
+	int				pool;
+	hudListType_t	type;
+	int				flags;
+	qhandle_t		shader;
+	int				team;
+	int				charset;
+	float			viewport[4];
+	char			text[MAX_HUD_TEXT];
+
+	int				firstOp;	// slot owned in hudOps
+	int				maxOps;
+	int				numOps;
+	int				buildOp;	// where the list is emitted while rebuilding
+
+	int				rebuilds;
+	int				frames;
+} hudList_t;
+
+static hudOp_t		hudOps[MAX_HUD_OPS];
+static int			numHudOps;
+static int			hudPool;
+static qboolean		hudOpsOverflow;
+static hudList_t	hudLists[MAX_HUD_VIEWS][HUD_MAX][HUDLIST_NUMTYPES];
+static int			hudView;
+
+/*
+================
+CG_HudListView
+
+Selects the lists of a multiview window, 0 is the main view
+================
+*/
+void CG_HudListView( int view ) {
+	if ( view < 0 || view >= MAX_HUD_VIEWS ) {
+		view = 0;
+	}
+	hudView = view;
+}
+
+static int CG_HudTeam( void ) {
+	if ( cgs.gametype < GT_TEAM ) {
+		return TEAM_FREE;
+	}
+	return cg.snap->ps.persistant[PERS_TEAM];
+}
+
+/*
+================
+CG_HudTeamColor
+
+teamColor 1 paints the element in the own team colour, 2 in the enemy
+one. Anybody not on red or blue keeps the colour from the hud file.
+================
+*/
+static void CG_HudTeamColor( int teamColor, const float *base, float *out ) {
+	int		team;
+
+	out[0] = base[0];
+	out[1] = base[1];
+	out[2] = base[2];
+	out[3] = base[3];
+
+	if ( cgs.gametype < GT_TEAM || !teamColor ) {
+		return;
+	}
+
+	team = cg.snap->ps.persistant[PERS_TEAM];
+	if ( teamColor == 2 ) {
+		if ( team == TEAM_RED ) {
+			team = TEAM_BLUE;
+		} else if ( team == TEAM_BLUE ) {
+			team = TEAM_RED;
 		}
 	}
-	else{
-		color[0] = hudelement.bgcolor[0];
-		color[1] = hudelement.bgcolor[1];
-		color[2] = hudelement.bgcolor[2];
+
+	if ( team == TEAM_RED ) {
+		out[0] = 1;
+		out[1] = 0;
+		out[2] = 0;
+	} else if ( team == TEAM_BLUE ) {
+		out[0] = 0;
+		out[1] = 0;
+		out[2] = 1;
 	}
-	color[3] = hudelement.bgcolor[3];
-	
-	if( hudelement.fill ){
-		CG_FillRect( hudelement.xpos, hudelement.ypos, hudelement.width, hudelement.height, color );
+}
+
+static qboolean CG_HudListValid( hudList_t *list, hudListType_t type, int flags, qhandle_t shader, const char *text ) {
+	if ( !list->built || list->generation != cgs.hudGeneration || list->pool != hudPool ) {
+		return qfalse;
 	}
-	else{
-		CG_DrawRect( hudelement.xpos, hudelement.ypos, hudelement.width, hudelement.height, 1.0f, color );
+	if ( list->type != type || list->flags != flags || list->shader != shader ) {
+		return qfalse;
 	}
-	
-	if( cgs.gametype >= GT_TEAM && hudelement.teamColor == 1 ){
-		if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-			color[0] = 1;
-			color[1] = 0;
-			color[2] = 0;
-		} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-			color[0] = 0;
-			color[1] = 0;
-			color[2] = 1;
+	if ( list->team != CG_HudTeam() || list->charset != cg_hiResCharset.integer ) {
+		return qfalse;
+	}
+	if ( list->viewport[0] != cg.refdef.x || list->viewport[1] != cg.refdef.y
+		|| list->viewport[2] != cg.refdef.width || list->viewport[3] != cg.refdef.height ) {
+		return qfalse;
+	}
+	if ( text && strcmp( list->text, text ) ) {
+		return qfalse;
+	}
+	return qtrue;
+}
+
+static void CG_HudListBegin( hudList_t *list, hudListType_t type, int flags, qhandle_t shader, const char *text ) {
+	list->type = type;
+	list->flags = flags;
+	list->shader = shader;
+	list->team = CG_HudTeam();
+	list->charset = cg_hiResCharset.integer;
+	list->viewport[0] = cg.refdef.x;
+	list->viewport[1] = cg.refdef.y;
+	list->viewport[2] = cg.refdef.width;
+	list->viewport[3] = cg.refdef.height;
+	list->generation = cgs.hudGeneration;
+	list->built = qtrue;
+	list->rebuilds++;
+
+	list->text[0] = '\0';
+	if ( text ) {
+		if ( strlen( text ) < sizeof( list->text ) ) {
+			strcpy( list->text, text );
+		} else {
+			// too long to be used as a key, rebuild it every frame
+			list->built = qfalse;
 		}
 	}
-	else if( cgs.gametype >= GT_TEAM && hudelement.teamColor == 2 ){
-		if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-			color[0] = 1;
-			color[1] = 0;
-			color[2] = 0;
-		} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-			color[0] = 0;
-			color[1] = 0;
-			color[2] = 1;
+
+	hudOpsOverflow = qfalse;
+	if ( list->pool != hudPool ) {
+		list->pool = hudPool;
+		list->firstOp = 0;
+		list->maxOps = 0;
+	}
+	list->buildOp = numHudOps;
+	list->numOps = 0;
+}
+
+/*
+================
+CG_HudListEnd
+
+Returns qfalse if the op pool ran out and the list has to be emitted again.
+The pool is then emptied and every other list rebuilds on its next draw.
+A list that doesn't fit even into the empty pool is drawn truncated.
+================
+*/
+static qboolean CG_HudListEnd( hudList_t *list ) {
+	if ( hudOpsOverflow && list->buildOp > 0 ) {
+		numHudOps = 0;
+		hudPool++;
+		return qfalse;
+	}
+
+	// reuse the old slot if the new list fits, so elements rebuilt
+	// every frame do not eat up the pool
+	if ( list->numOps <= list->maxOps ) {
+		memcpy( &hudOps[list->firstOp], &hudOps[list->buildOp], list->numOps * sizeof( hudOp_t ) );
+		numHudOps = list->buildOp;
+	} else {
+		list->firstOp = list->buildOp;
+		list->maxOps = list->numOps;
+	}
+	return qtrue;
+}
+
+static void CG_HudListDraw( hudList_t *list ) {
+	hudOp_t	*op;
+	int		i;
+
+	list->frames++;
+	for ( i = 0, op = &hudOps[list->firstOp] ; i < list->numOps ; i++, op++ ) {
+		switch ( op->type ) {
+		case HOP_COLOR:
+			trap_R_SetColor( op->v );
+			break;
+		case HOP_NOCOLOR:
+			trap_R_SetColor( NULL );
+			break;
+		default:
+			trap_R_DrawStretchPic( op->v[0], op->v[1], op->v[2], op->v[3],
+				op->v[4], op->v[5], op->v[6], op->v[7], op->shader );
+			break;
 		}
 	}
-	else{
-		color[0] = hudelement.color[0];
-		color[1] = hudelement.color[1];
-		color[2] = hudelement.color[2];
+}
+
+static hudOp_t *CG_HudOp( hudList_t *list, hudOpType_t type ) {
+	hudOp_t	*op;
+
+	if ( numHudOps >= MAX_HUD_OPS ) {
+		hudOpsOverflow = qtrue;
+		return NULL;
 	}
-	color[3] = hudelement.color[3];
-	
-	trap_R_SetColor(color);
-	
-	if( hudelement.imageHandle && override ){
-		CG_DrawPic(hudelement.xpos, hudelement.ypos, hudelement.width, hudelement.height, hudelement.imageHandle);
+	op = &hudOps[numHudOps++];
+	op->type = type;
+	list->numOps++;
+	return op;
+}
+
+static void CG_HudEmitColor( hudList_t *list, const float *color ) {
+	hudOp_t	*op;
+
+	op = CG_HudOp( list, color ? HOP_COLOR : HOP_NOCOLOR );
+	if ( op && color ) {
+		op->v[0] = color[0];
+		op->v[1] = color[1];
+		op->v[2] = color[2];
+		op->v[3] = color[3];
+	}
+}
+
+// coordinates are already adjusted to the screen
+static void CG_HudEmitStretchPic( hudList_t *list, float x, float y, float w, float h,
+		float s1, float t1, float s2, float t2, qhandle_t shader ) {
+	hudOp_t	*op;
+
+	op = CG_HudOp( list, HOP_PIC );
+	if ( op ) {
+		op->v[0] = x;
+		op->v[1] = y;
+		op->v[2] = w;
+		op->v[3] = h;
+		op->v[4] = s1;
+		op->v[5] = t1;
+		op->v[6] = s2;
+		op->v[7] = t2;
+		op->shader = shader;
+	}
+}
+
+static void CG_HudEmitPic( hudList_t *list, float x, float y, float w, float h, qhandle_t shader ) {
+	CG_AdjustFrom640( &x, &y, &w, &h );
+	CG_HudEmitStretchPic( list, x, y, w, h, 0, 0, 1, 1, shader );
+}
+
+// same output as CG_FillRect / CG_DrawRect
+static void CG_HudEmitRect( hudList_t *list, float x, float y, float w, float h, qboolean fill, const float *color ) {
+	float	xsize, ysize;
+
+	CG_HudEmitColor( list, color );
+	CG_AdjustFrom640( &x, &y, &w, &h );
+	if ( fill ) {
+		CG_HudEmitStretchPic( list, x, y, w, h, 0, 0, 0, 0, cgs.media.whiteShader );
+	} else {
+		xsize = cgs.screenXScale;
+		ysize = cgs.screenYScale;
+		CG_HudEmitStretchPic( list, x, y, w, ysize, 0, 0, 0, 0, cgs.media.whiteShader );
+		CG_HudEmitStretchPic( list, x, y + h - ysize, w, ysize, 0, 0, 0, 0, cgs.media.whiteShader );
+		CG_HudEmitStretchPic( list, x, y, xsize, h, 0, 0, 0, 0, cgs.media.whiteShader );
+		CG_HudEmitStretchPic( list, x + w - xsize, y, xsize, h, 0, 0, 0, 0, cgs.media.whiteShader );
+	}
+	CG_HudEmitColor( list, NULL );
+}
+
+// same output as CG_DrawStringExt
+static void CG_HudEmitString( hudList_t *list, int x, int y, const char *string, const float *setColor,
+		qboolean shadow, int charWidth, int charHeight ) {
+	const glyphRun_t	*run;
+	vec4_t				color;
+	qhandle_t			shader;
+	float				ax, ay, aw, ah, sx, sy;
+	float				frow, fcol;
+	int					i, ch, current;
+
+	run = CG_GlyphRun( string );
+	if ( !run->numGlyphs ) {
 		return;
 	}
-	if( hShader ){
-		CG_DrawPic(hudelement.xpos, hudelement.ypos, hudelement.width, hudelement.height, hShader);
+
+	ax = x;
+	ay = y;
+	aw = charWidth;
+	ah = charHeight;
+	CG_AdjustFrom640( &ax, &ay, &aw, &ah );
+	shader = CG_CharsetShader( charHeight );
+
+	if ( shadow ) {
+		color[0] = color[1] = color[2] = 0;
+		color[3] = setColor[3];
+		CG_HudEmitColor( list, color );
+		sx = ax + 2 * cg.refdef.width / 640.0f;
+		sy = ay + 2 * cg.refdef.height / 480.0f;
+		for ( i = 0 ; i < run->numGlyphs ; i++, sx += aw ) {
+			ch = run->glyphs[i];
+			if ( ch == ' ' ) {
+				continue;
+			}
+			frow = ( ch >> 4 ) * 0.0625;
+			fcol = ( ch & 15 ) * 0.0625;
+			CG_HudEmitStretchPic( list, sx, sy, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, shader );
+		}
+	}
+
+	CG_HudEmitColor( list, setColor );
+	current = GLYPH_BASE_COLOR;
+	for ( i = 0 ; i < run->numGlyphs ; i++, ax += aw ) {
+		if ( run->colors[i] != current ) {
+			current = run->colors[i];
+			if ( current == GLYPH_BASE_COLOR ) {
+				CG_HudEmitColor( list, setColor );
+			} else {
+				memcpy( color, g_color_table[current], sizeof( color ) );
+				color[3] = setColor[3];
+				CG_HudEmitColor( list, color );
+			}
+		}
+		ch = run->glyphs[i];
+		if ( ch == ' ' ) {
+			continue;
+		}
+		frow = ( ch >> 4 ) * 0.0625;
+		fcol = ( ch & 15 ) * 0.0625;
+		CG_HudEmitStretchPic( list, ax, ay, aw, ah, fcol, frow, fcol + 0.0625, frow + 0.0625, shader );
 	}
-	trap_R_SetColor( NULL );
+	CG_HudEmitColor( list, NULL );
+}
+
+static int CG_HudTextX( const hudElements_t *hudelement, const char *text ) {
+	int		w;
+
+	w = CG_DrawStrlen( text ) * hudelement->fontWidth;
+
+	if ( hudelement->textAlign == 0 )
+		return hudelement->xpos;
+	else if ( hudelement->textAlign == 2 )
+		return hudelement->xpos + hudelement->width - w;
+	return hudelement->xpos + hudelement->width/2 - w/2;
+}
+
+static void CG_HudEmitIcon( hudList_t *list, const hudElements_t *hudelement, qboolean override, qhandle_t hShader ) {
+	vec4_t	color;
+
+	CG_HudTeamColor( hudelement->teamBgColor, hudelement->bgcolor, color );
+	CG_HudEmitRect( list, hudelement->xpos, hudelement->ypos, hudelement->width, hudelement->height,
+		hudelement->fill, color );
+
+	if ( hudelement->imageHandle && override ) {
+		hShader = hudelement->imageHandle;
+	}
+	if ( hShader ) {
+		CG_HudTeamColor( hudelement->teamColor, hudelement->color, color );
+		CG_HudEmitColor( list, color );
+		CG_HudEmitPic( list, hudelement->xpos, hudelement->ypos, hudelement->width, hudelement->height, hShader );
+		CG_HudEmitColor( list, NULL );
+	}
+}
+
+/*
+================
+CG_HudListStats
+
+Draw calls per frame, and rebuilds and draws of a hud element since the
+last call, for hudedit cost.  All the lists of the element are counted
+together
+================
+*/
+void CG_HudListStats( int hudnumber, int *ops, int *rebuilds, int *frames ) {
+	hudList_t	*list;
+	int			i, j;
+
+	*ops = *rebuilds = *frames = 0;
+	for ( i = 0 ; i < MAX_HUD_VIEWS ; i++ ) {
+		for ( j = 0 ; j < HUDLIST_NUMTYPES ; j++ ) {
+			list = &hudLists[i][hudnumber][j];
+			if ( list->built && list->frames ) {
+				*ops += list->numOps;
+			}
+			*rebuilds += list->rebuilds;
+			*frames += list->frames;
+			list->rebuilds = 0;
+			list->frames = 0;
+		}
+	}
+}
+
+/*
+================
+CG_DrawHudIcon
+
+Draws an icon defined 
+in the hudfile
+=================
+*/
+void CG_DrawHudIcon( int hudnumber, qboolean override, qhandle_t hShader ) {
+	hudList_t	*list;
+
+	if ( !cgs.hud[hudnumber].inuse )
+		return;
+
+	list = &hudLists[hudView][hudnumber][HUDLIST_ICON];
+	if ( !CG_HudListValid( list, HUDLIST_ICON, override, hShader, NULL ) ) {
+		do {
+			CG_HudListBegin( list, HUDLIST_ICON, override, hShader, NULL );
+			CG_HudEmitIcon( list, &cgs.hud[hudnumber], override, hShader );
+		} while ( !CG_HudListEnd( list ) );
+	}
+	CG_HudListDraw( list );
 }
 
 /*
@@ -237,79 +769,37 @@ CG_DrawScoresHud
 Draws the scores
 (enemy, own, scorelimit)
 if defined in hud
-  
-TODO: add function CG_SetTeamColor( vec4_t *color )
-and CG_SetTeamBGColor( vec4_t *color )
 =================
 */
 void CG_DrawScoresHud( int hudnumber, const char* text, qboolean spec ){
-	hudElements_t hudelement = cgs.hud[hudnumber];
-	vec4_t color;
-	int x,y, w;
-	qboolean shadow;
+	hudElements_t	*hudelement = &cgs.hud[hudnumber];
+	hudList_t		*list;
+	vec4_t			color;
 	
-	if( !hudelement.inuse )
+	if( !hudelement->inuse )
 		return;
-	
-	shadow = hudelement.textstyle & 1;
-	if( !spec ){
-		if( cgs.gametype >= GT_TEAM && hudelement.teamBgColor == 1 ){
-			if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-				color[0] = 1;
-				color[1] = 0;
-				color[2] = 0;
-			} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-				color[0] = 0;
-				color[1] = 0;
-				color[2] = 1;
-			}
-		}
-		else if( cgs.gametype >= GT_TEAM && hudelement.teamBgColor == 2 ){
-			if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-				color[0] = 1;
-				color[1] = 0;
-				color[2] = 0;
-			} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-				color[0] = 0;
-				color[1] = 0;
-				color[2] = 1;
+
+	list = &hudLists[hudView][hudnumber][HUDLIST_SCORES];
+	if ( !CG_HudListValid( list, HUDLIST_SCORES, spec, 0, text ) ) {
+		do {
+			CG_HudListBegin( list, HUDLIST_SCORES, spec, 0, text );
+
+			if ( !spec ) {
+				CG_HudTeamColor( hudelement->teamBgColor, hudelement->bgcolor, color );
+			} else {
+				color[0] = color[1] = color[2] = color[3] = 0.5f;
 			}
-		}	
-		else{
-			color[0] = hudelement.bgcolor[0];
-			color[1] = hudelement.bgcolor[1];
-			color[2] = hudelement.bgcolor[2];
-		}
-	color[3] = hudelement.bgcolor[3];
+			CG_HudEmitRect( list, hudelement->xpos, hudelement->ypos, hudelement->width, hudelement->height,
+				qtrue, color );
+
+			CG_HudEmitString( list, CG_HudTextX( hudelement, text ),
+				hudelement->ypos + hudelement->height/2 - hudelement->fontHeight/2,
+				text, hudelement->color, hudelement->textstyle & 1,
+				hudelement->fontWidth, hudelement->fontHeight );
+		} while ( !CG_HudListEnd( list ) );
 	}
-	else{
-		color[0] = color[1] = color[2] = color[3] = 0.5f;
-	}
-	CG_FillRect( hudelement.xpos, hudelement.ypos, hudelement.width, hudelement.height, color );
-	
-	y = hudelement.ypos + hudelement.height/2 - hudelement.fontHeight/2;
-	
-	w = CG_DrawStrlen(text) * hudelement.fontWidth;
-		
-	if( hudelement.textAlign == 0 )
-		x = hudelement.xpos;
-	else if( hudelement.textAlign == 2 )
-		x = hudelement.xpos + hudelement.width - w;
-	else
-		x = hudelement.xpos + hudelement.width/2 - w/2;
-
-	
-	color[0] = hudelement.color[0];
-	color[1] = hudelement.color[1];
-	color[2] = hudelement.color[2];
-	color[3] = hudelement.color[3];
-	
-	
-		
-	CG_DrawStringExt( x, y, text, color, qfalse, shadow, hudelement.fontWidth, hudelement.fontHeight, 0 );
+	CG_HudListDraw( list );
 }
-	
-	
 
 /*
 ===============
@@ -342,33 +832,10 @@ void CG_DrawChar( int x, int y, int width, int height, int ch ) {
 	frow = row*0.0625;
 	fcol = col*0.0625;
 	size = 0.0625;
-	if( cg_hiResCharset.integer ){
-		if ( height*cgs.screenYScale <= 16 )
-			trap_R_DrawStretchPic( ax, ay, aw, ah,
- 					   fcol, frow, 
- 					   fcol + size, frow + size, 
- 					   cgs.media.charsetShader );
-		else if ( height*cgs.screenYScale <= 32 )
-			trap_R_DrawStretchPic( ax, ay, aw, ah,
-					   fcol, frow, 
-					   fcol + size, frow + size, 
-					   cgs.media.charsetShader32 );
-		else if ( height*cgs.screenYScale <= 64 )
-			trap_R_DrawStretchPic( ax, ay, aw, ah,
-					   fcol, frow, 
-					   fcol + size, frow + size, 
-					   cgs.media.charsetShader64 );
-		else 
-			trap_R_DrawStretchPic( ax, ay, aw, ah,
+	trap_R_DrawStretchPic( ax, ay, aw, ah,
 					   fcol, frow, 
 					   fcol + size, frow + size, 
-					   cgs.media.charsetShader128 );
-	}
-	else
-		trap_R_DrawStretchPic( ax, ay, aw, ah,
-					   fcol, frow, 
-					   fcol + size, frow + size, 
-					   cgs.media.charsetShader );
+					   CG_CharsetShader( height ) );
 }
 
 
@@ -384,55 +851,8 @@ Coordinates are at 640 by 480 virtual resolution
 */
 void CG_DrawStringExt( int x, int y, const char *string, const float *setColor, 
 		qboolean forceColor, qboolean shadow, int charWidth, int charHeight, int maxChars ) {
-	vec4_t		color;
-	const char	*s;
-	int			xx;
-	int			cnt;
-
-	if (maxChars <= 0)
-		maxChars = 32767; // do them all!
-
-	// draw the drop shadow
-	if (shadow) {
-		color[0] = color[1] = color[2] = 0;
-		color[3] = setColor[3];
-		trap_R_SetColor( color );
-		s = string;
-		xx = x;
-		cnt = 0;
-		while ( *s && cnt < maxChars) {
-			if ( Q_IsColorString( s ) ) {
-				s += 2;
-				continue;
-			}
-			CG_DrawChar( xx + 2, y + 2, charWidth, charHeight, *s );
-			cnt++;
-			xx += charWidth;
-			s++;
-		}
-	}
-
-	// draw the colored text
-	s = string;
-	xx = x;
-	cnt = 0;
-	trap_R_SetColor( setColor );
-	while ( *s && cnt < maxChars) {
-		if ( Q_IsColorString( s ) ) {
-			if ( !forceColor ) {
-				memcpy( color, g_color_table[ColorIndex(*(s+1))], sizeof( color ) );
-				color[3] = setColor[3];
-				trap_R_SetColor( color );
-			}
-			s += 2;
-			continue;
-		}
-		CG_DrawChar( xx, y, charWidth, charHeight, *s );
-		xx += charWidth;
-		cnt++;
-		s++;
-	}
-	trap_R_SetColor( NULL );
+	CG_DrawGlyphRun( CG_GlyphRun( string ), x, y, setColor, forceColor, shadow,
+		charWidth, charHeight, maxChars );
 }
 
 /*
@@ -441,72 +861,34 @@ CG_DrawStringHud
 
 Draws a string
 if defined in hud
-  
-TODO: add function CG_SetTeamColor( vec4_t *color )
-and CG_SetTeamBGColor( vec4_t *color )
-
-maybe add override for some elements
 =================
 */
 void CG_DrawStringHud( int hudnumber, qboolean colorize, const char* text ){
-	hudElements_t hudelement = cgs.hud[hudnumber];
-	int w, x;
-	vec4_t color;
-	qboolean shadow = (hudelement.textstyle & 1);
+	hudElements_t	*hudelement = &cgs.hud[hudnumber];
+	hudList_t		*list;
+	vec4_t			color;
 	
-	if( !hudelement.inuse ){
+	if( !hudelement->inuse ){
 		return;
 	}
-	
-	CG_DrawHudIcon( hudnumber, qtrue, hudelement.imageHandle );
-	
-	w = CG_DrawStrlen(text) * hudelement.fontWidth;
-		
-	if( hudelement.textAlign == 0 )
-		x = hudelement.xpos;
-	else if( hudelement.textAlign == 2 )
-		x = hudelement.xpos + hudelement.width - w;
-	else
-		x = hudelement.xpos + hudelement.width/2 - w/2;
-
-	if( colorize ){
-		if( cgs.gametype >= GT_TEAM && hudelement.teamColor == 1 ){
-			if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-				color[0] = 1;
-				color[1] = 0;
-				color[2] = 0;
-			} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-				color[0] = 0;
-				color[1] = 0;
-				color[2] = 1;
-			}
-		}
-		else if( cgs.gametype >= GT_TEAM && hudelement.teamColor == 2 ){
-			if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_BLUE ) {
-				color[0] = 1;
-				color[1] = 0;
-				color[2] = 0;
-			} else if ( cg.snap->ps.persistant[PERS_TEAM] == TEAM_RED ) {
-				color[0] = 0;
-				color[1] = 0;
-				color[2] = 1;
+
+	list = &hudLists[hudView][hudnumber][HUDLIST_STRING];
+	if ( !CG_HudListValid( list, HUDLIST_STRING, colorize, 0, text ) ) {
+		do {
+			CG_HudListBegin( list, HUDLIST_STRING, colorize, 0, text );
+
+			CG_HudEmitIcon( list, hudelement, qtrue, hudelement->imageHandle );
+
+			if ( colorize ) {
+				CG_HudTeamColor( hudelement->teamColor, hudelement->color, color );
+			} else {
+				color[0] = color[1] = color[2] = color[3] = 1.0f;
 			}
-		}
-		else{
-			color[0] = hudelement.color[0];
-			color[1] = hudelement.color[1];
-			color[2] = hudelement.color[2];
-		}
-		color[3] = hudelement.color[3];
-	}
-	else {
-		color[0] = 1.0;
-		color[1] = 1.0;
-		color[2] = 1.0;
-		color[3] = 1.0;
+			CG_HudEmitString( list, CG_HudTextX( hudelement, text ), hudelement->ypos, text, color,
+				hudelement->textstyle & 1, hudelement->fontWidth, hudelement->fontHeight );
+		} while ( !CG_HudListEnd( list ) );
 	}
-		
-	CG_DrawStringExt( x, hudelement.ypos, text, color, qfalse, shadow, hudelement.fontWidth, hudelement.fontHeight, 0 );
+	CG_HudListDraw( list );
 }
 		
 void CG_DrawBigString( int x, int y, const char *s, float alpha ) {
@@ -541,19 +923,7 @@ Returns character count, skiping color escape codes
 =================
 */
 int CG_DrawStrlen( const char *str ) {
-	const char *s = str;
-	int count = 0;
-
-	while ( *s ) {
-		if ( Q_IsColorString( s ) ) {
-			s += 2;
-		} else {
-			count++;
-			s++;
-		}
-	}
-
-	return count;
+	return CG_GlyphRun( str )->numGlyphs;
 }
 
 /*
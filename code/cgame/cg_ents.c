@@ -500,13 +500,13 @@ static void CG_Missile( centity_t *cent ) {
 			ent.customShader = cgs.media.plasmaBallShaderColor;
 			if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 				if( local->team != other->team ){
-					CG_setRGBA( ent.shaderRGBA, cg_enemyWeaponColor.string );
+					Vector4Copy( cgs.cvarColors[CC_ENEMY_WEAPON], ent.shaderRGBA );
 					/*ent.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 					ent.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 					ent.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );*/
 				}
 				else{
-					CG_setRGBA( ent.shaderRGBA, cg_teamWeaponColor.string );
+					Vector4Copy( cgs.cvarColors[CC_TEAM_WEAPON], ent.shaderRGBA );
 					/*
 					ent.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 					ent.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
@@ -514,13 +514,13 @@ static void CG_Missile( centity_t *cent ) {
 				}
 			}
 			else if( cg.clientNum != cg_entities[cent->currentState.otherEntityNum].currentState.number ){
-				CG_setRGBA( ent.shaderRGBA, cg_enemyWeaponColor.string );
+				Vector4Copy( cgs.cvarColors[CC_ENEMY_WEAPON], ent.shaderRGBA );
 				/*ent.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 				ent.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 				ent.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );*/
 			}
 			else{
-				CG_setRGBA( ent.shaderRGBA, cg_teamWeaponColor.string );
+				Vector4Copy( cgs.cvarColors[CC_TEAM_WEAPON], ent.shaderRGBA );
 				/*ent.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 				ent.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
 				ent.shaderRGBA[2] = hexToBlue( cg_teamWeaponColor.string );*/
@@ -543,13 +543,13 @@ static void CG_Missile( centity_t *cent ) {
 		ent.customShader = cgs.media.grenadeSkinColor;
 		if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 			if( local->team != other->team ){
-				CG_setRGBA( ent.shaderRGBA, cg_enemyWeaponColor.string );
+				Vector4Copy( cgs.cvarColors[CC_ENEMY_WEAPON], ent.shaderRGBA );
 				/*ent.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 				ent.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 				ent.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );*/
 			}
 			else{
-				CG_setRGBA( ent.shaderRGBA, cg_teamWeaponColor.string );
+				Vector4Copy( cgs.cvarColors[CC_TEAM_WEAPON], ent.shaderRGBA );
 				/*
 				ent.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 				ent.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
@@ -557,13 +557,13 @@ static void CG_Missile( centity_t *cent ) {
 			}
 		}
 		else if( cg.clientNum != cg_entities[cent->currentState.otherEntityNum].currentState.number ){
-			CG_setRGBA( ent.shaderRGBA, cg_enemyWeaponColor.string );
+			Vector4Copy( cgs.cvarColors[CC_ENEMY_WEAPON], ent.shaderRGBA );
 			/*ent.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 			ent.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 			ent.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );*/
 		}
 		else{
-			CG_setRGBA( ent.shaderRGBA, cg_teamWeaponColor.string );
+			Vector4Copy( cgs.cvarColors[CC_TEAM_WEAPON], ent.shaderRGBA );
 			/*ent.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 			ent.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
 			ent.shaderRGBA[2] = hexToBlue( cg_teamWeaponColor.string );*/
@@ -800,7 +800,7 @@ void CG_EntityEvent( centity_t *cent, vec3_t position ) {
                 }
 #endif
             } else {
-                trap_S_StartSound (NULL, es->number, CHAN_AUTO,	CG_RegisterSoundOption( item->pickup_sound, qfalse ) );
+                trap_S_StartSound (NULL, es->number, CHAN_AUTO,	CG_ItemPickupSound( item ) );
             }
             
             if( cg.demoPlayback ) {
@@ -835,7 +835,7 @@ void CG_EntityEvent( centity_t *cent, vec3_t position ) {
             item = &bg_itemlist[ index ];
             // powerup pickups are global
             if ( item->pickup_sound ) {
-                trap_S_StartSound (NULL, cg.snap->ps.clientNum, CHAN_AUTO, trap_S_RegisterSound( item->pickup_sound, qfalse ) );
+                trap_S_StartSound (NULL, cg.snap->ps.clientNum, CHAN_AUTO, CG_ItemPickupSound( item ) );
             }
 
             // show icon and name on status bar
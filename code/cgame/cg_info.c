@@ -164,15 +164,12 @@ void CG_DrawInformation( void ) {
         sysInfo = CG_ConfigString( CS_SYSTEMINFO );
 
         s = Info_ValueForKey( info, "mapname" );
-        levelshot = trap_R_RegisterShaderNoMip( va( "levelshots/%s.tga", s ) );
-        if ( !levelshot ) {
-                levelshot = trap_R_RegisterShaderNoMip( "menu/art/unknownmap" );
-        }
+        levelshot = CG_LevelshotShader( s );
         trap_R_SetColor( NULL );
         CG_DrawPic( 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, levelshot );
 
         // blend a detail texture over it
-        detail = trap_R_RegisterShader( "levelShotDetail" );
+        detail = CG_CachedShader( "levelShotDetail" );
         trap_R_DrawStretchPic( 0, 0, cgs.glconfig.vidWidth, cgs.glconfig.vidHeight, 0, 0, 2.5, 2, detail );
 
         // draw the icons of things as they are loaded
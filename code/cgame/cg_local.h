@@ -250,6 +250,26 @@ typedef enum {
 	TRAIL_MAX
 } trailType_t;
 
+// colour cvars resolved into cgs.cvarColors whenever they change
+typedef enum {
+	CC_ENEMY_WEAPON,
+	CC_TEAM_WEAPON,
+	CC_DEAD_BODY,
+	CC_ENEMY_HEAD,
+	CC_ENEMY_TORSO,
+	CC_ENEMY_LEGS,
+	CC_TEAM_HEAD,
+	CC_TEAM_TORSO,
+	CC_TEAM_LEGS,
+	CC_RED_HEAD,
+	CC_RED_TORSO,
+	CC_RED_LEGS,
+	CC_BLUE_HEAD,
+	CC_BLUE_TORSO,
+	CC_BLUE_LEGS,
+	CC_MAX
+} cvarColor_t;
+
 typedef enum {
 	LEF_PUFF_DONT_SCALE  = 0x0001,			// do not scale size over time
 	LEF_TUMBLE			 = 0x0002,			// tumble over time, used for ejecting shells
@@ -385,6 +405,7 @@ typedef struct {
 	char			redTeam[MAX_TEAMNAME];
 	char			blueTeam[MAX_TEAMNAME];
 	qboolean		deferred;
+	int				clientModel;	// 1 + index of the shared model cache entry, 0 if none
 
 	qboolean		newAnims;		// true if using the new mission pack animations
 	qboolean		fixedlegs;		// true if legs yaw is always the same as torso yaw
@@ -466,6 +487,7 @@ typedef struct {
 	qhandle_t		icon;
 	qhandle_t		brightSkin;
 	vec3_t 			brightColor;
+	sfxHandle_t		pickupSound;
 } itemInfo_t;
 
 
@@ -1385,6 +1407,8 @@ typedef struct {
 	int				numInlineModels;
 	qhandle_t		inlineDrawModel[MAX_MODELS];
 	vec3_t			inlineModelMidpoints[MAX_MODELS];
+	vec3_t			inlineModelMins[MAX_MODELS];	// broad phase bounds for CG_Trace
+	vec3_t			inlineModelMaxs[MAX_MODELS];
 
 	clientInfo_t	clientinfo[MAX_CLIENTS];
 
@@ -1466,6 +1490,9 @@ typedef struct {
 	int		blueLivingCount;
 	
 	hudElements_t   hud[HUD_MAX];
+	int		hudGeneration;		// bumped whenever cgs.hud changes
+
+	byte		cvarColors[CC_MAX][4];	// parsed colour cvars, see CG_UpdateCvarColors
 	
 	int 		allowMultiview;
 	
@@ -1558,6 +1585,7 @@ extern	vmCvar_t		cg_paused;
 extern	vmCvar_t		cg_blood;
 extern	vmCvar_t		cg_predictItems;
 extern	vmCvar_t		cg_deferPlayers;
+extern	vmCvar_t		cg_playerLoadBudget;
 extern	vmCvar_t		cg_drawFriend;
 extern	vmCvar_t		cg_teamChatsOnly;
 extern	vmCvar_t		cg_noChat;
@@ -1833,6 +1861,11 @@ qboolean CG_Cvar_ClampFloat( const char *name, vmCvar_t *vmCvar, float min, floa
 //
 const char *CG_ConfigString( int index );
 const char *CG_Argv( int arg );
+qhandle_t CG_CachedShader( const char *name );
+qhandle_t CG_CachedShaderNoMip( const char *name );
+qhandle_t CG_LevelshotShader( const char *mapname );
+qhandle_t CG_ItemIcon( const gitem_t *item );
+sfxHandle_t CG_ItemPickupSound( const gitem_t *item );
 
 void QDECL CG_Printf( const char *msg, ... );
 void QDECL CG_Error( const char *msg, ... );
@@ -1915,6 +1948,8 @@ void CG_DrawTopBottom(float x, float y, float w, float h, float size);
 
 void CG_DrawHudIcon( int hudnumber, qboolean override, qhandle_t hShader );
 void CG_DrawScoresHud( int hudnumber, const char* text, qboolean spec );
+void CG_HudListStats( int hudnumber, int *ops, int *rebuilds, int *frames );
+void CG_HudListView( int view );
 
 //
 // cg_draw.c, cg_newDraw.c
@@ -1974,6 +2009,7 @@ int  hexToGreen( char* hexin );
 int  hexToBlue( char* hexin );
 int  hexToAlpha( char* hexin );
 void CG_setRGBA( byte *incolor, char *instring );
+void CG_UpdateCvarColors( qboolean force );
 //
 // cg_predict.c
 //
@@ -1983,6 +2019,9 @@ void CG_Trace( trace_t *result, const vec3_t start, const vec3_t mins, const vec
 					 int skipNumber, int mask );
 void CG_PredictPlayerState( void );
 void CG_LoadDeferredPlayers( void );
+void CG_UpdateClientModels( void );
+void CG_ClearClientModels( void );
+void CG_PreloadModelInfo( void );
 
 
 //
@@ -2139,6 +2178,10 @@ void CG_InitConsoleCommands( void );
 extern int  clientStatsPresent;
 
 void CG_ExecuteNewServerCommands( int latestSequence );
+const char *CG_ServerArgv( int arg );
+int CG_ServerArgc( void );
+int CG_ServerArgInt( int arg );
+float CG_ServerArgFloat( int arg );
 void CG_ParseServerinfo( void );
 void CG_SetConfigValues( void );
 void CG_ShaderStateChanged(void);
@@ -47,6 +47,8 @@ int crosshairsizeModificationCount = -1;
 
 int hitBeepModificationCount = -1;
 
+int soundOptionModificationCount = -1;
+
 int nomipModificationCount = 1;
 
 
@@ -172,6 +174,7 @@ vmCvar_t	cg_paused;
 vmCvar_t	cg_blood;
 vmCvar_t	cg_predictItems;
 vmCvar_t	cg_deferPlayers;
+vmCvar_t	cg_playerLoadBudget;
 vmCvar_t	cg_drawTeamOverlay;
 vmCvar_t	cg_teamOverlayUserinfo;
 vmCvar_t	cg_drawFriend;
@@ -512,6 +515,7 @@ static cvarTable_t cvarTable[] = { // bk001129
 #else
 	{ &cg_deferPlayers, "cg_deferPlayers", "1", CVAR_ARCHIVE },
 #endif
+	{ &cg_playerLoadBudget, "cg_playerLoadBudget", "4", CVAR_ARCHIVE },
 	{ &cg_drawTeamOverlay, "cg_drawTeamOverlay", "0", CVAR_ARCHIVE },
 	{ &cg_teamOverlayUserinfo, "teamoverlay", "0", CVAR_ROM | CVAR_USERINFO },
 	{ &cg_stats, "cg_stats", "0", 0 },
@@ -733,6 +737,21 @@ static int  cvarTableSize = sizeof( cvarTable ) / sizeof( cvarTable[0] );
 CG_RegisterCvars
 =================
 */
+/*
+=================
+CG_SoundOptionModificationCount
+
+Changes whenever any of the sound option cvars changes
+=================
+*/
+static int CG_SoundOptionModificationCount( void ) {
+	return cg_soundOption.modificationCount + cg_soundOptionGauntlet.modificationCount
+		+ cg_soundOptionLightning.modificationCount + cg_soundOptionMachinegun.modificationCount
+		+ cg_soundOptionShotgun.modificationCount + cg_soundOptionRocket.modificationCount
+		+ cg_soundOptionGrenade.modificationCount + cg_soundOptionPlasma.modificationCount
+		+ cg_soundOptionRail.modificationCount + cg_soundOptionBFG.modificationCount;
+}
+
 void CG_RegisterCvars( void ) {
 	int			i;
 	cvarTable_t	*cv;
@@ -753,6 +772,8 @@ void CG_RegisterCvars( void ) {
 	enemyModelModificationCount = cg_enemymodel.modificationCount;
 	teamModelModificationCount = cg_teammodel.modificationCount;
 	forceTeamModelsModificationCount = cg_forceteammodels.modificationCount;
+	soundOptionModificationCount = CG_SoundOptionModificationCount();
+	CG_UpdateCvarColors( qtrue );
 
 	trap_Cvar_Register(NULL, "model", DEFAULT_MODEL, CVAR_USERINFO | CVAR_ARCHIVE );
 	trap_Cvar_Register(NULL, "headmodel", DEFAULT_MODEL, CVAR_USERINFO | CVAR_ARCHIVE );
@@ -833,6 +854,8 @@ void CG_UpdateCvars( void ) {
 
 	// check for modications here
 
+	CG_UpdateCvarColors( qfalse );
+
 	// If team overlay is on, ask for updates from the server.  If its off,
 	// let the server know so we don't receive it
 	if ( drawTeamOverlayModificationCount != cg_drawTeamOverlay.modificationCount ) {
@@ -891,6 +914,13 @@ void CG_UpdateCvars( void ) {
 		hitBeepModificationCount = cg_hitBeep.modificationCount;
 		CG_ParseHitBeep();
 	}
+	if( soundOptionModificationCount != CG_SoundOptionModificationCount() ){
+		soundOptionModificationCount = CG_SoundOptionModificationCount();
+		// pickup sounds are resolved again on the next pickup
+		for( i = 1; i < bg_numItems; i++ ){
+			cg_items[i].pickupSound = 0;
+		}
+	}
 	if( nomipModificationCount != cg_nomip.modificationCount ){
 		nomipModificationCount = cg_nomip.modificationCount;
 		CG_Printf("cg_picmip will be changed upon restarting\n" );
@@ -1067,6 +1097,158 @@ const char *CG_Argv( int arg ) {
 }
 
 
+//========================================================================
+
+/*
+=================
+Media handle cache
+
+HUD and scoreboard code used to call trap_R_RegisterShader every frame,
+which hashes and looks up the name on the other side of the VM boundary.
+Handles are remembered here by name instead. The renderer keeps them
+valid for the whole cgame lifetime, a vid_restart reloads the module.
+=================
+*/
+#define	MEDIA_HASH_SIZE		64
+#define	MAX_CACHED_MEDIA	256
+
+typedef enum {
+	MEDIA_SHADER,
+	MEDIA_SHADER_NOMIP,
+	MEDIA_LEVELSHOT
+} mediaType_t;
+
+typedef struct cachedMedia_s {
+	char					name[MAX_QPATH];
+	mediaType_t				type;
+	qhandle_t				handle;
+	struct cachedMedia_s	*next;
+} cachedMedia_t;
+
+static cachedMedia_t	cachedMedia[MAX_CACHED_MEDIA];
+static cachedMedia_t	*cachedMediaHash[MEDIA_HASH_SIZE];
+static int				numCachedMedia;
+
+static int CG_MediaHash( const char *name ) {
+	int		i, hash;
+
+	hash = 0;
+	for ( i = 0 ; name[i] ; i++ ) {
+		hash += tolower( name[i] ) * ( i + 119 );
+	}
+	return hash & ( MEDIA_HASH_SIZE - 1 );
+}
+
+static qhandle_t CG_RegisterMedia( const char *name, mediaType_t type ) {
+	qhandle_t	handle;
+
+	switch ( type ) {
+	case MEDIA_SHADER_NOMIP:
+		return trap_R_RegisterShaderNoMip( name );
+	case MEDIA_LEVELSHOT:
+		handle = trap_R_RegisterShaderNoMip( va( "levelshots/%s.tga", name ) );
+		if ( !handle ) {
+			handle = trap_R_RegisterShaderNoMip( "menu/art/unknownmap" );
+		}
+		return handle;
+	default:
+		return trap_R_RegisterShader( name );
+	}
+}
+
+static qhandle_t CG_CachedMedia( const char *name, mediaType_t type ) {
+	cachedMedia_t	*media;
+	int				hash;
+
+	if ( !name || !name[0] ) {
+		return 0;
+	}
+
+	hash = CG_MediaHash( name );
+	for ( media = cachedMediaHash[hash] ; media ; media = media->next ) {
+		if ( media->type == type && !Q_stricmp( media->name, name ) ) {
+			return media->handle;
+		}
+	}
+
+	if ( numCachedMedia >= MAX_CACHED_MEDIA || strlen( name ) >= MAX_QPATH ) {
+		return CG_RegisterMedia( name, type );
+	}
+
+	media = &cachedMedia[numCachedMedia++];
+	Q_strncpyz( media->name, name, sizeof( media->name ) );
+	media->type = type;
+	media->handle = CG_RegisterMedia( name, type );
+	media->next = cachedMediaHash[hash];
+	cachedMediaHash[hash] = media;
+
+	return media->handle;
+}
+
+/*
+=================
+CG_CachedShader
+=================
+*/
+qhandle_t CG_CachedShader( const char *name ) {
+	return CG_CachedMedia( name, MEDIA_SHADER );
+}
+
+/*
+=================
+CG_CachedShaderNoMip
+=================
+*/
+qhandle_t CG_CachedShaderNoMip( const char *name ) {
+	return CG_CachedMedia( name, MEDIA_SHADER_NOMIP );
+}
+
+/*
+=================
+CG_LevelshotShader
+
+Levelshot for a map name, falling back to the unknown map picture
+=================
+*/
+qhandle_t CG_LevelshotShader( const char *mapname ) {
+	return CG_CachedMedia( mapname, MEDIA_LEVELSHOT );
+}
+
+/*
+=================
+CG_ItemIcon
+
+Icon of any item, registered on first use if the item is not on the level
+=================
+*/
+qhandle_t CG_ItemIcon( const gitem_t *item ) {
+	itemInfo_t	*itemInfo;
+
+	itemInfo = &cg_items[ item - bg_itemlist ];
+	if ( !itemInfo->icon ) {
+		itemInfo->icon = trap_R_RegisterShader( item->icon );
+	}
+	return itemInfo->icon;
+}
+
+/*
+=================
+CG_ItemPickupSound
+
+Resolved through the sound options on first use, and again after
+CG_UpdateCvars sees one of them change
+=================
+*/
+sfxHandle_t CG_ItemPickupSound( const gitem_t *item ) {
+	itemInfo_t	*itemInfo;
+
+	itemInfo = &cg_items[ item - bg_itemlist ];
+	if ( !itemInfo->pickupSound && item->pickup_sound ) {
+		itemInfo->pickupSound = CG_RegisterSoundOption( item->pickup_sound, qfalse );
+	}
+	return itemInfo->pickupSound;
+}
+
 //========================================================================
 
 /*
@@ -1084,9 +1266,7 @@ static void CG_RegisterItemSounds( int itemNum ) {
 
 	item = &bg_itemlist[ itemNum ];
 
-	if( item->pickup_sound ) {
-		CG_RegisterSoundOption( item->pickup_sound, qfalse );
-	}
+	CG_ItemPickupSound( item );
 
 	// parse the space seperated precache string for other media
 	s = item->sounds;
@@ -1742,6 +1922,8 @@ static void CG_RegisterGraphics( void ) {
 		for ( j = 0 ; j < 3 ; j++ ) {
 			cgs.inlineModelMidpoints[i][j] = mins[j] + 0.5 * ( maxs[j] - mins[j] );
 		}
+		VectorCopy( mins, cgs.inlineModelMins[i] );
+		VectorCopy( maxs, cgs.inlineModelMaxs[i] );
 	}
 
 	// register all the server specified models
@@ -2083,6 +2265,12 @@ void CG_ParseMenu(const char *menuFile) {
 	pc_token_t token;
 	int handle;
 
+	// already loaded since the last Menu_Reset
+	if (Menu_FileParsed(menuFile)) {
+		return;
+	}
+	Menu_MarkFileParsed(menuFile);
+
 	handle = trap_PC_LoadSource(menuFile);
 	if (!handle)
 		handle = trap_PC_LoadSource("ui/testhud.menu");
@@ -2625,6 +2813,7 @@ void CG_Init( int serverMessageNum, int serverCommandSequence, int clientNum ) {
 	memset( cg_entities, 0, sizeof(cg_entities) );
 	memset( cg_weapons, 0, sizeof(cg_weapons) );
 	memset( cg_items, 0, sizeof(cg_items) );
+	CG_ClearClientModels();
 
 	cg.clientNum = clientNum;
 
@@ -2695,6 +2884,7 @@ void CG_Init( int serverMessageNum, int serverCommandSequence, int clientNum ) {
 
 	CG_LoadingString( "clients" );
 
+	CG_PreloadModelInfo();
 	CG_RegisterClients();		// if low on memory, some clients will be deferred
 
 #ifdef MISSIONPACK
@@ -523,7 +523,7 @@ static void CG_DrawSelectedPlayerPowerup( rectDef_t *rect, qboolean draw2D ) {
 				gitem_t	*item;
 				item = BG_FindItemForPowerup( j );
 				if (item) {
-				  CG_DrawPic( x, y, rect->w, rect->h, trap_R_RegisterShader( item->icon ) );
+				  CG_DrawPic( x, y, rect->w, rect->h, CG_ItemIcon( item ) );
 					x += 3;
 					y += 3;
           return;
@@ -898,7 +898,7 @@ static void CG_DrawAreaPowerUp(rectDef_t *rect, int align, float special, float
 				trap_R_SetColor( modulate );
 			}
 
-			CG_DrawPic( r2.x, r2.y, r2.w * .75, r2.h, trap_R_RegisterShader( item->icon ) );
+			CG_DrawPic( r2.x, r2.y, r2.w * .75, r2.h, CG_ItemIcon( item ) );
 
 			Com_sprintf (num, sizeof(num), "%i", sortedTime[i] / 1000);
 			CG_Text_Paint(r2.x + (r2.w * .75) + 3 , r2.y + r2.h, scale, color, num, 0, 0, 0);
@@ -1326,7 +1326,7 @@ void CG_DrawNewTeamInfo(rectDef_t *rect, float text_x, float text_y, float scale
 					item = BG_FindItemForPowerup( j );
 
 					if (item) {
-						CG_DrawPic( xx, y, PIC_WIDTH, PIC_WIDTH, trap_R_RegisterShader( item->icon ) );
+						CG_DrawPic( xx, y, PIC_WIDTH, PIC_WIDTH, CG_ItemIcon( item ) );
 						xx += PIC_WIDTH;
 					}
 				}
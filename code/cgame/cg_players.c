@@ -81,13 +81,13 @@ CLIENT INFO
 
 /*
 ======================
-CG_ParseAnimationFile
+CG_ReadAnimationFile
 
 Read a configuration file containing animation coutns and rates
 models/players/visor/animation.cfg, etc
 ======================
 */
-static qboolean	CG_ParseAnimationFile( const char *filename, clientInfo_t *ci ) {
+static qboolean	CG_ReadAnimationFile( const char *filename, clientInfo_t *ci ) {
 	char		*text_p, *prev;
 	int			len;
 	int			i;
@@ -290,19 +290,211 @@ static qboolean	CG_ParseAnimationFile( const char *filename, clientInfo_t *ci )
 	return qtrue;
 }
 
+/*
+=============================================================================
+
+MODEL INFO STORE
+
+animation.cfg contents and file probe results are kept for the whole
+level, so every clientinfo load after the first one for a model is
+served from memory instead of the filesystem.
+
+=============================================================================
+*/
+
+#define	MAX_MODEL_ANIMS			64
+#define	MAX_MODEL_PROBES		512
+#define	MODEL_INFO_HASH			256
+
+typedef struct modelAnims_s {
+	char				filename[MAX_QPATH];
+	qboolean			valid;			// qfalse if the file is missing or broken
+	footstep_t			footsteps;
+	gender_t			gender;
+	vec3_t				headOffset;
+	qboolean			fixedlegs;
+	qboolean			fixedtorso;
+	animation_t			animations[MAX_TOTALANIMATIONS];
+	struct modelAnims_s	*hashNext;
+} modelAnims_t;
+
+typedef struct modelProbe_s {
+	char				filename[MAX_QPATH];
+	qboolean			exists;
+	struct modelProbe_s	*hashNext;
+} modelProbe_t;
+
+static modelAnims_t		modelAnims[MAX_MODEL_ANIMS];
+static int				numModelAnims;
+static modelAnims_t		*modelAnimsHash[MODEL_INFO_HASH];
+
+static modelProbe_t		modelProbes[MAX_MODEL_PROBES];
+static int				numModelProbes;
+static modelProbe_t		*modelProbesHash[MODEL_INFO_HASH];
+
+/*
+======================
+CG_ModelInfoHash
+======================
+*/
+static int CG_ModelInfoHash( const char *filename ) {
+	int		hash;
+
+	hash = 0;
+	while ( *filename ) {
+		hash = hash * 31 + tolower( *filename );
+		filename++;
+	}
+	return hash & ( MODEL_INFO_HASH - 1 );
+}
+
+/*
+======================
+CG_ClearModelInfo
+======================
+*/
+static void CG_ClearModelInfo( void ) {
+	numModelAnims = 0;
+	memset( modelAnimsHash, 0, sizeof( modelAnimsHash ) );
+	numModelProbes = 0;
+	memset( modelProbesHash, 0, sizeof( modelProbesHash ) );
+}
+
+/*
+======================
+CG_ParseAnimationFile
+
+Copies the animations of filename into ci,
+reading the file only the first time it is asked for
+======================
+*/
+static qboolean	CG_ParseAnimationFile( const char *filename, clientInfo_t *ci ) {
+	static clientInfo_t	scratch;
+	modelAnims_t	*ma;
+	int				hash;
+
+	hash = CG_ModelInfoHash( filename );
+	for ( ma = modelAnimsHash[hash] ; ma ; ma = ma->hashNext ) {
+		if ( !Q_stricmp( ma->filename, filename ) ) {
+			break;
+		}
+	}
+
+	if ( !ma ) {
+		if ( numModelAnims == MAX_MODEL_ANIMS ) {
+			return CG_ReadAnimationFile( filename, ci );
+		}
+		ma = &modelAnims[numModelAnims++];
+		Q_strncpyz( ma->filename, filename, sizeof( ma->filename ) );
+		ma->hashNext = modelAnimsHash[hash];
+		modelAnimsHash[hash] = ma;
+
+		memset( &scratch, 0, sizeof( scratch ) );
+		ma->valid = CG_ReadAnimationFile( filename, &scratch );
+		ma->footsteps = scratch.footsteps;
+		ma->gender = scratch.gender;
+		VectorCopy( scratch.headOffset, ma->headOffset );
+		ma->fixedlegs = scratch.fixedlegs;
+		ma->fixedtorso = scratch.fixedtorso;
+		memcpy( ma->animations, scratch.animations, sizeof( ma->animations ) );
+	}
+
+	if ( !ma->valid ) {
+		return qfalse;
+	}
+
+	ci->footsteps = ma->footsteps;
+	ci->gender = ma->gender;
+	VectorCopy( ma->headOffset, ci->headOffset );
+	ci->fixedlegs = ma->fixedlegs;
+	ci->fixedtorso = ma->fixedtorso;
+	memcpy( ci->animations, ma->animations, sizeof( ci->animations ) );
+	return qtrue;
+}
+
 /*
 ==========================
 CG_FileExists
+
+Remembers the answer for each path, the client model
+lookups probe the same handful of names for every player
 ==========================
 */
 static qboolean	CG_FileExists(const char *filename) {
-	int len;
+	modelProbe_t	*probe;
+	int				hash;
 
-	len = trap_FS_FOpenFile( filename, NULL, FS_READ );
-	if (len>0) {
-		return qtrue;
+	hash = CG_ModelInfoHash( filename );
+	for ( probe = modelProbesHash[hash] ; probe ; probe = probe->hashNext ) {
+		if ( !Q_stricmp( probe->filename, filename ) ) {
+			return probe->exists;
+		}
+	}
+
+	if ( numModelProbes == MAX_MODEL_PROBES ) {
+		return ( trap_FS_FOpenFile( filename, NULL, FS_READ ) > 0 );
+	}
+
+	probe = &modelProbes[numModelProbes++];
+	Q_strncpyz( probe->filename, filename, sizeof( probe->filename ) );
+	probe->exists = ( trap_FS_FOpenFile( filename, NULL, FS_READ ) > 0 );
+	probe->hashNext = modelProbesHash[hash];
+	modelProbesHash[hash] = probe;
+
+	return probe->exists;
+}
+
+/*
+======================
+CG_PreloadModelInfo
+
+Reads the animation files of every model the current
+clients and the forced model cvars refer to, so the
+clientinfo loads that follow don't touch the disk for them
+======================
+*/
+void CG_PreloadModelInfo( void ) {
+	char		model[MAX_QPATH];
+	char		*slash;
+	const char	*configstring;
+	int			i;
+	static clientInfo_t	scratch;
+
+	for ( i = -4 ; i < MAX_CLIENTS ; i++ ) {
+		switch ( i ) {
+		case -4:
+			Q_strncpyz( model, cg_enemymodel.string, sizeof( model ) );
+			break;
+		case -3:
+			Q_strncpyz( model, cg_teammodel.string, sizeof( model ) );
+			break;
+		case -2:
+			Q_strncpyz( model, cg_redteammodel.string, sizeof( model ) );
+			break;
+		case -1:
+			Q_strncpyz( model, cg_blueteammodel.string, sizeof( model ) );
+			break;
+		default:
+			configstring = CG_ConfigString( CS_PLAYERS + i );
+			if ( !configstring[0] ) {
+				continue;
+			}
+			Q_strncpyz( model, Info_ValueForKey( configstring, "model" ), sizeof( model ) );
+			break;
+		}
+
+		slash = strchr( model, '/' );
+		if ( slash ) {
+			*slash = 0;
+		}
+		if ( !model[0] ) {
+			continue;
+		}
+
+		if ( !CG_ParseAnimationFile( va( "models/players/%s/animation.cfg", model ), &scratch ) ) {
+			CG_ParseAnimationFile( va( "models/players/characters/%s/animation.cfg", model ), &scratch );
+		}
 	}
-	return qfalse;
 }
 
 /*
@@ -915,98 +1107,283 @@ static void CG_ColorFromString( const char *v, vec3_t color ) {
 	color[2] = g_color_table[ColorIndex(*v)][2];
 }
 
+/*
+=============================================================================
+
+CLIENT MODEL CACHE
+
+Every distinct (model, skin, head, head skin, team) tuple in use is loaded
+once into a shared entry.  Entries that are not needed right away are
+loaded a step at a time by CG_UpdateClientModels within cg_playerLoadBudget
+milliseconds per frame, while the client shows a placeholder model.
+
+=============================================================================
+*/
+
+#define	MAX_CLIENT_MODELS		(MAX_CLIENTS*2)
+#define	CLIENT_MODEL_HASH		64
+
+typedef enum {
+	CMS_FREE,
+	CMS_BODY,			// models, skins and animations
+	CMS_SOUNDS,			// custom sounds, one per step
+	CMS_READY
+} clientModelState_t;
+
+typedef struct clientModel_s {
+	clientModelState_t		state;
+	char					key[MAX_QPATH*4 + MAX_TEAMNAME*2 + 16];
+	int						refCount;		// clientinfos currently using this entry
+	qboolean				modelloaded;	// qfalse if the default model was substituted
+	int						nextSound;
+	clientInfo_t			info;			// only the model fields are valid
+	struct clientModel_s	*hashNext;
+} clientModel_t;
+
+static clientModel_t	clientModels[MAX_CLIENT_MODELS];
+static clientModel_t	*clientModelHash[CLIENT_MODEL_HASH];
+
 /*
 ===================
-CG_LoadClientInfo
+CG_ClearClientModels
 
-Load it now, taking the disk hits.
-This will usually be deferred to a safe time
+Handles from a previous level are not valid anymore,
+and the pak files may have changed with the level
 ===================
 */
-static void CG_LoadClientInfo( int clientNum, clientInfo_t *ci ) {
-	const char	*dir, *fallback;
-	int			i, modelloaded;
-	const char	*s;
-	char		teamname[MAX_QPATH];
+void CG_ClearClientModels( void ) {
+	memset( clientModels, 0, sizeof( clientModels ) );
+	memset( clientModelHash, 0, sizeof( clientModelHash ) );
+	CG_ClearModelInfo();
+}
 
-	teamname[0] = 0;
-#ifdef MISSIONPACK
-	if( cgs.gametype >= GT_TEAM && cgs.ffa_gt!=1) {
-		if( ci->team == TEAM_BLUE ) {
-			Q_strncpyz(teamname, cg_blueTeamName.string, sizeof(teamname) );
-		} else {
-			Q_strncpyz(teamname, cg_redTeamName.string, sizeof(teamname) );
+/*
+===================
+CG_ClientModelHash
+===================
+*/
+static int CG_ClientModelHash( const char *key ) {
+	int		hash;
+
+	hash = 0;
+	while ( *key ) {
+		hash = hash * 31 + *key++;
+	}
+	return hash & ( CLIENT_MODEL_HASH - 1 );
+}
+
+/*
+===================
+CG_ClientModelKey
+
+Builds the interned name of everything that decides which
+files CG_LoadClientModelStep ends up registering
+===================
+*/
+static void CG_ClientModelKey( const clientInfo_t *ci, char *key, int size ) {
+	int		team;
+
+	team = ( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ) ? ci->team : 0;
+	Com_sprintf( key, size, "%s/%s/%s/%s/%s/%s/%i", ci->modelName, ci->skinName,
+		ci->headModelName, ci->headSkinName, ci->blueTeam, ci->redTeam, team );
+	Q_strlwr( key );
+}
+
+/*
+===================
+CG_UnlinkClientModel
+===================
+*/
+static void CG_UnlinkClientModel( clientModel_t *cm ) {
+	clientModel_t	**prev;
+
+	for ( prev = &clientModelHash[ CG_ClientModelHash( cm->key ) ] ; *prev ; prev = &(*prev)->hashNext ) {
+		if ( *prev == cm ) {
+			*prev = cm->hashNext;
+			break;
 		}
 	}
-	if( teamname[0] ) {
-		strcat( teamname, "/" );
+	cm->state = CMS_FREE;
+	cm->hashNext = NULL;
+}
+
+/*
+===================
+CG_ClientModelForInfo
+
+Finds or queues the shared entry for ci and takes a reference on it.
+Unreferenced entries stay cached until their slot is needed.
+===================
+*/
+static clientModel_t *CG_ClientModelForInfo( clientInfo_t *ci ) {
+	char			key[MAX_QPATH*4 + MAX_TEAMNAME*2 + 16];
+	int				hash, i;
+	clientModel_t	*cm, *slot;
+
+	CG_ClientModelKey( ci, key, sizeof( key ) );
+	hash = CG_ClientModelHash( key );
+
+	for ( cm = clientModelHash[hash] ; cm ; cm = cm->hashNext ) {
+		if ( !strcmp( cm->key, key ) ) {
+			cm->refCount++;
+			ci->clientModel = cm - clientModels + 1;
+			return cm;
+		}
 	}
-#endif
-	modelloaded = qtrue;
-	if ( !CG_RegisterClientModelname( ci, ci->modelName, ci->skinName, ci->headModelName, ci->headSkinName, teamname ) ) {
-		if ( cg_buildScript.integer ) {
-			CG_Error( "CG_RegisterClientModelname( %s, %s, %s, %s %s ) failed", ci->modelName, ci->skinName, ci->headModelName, ci->headSkinName, teamname );
+
+	// prefer a free slot, otherwise evict an unreferenced one
+	slot = NULL;
+	for ( i = 0, cm = clientModels ; i < MAX_CLIENT_MODELS ; i++, cm++ ) {
+		if ( cm->state == CMS_FREE ) {
+			slot = cm;
+			break;
+		}
+		if ( !cm->refCount && !slot ) {
+			slot = cm;
 		}
+	}
+	if ( !slot ) {
+		CG_Error( "CG_ClientModelForInfo: no free client models" );
+	}
+	if ( slot->state != CMS_FREE ) {
+		CG_UnlinkClientModel( slot );
+	}
+
+	memset( slot, 0, sizeof( *slot ) );
+	Q_strncpyz( slot->key, key, sizeof( slot->key ) );
+	Q_strncpyz( slot->info.modelName, ci->modelName, sizeof( slot->info.modelName ) );
+	Q_strncpyz( slot->info.skinName, ci->skinName, sizeof( slot->info.skinName ) );
+	Q_strncpyz( slot->info.headModelName, ci->headModelName, sizeof( slot->info.headModelName ) );
+	Q_strncpyz( slot->info.headSkinName, ci->headSkinName, sizeof( slot->info.headSkinName ) );
+	Q_strncpyz( slot->info.blueTeam, ci->blueTeam, sizeof( slot->info.blueTeam ) );
+	Q_strncpyz( slot->info.redTeam, ci->redTeam, sizeof( slot->info.redTeam ) );
+	slot->info.team = ci->team;
+	slot->state = CMS_BODY;
+	slot->refCount = 1;
+	slot->hashNext = clientModelHash[hash];
+	clientModelHash[hash] = slot;
+
+	ci->clientModel = slot - clientModels + 1;
+	return slot;
+}
 
-		// fall back to default team name
+/*
+===================
+CG_ReleaseClientModel
+===================
+*/
+static void CG_ReleaseClientModel( clientInfo_t *ci ) {
+	clientModel_t	*cm;
+
+	if ( ci->clientModel <= 0 || ci->clientModel > MAX_CLIENT_MODELS ) {
+		return;
+	}
+	cm = &clientModels[ ci->clientModel - 1 ];
+	if ( cm->refCount > 0 ) {
+		cm->refCount--;
+	}
+	ci->clientModel = 0;
+}
+
+/*
+===================
+CG_LoadClientModelStep
+
+Performs the next stage of loading a client model, taking the disk hits.
+Returns qtrue once the entry is ready to be copied.
+===================
+*/
+static qboolean CG_LoadClientModelStep( clientModel_t *cm ) {
+	clientInfo_t	*ci;
+	const char		*s, *fallback;
+	char			teamname[MAX_QPATH];
+
+	ci = &cm->info;
+
+	switch ( cm->state ) {
+	case CMS_BODY:
+		teamname[0] = 0;
+#ifdef MISSIONPACK
 		if( cgs.gametype >= GT_TEAM && cgs.ffa_gt!=1) {
-			// keep skin name
 			if( ci->team == TEAM_BLUE ) {
-				Q_strncpyz(teamname, DEFAULT_BLUETEAM_NAME, sizeof(teamname) );
+				Q_strncpyz(teamname, cg_blueTeamName.string, sizeof(teamname) );
 			} else {
-				Q_strncpyz(teamname, DEFAULT_REDTEAM_NAME, sizeof(teamname) );
+				Q_strncpyz(teamname, cg_redTeamName.string, sizeof(teamname) );
 			}
-			if ( !CG_RegisterClientModelname( ci, DEFAULT_TEAM_MODEL, ci->skinName, DEFAULT_TEAM_HEAD, ci->skinName, teamname ) ) {
-				CG_Error( "DEFAULT_TEAM_MODEL / skin (%s/%s) failed to register", DEFAULT_TEAM_MODEL, ci->skinName );
+		}
+		if( teamname[0] ) {
+			strcat( teamname, "/" );
+		}
+#endif
+		cm->modelloaded = qtrue;
+		if ( !CG_RegisterClientModelname( ci, ci->modelName, ci->skinName, ci->headModelName, ci->headSkinName, teamname ) ) {
+			if ( cg_buildScript.integer ) {
+				CG_Error( "CG_RegisterClientModelname( %s, %s, %s, %s %s ) failed", ci->modelName, ci->skinName, ci->headModelName, ci->headSkinName, teamname );
 			}
-		} else {
-			if ( !CG_RegisterClientModelname( ci, DEFAULT_MODEL, "default", DEFAULT_MODEL, "default", teamname ) ) {
-				CG_Error( "DEFAULT_MODEL (%s) failed to register", DEFAULT_MODEL );
+
+			// fall back to default team name
+			if( cgs.gametype >= GT_TEAM && cgs.ffa_gt!=1) {
+				// keep skin name
+				if( ci->team == TEAM_BLUE ) {
+					Q_strncpyz(teamname, DEFAULT_BLUETEAM_NAME, sizeof(teamname) );
+				} else {
+					Q_strncpyz(teamname, DEFAULT_REDTEAM_NAME, sizeof(teamname) );
+				}
+				if ( !CG_RegisterClientModelname( ci, DEFAULT_TEAM_MODEL, ci->skinName, DEFAULT_TEAM_HEAD, ci->skinName, teamname ) ) {
+					CG_Error( "DEFAULT_TEAM_MODEL / skin (%s/%s) failed to register", DEFAULT_TEAM_MODEL, ci->skinName );
+				}
+			} else {
+				if ( !CG_RegisterClientModelname( ci, DEFAULT_MODEL, "default", DEFAULT_MODEL, "default", teamname ) ) {
+					CG_Error( "DEFAULT_MODEL (%s) failed to register", DEFAULT_MODEL );
+				}
 			}
+			cm->modelloaded = qfalse;
 		}
-		modelloaded = qfalse;
-	}
 
-	ci->newAnims = qfalse;
-	if ( ci->torsoModel ) {
-		orientation_t tag;
-		// if the torso model has the "tag_flag"
-		if ( trap_R_LerpTag( &tag, ci->torsoModel, 0, 0, 1, "tag_flag" ) ) {
-			ci->newAnims = qtrue;
+		ci->newAnims = qfalse;
+		if ( ci->torsoModel ) {
+			orientation_t tag;
+			// if the torso model has the "tag_flag"
+			if ( trap_R_LerpTag( &tag, ci->torsoModel, 0, 0, 1, "tag_flag" ) ) {
+				ci->newAnims = qtrue;
+			}
 		}
-	}
 
-	// sounds
-	dir = ci->modelName;
-	fallback = (cgs.gametype >= GT_TEAM && cgs.ffa_gt!=1) ? DEFAULT_TEAM_MODEL : DEFAULT_MODEL;
+		cm->nextSound = 0;
+		cm->state = CMS_SOUNDS;
+		return qfalse;
 
-	for ( i = 0 ; i < MAX_CUSTOM_SOUNDS ; i++ ) {
-		s = cg_customSoundNames[i];
+	case CMS_SOUNDS:
+		s = NULL;
+		if ( cm->nextSound < MAX_CUSTOM_SOUNDS ) {
+			s = cg_customSoundNames[cm->nextSound];
+		}
 		if ( !s ) {
-			break;
+			cm->state = CMS_READY;
+			return qtrue;
 		}
-		ci->sounds[i] = 0;
+
+		fallback = (cgs.gametype >= GT_TEAM && cgs.ffa_gt!=1) ? DEFAULT_TEAM_MODEL : DEFAULT_MODEL;
+
+		ci->sounds[cm->nextSound] = 0;
 		// if the model didn't load use the sounds of the default model
-		if (modelloaded) {
-			ci->sounds[i] = CG_RegisterSoundOption( va("sound/player/%s/%s", dir, s + 1), qfalse );
+		if ( cm->modelloaded ) {
+			ci->sounds[cm->nextSound] = CG_RegisterSoundOption( va("sound/player/%s/%s", ci->modelName, s + 1), qfalse );
 			//TODO: enemysound teamsound
 		}
-		if ( !ci->sounds[i] ) {
-			ci->sounds[i] = CG_RegisterSoundOption( va("sound/player/%s/%s", fallback, s + 1), qfalse );
+		if ( !ci->sounds[cm->nextSound] ) {
+			ci->sounds[cm->nextSound] = CG_RegisterSoundOption( va("sound/player/%s/%s", fallback, s + 1), qfalse );
 		}
-	}
+		cm->nextSound++;
+		return qfalse;
 
-	ci->deferred = qfalse;
+	case CMS_READY:
+		return qtrue;
 
-	// reset any existing players and bodies, because they might be in bad
-	// frames for this new model
-	for ( i = 0 ; i < MAX_GENTITIES ; i++ ) {
-		if ( cg_entities[i].currentState.clientNum == clientNum
-			&& cg_entities[i].currentState.eType == ET_PLAYER ) {
-			CG_ResetPlayerEntity( &cg_entities[i] );
-		}
+	default:
+		CG_Error( "CG_LoadClientModelStep: bad state %i", cm->state );
+		return qtrue;
 	}
-	
 }
 
 /*
@@ -1018,6 +1395,8 @@ static void CG_CopyClientInfoModel( clientInfo_t *from, clientInfo_t *to ) {
 	VectorCopy( from->headOffset, to->headOffset );
 	to->footsteps = from->footsteps;
 	to->gender = from->gender;
+	to->fixedlegs = from->fixedlegs;
+	to->fixedtorso = from->fixedtorso;
 
 	to->legsModel = from->legsModel;
 	to->legsSkin = from->legsSkin;
@@ -1034,41 +1413,98 @@ static void CG_CopyClientInfoModel( clientInfo_t *from, clientInfo_t *to ) {
 }
 
 /*
-======================
-CG_ScanForExistingClientInfo
-======================
+===================
+CG_ResetClientEntities
+
+Reset any existing players and bodies, because they might
+be in bad frames for a new model
+===================
 */
-static qboolean CG_ScanForExistingClientInfo( clientInfo_t *ci ) {
+static void CG_ResetClientEntities( int clientNum ) {
 	int		i;
-	clientInfo_t	*match;
 
-	for ( i = 0 ; i < cgs.maxclients ; i++ ) {
-		match = &cgs.clientinfo[ i ];
-		if ( !match->infoValid ) {
-			continue;
+	for ( i = 0 ; i < MAX_GENTITIES ; i++ ) {
+		if ( cg_entities[i].currentState.clientNum == clientNum
+			&& cg_entities[i].currentState.eType == ET_PLAYER ) {
+			CG_ResetPlayerEntity( &cg_entities[i] );
 		}
-		if ( match->deferred ) {
+	}
+}
+
+/*
+===================
+CG_LoadClientInfo
+
+Load it now, taking the disk hits.
+This will usually be deferred to a safe time
+===================
+*/
+static void CG_LoadClientInfo( int clientNum, clientInfo_t *ci ) {
+	clientModel_t	*cm;
+
+	if ( ci->clientModel > 0 && ci->clientModel <= MAX_CLIENT_MODELS ) {
+		cm = &clientModels[ ci->clientModel - 1 ];
+	} else {
+		cm = CG_ClientModelForInfo( ci );
+	}
+
+	while ( !CG_LoadClientModelStep( cm ) ) {
+	}
+
+	CG_CopyClientInfoModel( &cm->info, ci );
+	ci->deferred = qfalse;
+
+	CG_ResetClientEntities( clientNum );
+}
+
+/*
+===================
+CG_UpdateClientModels
+
+Called every frame to load queued client models within
+cg_playerLoadBudget milliseconds, always making at least one
+step of progress.  Clients waiting on a model that finishes are
+switched over from their placeholder.
+===================
+*/
+void CG_UpdateClientModels( void ) {
+	int				i, j, start, index;
+	clientModel_t	*cm;
+	clientInfo_t	*ci;
+
+	if ( cg_playerLoadBudget.integer <= 0 ) {
+		return;
+	}
+	// if we are low on memory, leave the placeholders
+	if ( trap_MemoryRemaining() < 4000000 ) {
+		return;
+	}
+
+	start = trap_Milliseconds();
+	for ( i = 0, cm = clientModels ; i < MAX_CLIENT_MODELS ; i++, cm++ ) {
+		if ( cm->state == CMS_FREE || cm->state == CMS_READY || !cm->refCount ) {
 			continue;
 		}
-		if ( !Q_stricmp( ci->modelName, match->modelName )
-			&& !Q_stricmp( ci->skinName, match->skinName )
-			&& !Q_stricmp( ci->headModelName, match->headModelName )
-			&& !Q_stricmp( ci->headSkinName, match->headSkinName ) 
-			&& !Q_stricmp( ci->blueTeam, match->blueTeam ) 
-			&& !Q_stricmp( ci->redTeam, match->redTeam )
-			&& (cgs.gametype < GT_TEAM || cgs.ffa_gt==1 || ci->team == match->team) ) {
-			// this clientinfo is identical, so use it's handles
 
-			ci->deferred = qfalse;
+		while ( !CG_LoadClientModelStep( cm ) ) {
+			if ( trap_Milliseconds() - start >= cg_playerLoadBudget.integer ) {
+				return;
+			}
+		}
 
-			CG_CopyClientInfoModel( match, ci );
+		index = i + 1;
+		for ( j = 0, ci = cgs.clientinfo ; j < cgs.maxclients ; j++, ci++ ) {
+			if ( ci->infoValid && ci->deferred && ci->clientModel == index ) {
+				CG_CopyClientInfoModel( &cm->info, ci );
+				ci->deferred = qfalse;
+				CG_ResetClientEntities( j );
+			}
+		}
 
-			return qtrue;
+		if ( trap_Milliseconds() - start >= cg_playerLoadBudget.integer ) {
+			return;
 		}
 	}
-
-	// nothing matches, so defer the load
-	return qfalse;
 }
 
 /*
@@ -1157,11 +1593,13 @@ void CG_NewClientInfo( int clientNum ) {
 	char		*slash;
 	int local_team, enemy;
   	const char *local_config;
+	clientModel_t	*cm;
 
 	ci = &cgs.clientinfo[clientNum];
 
 	configstring = CG_ConfigString( clientNum + CS_PLAYERS );
 	if ( !configstring[0] ) {
+		CG_ReleaseClientModel( ci );
 		memset( ci, 0, sizeof( *ci ) );
 		return;		// player just left
 	}
@@ -1501,15 +1939,20 @@ void CG_NewClientInfo( int clientNum ) {
 		}
 	}
 
-	// scan for an existing clientinfo that matches this modelname
-	// so we can avoid loading checks if possible
-	if ( !CG_ScanForExistingClientInfo( &newInfo ) ) {
+	// share the models of any clientinfo with the same models and skins,
+	// so only a tuple nobody uses yet has to be loaded
+	cm = CG_ClientModelForInfo( &newInfo );
+	if ( cm->state == CMS_READY ) {
+		CG_CopyClientInfoModel( &cm->info, &newInfo );
+	} else {
 		qboolean	forceDefer;
 
 		forceDefer = ( trap_MemoryRemaining() < 4000000 );
 
 		// if we are defering loads, just have it pick the first valid
-		if ( forceDefer || (cg_deferPlayers.integer && !cg_buildScript.integer && !cg.loading ) ) {
+		// and let CG_UpdateClientModels load the real one over time
+		if ( forceDefer || ( ( cg_deferPlayers.integer || cg_playerLoadBudget.integer > 0 )
+			&& !cg_buildScript.integer && !cg.loading ) ) {
 			// keep whatever they had if it won't violate team skins
 			CG_SetDeferredClientInfo( clientNum, &newInfo );
 			// if we are low on memory, leave them with this model
@@ -1521,6 +1964,7 @@ void CG_NewClientInfo( int clientNum ) {
 			CG_LoadClientInfo( clientNum, &newInfo );
 		}
 	}
+	CG_ReleaseClientModel( ci );
 
 	// replace whatever was there with the new one
 	newInfo.infoValid = qtrue;
@@ -2832,6 +3276,49 @@ void CG_setRGBA( byte *incolor, char *instring ){
 	}
 }
 
+typedef struct {
+	vmCvar_t	*vmCvar;
+	int		modificationCount;
+} cvarColorSource_t;
+
+static cvarColorSource_t cvarColorSources[CC_MAX] = {
+	{ &cg_enemyWeaponColor },
+	{ &cg_teamWeaponColor },
+	{ &cg_deadBodyColor },
+	{ &cg_enemyHeadColor },
+	{ &cg_enemyTorsoColor },
+	{ &cg_enemyLegsColor },
+	{ &cg_teamHeadColor },
+	{ &cg_teamTorsoColor },
+	{ &cg_teamLegsColor },
+	{ &cg_redHeadColor },
+	{ &cg_redTorsoColor },
+	{ &cg_redLegsColor },
+	{ &cg_blueHeadColor },
+	{ &cg_blueTorsoColor },
+	{ &cg_blueLegsColor }
+};
+
+/*
+===============
+CG_UpdateCvarColors
+
+Parses the colour cvars into cgs.cvarColors so the per-frame
+weapon and player code only has to copy four bytes
+===============
+*/
+void CG_UpdateCvarColors( qboolean force ){
+	int i;
+	cvarColorSource_t *src;
+
+	for( i = 0, src = cvarColorSources; i < CC_MAX; i++, src++ ){
+		if( !force && src->modificationCount == src->vmCvar->modificationCount )
+			continue;
+		src->modificationCount = src->vmCvar->modificationCount;
+		CG_setRGBA( cgs.cvarColors[i], src->vmCvar->string );
+	}
+}
+
 /*
 ===============
 CG_setColor
@@ -2844,39 +3331,39 @@ void CG_setColor(clientInfo_t * ci, refEntity_t * head, refEntity_t * torso,
   	localPlayer = &cgs.clientinfo[cg.clientNum];
 
 	if( ( state & EF_DEAD )  && cg_deadBodyDarken.integer ){
-		CG_setRGBA(legs->shaderRGBA, cg_deadBodyColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_deadBodyColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_deadBodyColor.string);
+		Vector4Copy(cgs.cvarColors[CC_DEAD_BODY], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_DEAD_BODY], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_DEAD_BODY], head->shaderRGBA);
 		return;
 	}
 	else if( localPlayer->team == TEAM_FREE || ( localPlayer->team != ci->team && !cg_forceteammodels.integer && localPlayer->team != TEAM_SPECTATOR ) ){
-		CG_setRGBA(legs->shaderRGBA, cg_enemyLegsColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_enemyTorsoColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_enemyHeadColor.string);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_LEGS], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_TORSO], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_HEAD], head->shaderRGBA);
 		return;
 	}
 	else if( ( ci->team == TEAM_BLUE && cg_forceteammodels.integer ) || ( ci->team == TEAM_BLUE && localPlayer->team == TEAM_SPECTATOR ) ){
-		CG_setRGBA(legs->shaderRGBA, cg_blueLegsColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_blueTorsoColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_blueHeadColor.string);
+		Vector4Copy(cgs.cvarColors[CC_BLUE_LEGS], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_BLUE_TORSO], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_BLUE_HEAD], head->shaderRGBA);
 		return;
 	}
 	else if( ( ci->team == TEAM_RED &&  cg_forceteammodels.integer ) || ( ci->team == TEAM_RED && localPlayer->team == TEAM_SPECTATOR ) ){
-		CG_setRGBA(legs->shaderRGBA, cg_redLegsColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_redTorsoColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_redHeadColor.string);
+		Vector4Copy(cgs.cvarColors[CC_RED_LEGS], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_RED_TORSO], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_RED_HEAD], head->shaderRGBA);
 		return;
 	}
 	else if( localPlayer->team != TEAM_FREE && ( localPlayer->team == ci->team && !cg_forceteammodels.integer ) ){
-		CG_setRGBA(legs->shaderRGBA, cg_teamLegsColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_teamTorsoColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_teamHeadColor.string);
+		Vector4Copy(cgs.cvarColors[CC_TEAM_LEGS], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_TEAM_TORSO], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_TEAM_HEAD], head->shaderRGBA);
 		return;
 	}
 	else{
-		CG_setRGBA(legs->shaderRGBA, cg_enemyLegsColor.string);
-		CG_setRGBA(torso->shaderRGBA, cg_enemyTorsoColor.string);
-		CG_setRGBA(head->shaderRGBA, cg_enemyHeadColor.string);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_LEGS], legs->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_TORSO], torso->shaderRGBA);
+		Vector4Copy(cgs.cvarColors[CC_ENEMY_HEAD], head->shaderRGBA);
 		return;
 	}
 }
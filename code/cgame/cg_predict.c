@@ -34,6 +34,21 @@ static	centity_t	*cg_solidEntities[MAX_ENTITIES_IN_SNAPSHOT];
 static	int			cg_numTriggerEntities;
 static	centity_t	*cg_triggerEntities[MAX_ENTITIES_IN_SNAPSHOT];
 
+// clip setup of cg_solidEntities, valid while a prediction pass runs
+typedef struct {
+	int				number;
+	clipHandle_t	cmodel;			// 0 for encoded bboxes
+	vec3_t			bmins, bmaxs;
+	vec3_t			origin, angles;
+	vec3_t			absmin, absmax;
+	qboolean		bounded;		// qfalse if absmin/absmax are unknown
+} clipEntity_t;
+
+static	clipEntity_t	cg_clipEntities[MAX_ENTITIES_IN_SNAPSHOT];
+static	qboolean		cg_clipPassActive;
+static	int				cg_clipTested;
+static	int				cg_clipTraced;
+
 /*
 ====================
 CG_BuildSolidList
@@ -76,6 +91,97 @@ void CG_BuildSolidList( void ) {
 	}
 }
 
+/*
+====================
+CG_SetupClipEntity
+
+Resolves the clip model, position and world bounds a solid
+entity is traced against
+====================
+*/
+static void CG_SetupClipEntity( centity_t *cent, clipEntity_t *clip ) {
+	entityState_t	*ent;
+	int			x, zd, zu;
+	float		radius;
+	int			i;
+
+	ent = &cent->currentState;
+	clip->number = ent->number;
+
+	if ( ent->solid == SOLID_BMODEL ) {
+		// special value for bmodel
+		clip->cmodel = trap_CM_InlineModel( ent->modelindex );
+		VectorCopy( cent->lerpAngles, clip->angles );
+		BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, clip->origin );
+		VectorCopy( cgs.inlineModelMins[ent->modelindex], clip->bmins );
+		VectorCopy( cgs.inlineModelMaxs[ent->modelindex], clip->bmaxs );
+
+		// an unknown model gets no broad phase rejection
+		if ( clip->bmins[0] >= clip->bmaxs[0] ) {
+			clip->bounded = qfalse;
+			return;
+		}
+
+		if ( clip->angles[0] || clip->angles[1] || clip->angles[2] ) {
+			radius = RadiusFromBounds( clip->bmins, clip->bmaxs );
+			for ( i = 0 ; i < 3 ; i++ ) {
+				clip->absmin[i] = clip->origin[i] - radius;
+				clip->absmax[i] = clip->origin[i] + radius;
+			}
+		} else {
+			VectorAdd( clip->origin, clip->bmins, clip->absmin );
+			VectorAdd( clip->origin, clip->bmaxs, clip->absmax );
+		}
+	} else {
+		// encoded bbox, the temp box model is shared by every
+		// entity so it is only built right before the trace
+		x = (ent->solid & 255);
+		zd = ((ent->solid>>8) & 255);
+		zu = ((ent->solid>>16) & 255) - 32;
+
+		clip->bmins[0] = clip->bmins[1] = -x;
+		clip->bmaxs[0] = clip->bmaxs[1] = x;
+		clip->bmins[2] = -zd;
+		clip->bmaxs[2] = zu;
+
+		clip->cmodel = 0;
+		VectorCopy( vec3_origin, clip->angles );
+		VectorCopy( cent->lerpOrigin, clip->origin );
+		VectorAdd( clip->origin, clip->bmins, clip->absmin );
+		VectorAdd( clip->origin, clip->bmaxs, clip->absmax );
+	}
+	clip->bounded = qtrue;
+}
+
+/*
+====================
+CG_BeginClipPass
+
+Caches the clip setup of every solid entity while the
+prediction pass replays commands, since nothing it traces
+against moves until the pass is over
+====================
+*/
+static void CG_BeginClipPass( void ) {
+	int		i;
+
+	for ( i = 0 ; i < cg_numSolidEntities ; i++ ) {
+		CG_SetupClipEntity( cg_solidEntities[i], &cg_clipEntities[i] );
+	}
+	cg_clipPassActive = qtrue;
+	cg_clipTested = 0;
+	cg_clipTraced = 0;
+}
+
+/*
+====================
+CG_EndClipPass
+====================
+*/
+static void CG_EndClipPass( void ) {
+	cg_clipPassActive = qfalse;
+}
+
 /*
 ====================
 CG_ClipMoveToEntities
@@ -84,49 +190,62 @@ CG_ClipMoveToEntities
 */
 static void CG_ClipMoveToEntities ( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
 							int skipNumber, int mask, trace_t *tr ) {
-	int			i, x, zd, zu;
+	int			i, j;
 	trace_t		trace;
-	entityState_t	*ent;
 	clipHandle_t 	cmodel;
-	vec3_t		bmins, bmaxs;
-	vec3_t		origin, angles;
-	centity_t	*cent;
+	vec3_t		movemins, movemaxs;
+	clipEntity_t	local, *clip;
+
+	// bounds of the whole move, for rejecting entities it can't touch
+	for ( j = 0 ; j < 3 ; j++ ) {
+		if ( end[j] > start[j] ) {
+			movemins[j] = start[j] + mins[j] - 1;
+			movemaxs[j] = end[j] + maxs[j] + 1;
+		} else {
+			movemins[j] = end[j] + mins[j] - 1;
+			movemaxs[j] = start[j] + maxs[j] + 1;
+		}
+	}
 
 	for ( i = 0 ; i < cg_numSolidEntities ; i++ ) {
-		cent = cg_solidEntities[ i ];
-		ent = &cent->currentState;
+		if ( cg_clipPassActive ) {
+			clip = &cg_clipEntities[ i ];
+			cg_clipTested++;
+		} else {
+			if ( cg_solidEntities[ i ]->currentState.number == skipNumber ) {
+				continue;
+			}
+			clip = &local;
+			CG_SetupClipEntity( cg_solidEntities[ i ], clip );
+		}
 
-		if ( ent->number == skipNumber ) {
+		if ( clip->number == skipNumber ) {
 			continue;
 		}
 
-		if ( ent->solid == SOLID_BMODEL ) {
-			// special value for bmodel
-			cmodel = trap_CM_InlineModel( ent->modelindex );
-			VectorCopy( cent->lerpAngles, angles );
-			BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, origin );
-		} else {
-			// encoded bbox
-			x = (ent->solid & 255);
-			zd = ((ent->solid>>8) & 255);
-			zu = ((ent->solid>>16) & 255) - 32;
-
-			bmins[0] = bmins[1] = -x;
-			bmaxs[0] = bmaxs[1] = x;
-			bmins[2] = -zd;
-			bmaxs[2] = zu;
+		if ( clip->bounded ) {
+			if ( clip->absmin[0] > movemaxs[0] || clip->absmax[0] < movemins[0]
+				|| clip->absmin[1] > movemaxs[1] || clip->absmax[1] < movemins[1]
+				|| clip->absmin[2] > movemaxs[2] || clip->absmax[2] < movemins[2] ) {
+				continue;
+			}
+		}
 
-			cmodel = trap_CM_TempBoxModel( bmins, bmaxs );
-			VectorCopy( vec3_origin, angles );
-			VectorCopy( cent->lerpOrigin, origin );
+		if ( clip->cmodel ) {
+			cmodel = clip->cmodel;
+		} else {
+			cmodel = trap_CM_TempBoxModel( clip->bmins, clip->bmaxs );
 		}
 
+		if ( cg_clipPassActive ) {
+			cg_clipTraced++;
+		}
 
 		trap_CM_TransformedBoxTrace ( &trace, start, end,
-			mins, maxs, cmodel,  mask, origin, angles);
+			mins, maxs, cmodel,  mask, clip->origin, clip->angles);
 
 		if (trace.allsolid || trace.fraction < tr->fraction) {
-			trace.entityNum = ent->number;
+			trace.entityNum = clip->number;
 			*tr = trace;
 		} else if (trace.startsolid) {
 			tr->startsolid = qtrue;
@@ -765,6 +884,7 @@ void CG_PredictPlayerState( void ) {
 
 	// run cmds
 	moved = qfalse;
+	CG_BeginClipPass();
 	for ( cmdNum = current - CMD_BACKUP + 1 ; cmdNum <= current ; cmdNum++ ) {
 		// get the command
 		trap_GetUserCmd( cmdNum, &cg_pmove.cmd );
@@ -898,6 +1018,7 @@ void CG_PredictPlayerState( void ) {
 		// check for predictable events that changed from previous predictions
 		//CG_CheckChangedPredictableEvents(&cg.predictedPlayerState);
 	}
+	CG_EndClipPass();
 
 //unlagged - optimized prediction
 	// do a /condump after a few seconds of this
@@ -910,6 +1031,7 @@ void CG_PredictPlayerState( void ) {
 
 	if ( cg_showmiss.integer > 1 ) {
 		CG_Printf( "[%i : %i] ", cg_pmove.cmd.serverTime, cg.time );
+		CG_Printf( "(clip %i/%i) ", cg_clipTraced, cg_clipTested );
 	}
 
 	if ( !moved ) {
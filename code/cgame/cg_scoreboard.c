@@ -502,10 +502,7 @@ static void CG_DrawMapInfo( void ){
     {
         info = CG_ConfigString( CS_SERVERINFO );
         s = Info_ValueForKey( info, "mapname" );
-        levelshot = trap_R_RegisterShaderNoMip( va( "levelshots/%s.tga", s ) );
-        if ( !levelshot ) {
-                levelshot = trap_R_RegisterShaderNoMip( "menu/art/unknownmap" );
-        }
+        levelshot = CG_LevelshotShader( s );
         trap_R_SetColor( NULL );
         CG_DrawPic( 0, 0, 100, 100 , levelshot );
     }
@@ -34,6 +34,113 @@ typedef struct {
 
 char	gameString[128];
 
+/*
+=================
+Server command argument view
+
+Every field of a server command used to be fetched with its own CG_Argv
+syscall (almost 800 of them for a full duel scoreboard). The command is
+now pulled across the VM boundary once per command and split in place,
+so the parsers only index into an argv array.
+
+trap_Args joins the arguments with single spaces and drops the quoting,
+so the split is only trusted when it yields exactly trap_Argc() - 1
+tokens, i.e. no argument contained a space. Otherwise every argument is
+copied out one at a time, once.
+=================
+*/
+typedef struct {
+    int			argc;
+    const char	*argv[MAX_STRING_TOKENS];
+    char		buffer[BIG_INFO_STRING];
+} serverArgs_t;
+
+static serverArgs_t	serverArgs;
+
+static void CG_TokenizeServerArgs ( void ) {
+    int		i, len, used, count;
+    char	*s, *args;
+
+    serverArgs.argc = trap_Argc();
+    if ( serverArgs.argc > MAX_STRING_TOKENS ) {
+        serverArgs.argc = MAX_STRING_TOKENS;
+    }
+
+    trap_Argv ( 0, serverArgs.buffer, MAX_STRING_CHARS );
+    serverArgs.argv[0] = serverArgs.buffer;
+    used = strlen ( serverArgs.buffer ) + 1;
+
+    if ( serverArgs.argc <= 1 ) {
+        return;
+    }
+
+    // fast path: one syscall for the whole argument string
+    args = serverArgs.buffer + used;
+    trap_Args ( args, MAX_STRING_CHARS );
+    len = strlen ( args );
+
+    if ( len < MAX_STRING_CHARS - 1 ) {
+        count = 1;
+        serverArgs.argv[count++] = args;
+        for ( s = args ; *s ; s++ ) {
+            if ( *s != ' ' ) {
+                continue;
+            }
+            *s = '\0';
+            if ( count >= serverArgs.argc ) {
+                count++;
+                break;
+            }
+            serverArgs.argv[count++] = s + 1;
+        }
+        if ( count == serverArgs.argc ) {
+            return;
+        }
+    }
+
+    // slow path: an argument contained spaces or the string was truncated
+    for ( i = 1 ; i < serverArgs.argc ; i++ ) {
+        if ( used >= sizeof ( serverArgs.buffer ) - 1 ) {
+            serverArgs.argv[i] = "";
+            continue;
+        }
+        len = sizeof ( serverArgs.buffer ) - used;
+        if ( len > MAX_STRING_CHARS ) {
+            len = MAX_STRING_CHARS;
+        }
+        trap_Argv ( i, serverArgs.buffer + used, len );
+        serverArgs.argv[i] = serverArgs.buffer + used;
+        used += strlen ( serverArgs.buffer + used ) + 1;
+    }
+}
+
+/*
+=================
+CG_ServerArgv
+
+Argument of the server command currently being executed. Out of range
+arguments are empty strings, matching trap_Argv.
+=================
+*/
+const char *CG_ServerArgv ( int arg ) {
+    if ( arg < 0 || arg >= serverArgs.argc ) {
+        return "";
+    }
+    return serverArgs.argv[arg];
+}
+
+int CG_ServerArgc ( void ) {
+    return serverArgs.argc;
+}
+
+int CG_ServerArgInt ( int arg ) {
+    return atoi ( CG_ServerArgv ( arg ) );
+}
+
+float CG_ServerArgFloat ( int arg ) {
+    return atof ( CG_ServerArgv ( arg ) );
+}
+
 
 void CG_SetGameString ( void ) {
     qtime_t	now;
@@ -197,7 +304,7 @@ static void CG_ParseScores ( void ) {
 	// as well as the start of the scores in the data.
 	// This way the scores can be transferred in several packets
 	// if the score data gets too big.
-	num_and_start = atoi(CG_Argv(1));
+	num_and_start = CG_ServerArgInt(1);
 	start = (num_and_start >> 8) & 0xFF;
 	num_scores = num_and_start & 0xFF;
 	last_data = num_and_start & (1 << 16);
@@ -214,98 +321,98 @@ static void CG_ParseScores ( void ) {
 		num_in_packet = i - start;
         if ( cgs.gametype == GT_TOURNAMENT ) {
             //
-            scores[i].client = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 1 ) );
-            scores[i].score = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 2 ) );
-            scores[i].ping = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 3 ) );
-            scores[i].time = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 4 ) );
-            scores[i].scoreFlags = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 5 ) );
-            scores[i].powerUps = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 6 ) );
-            scores[i].accuracy = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 7 ) );
-            scores[i].impressiveCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 8 ) );
-            scores[i].excellentCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 9 ) );
-            scores[i].guantletCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 10 ) );
-            scores[i].defendCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 11 ) );
-            scores[i].assistCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 12 ) );
-            scores[i].perfect = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 13 ) );
-            scores[i].captures = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 14 ) );
-            scores[i].isDead = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 15 ) );
-            scores[i].dmgdone = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 16 ) );
-            scores[i].dmgtaken = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 17 ) );
-            scores[i].specOnly = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 18 ) );
-            scores[i].deathCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 19 ) );
-            scores[i].frags = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 20 ) );
-            scores[i].airrocketCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 21 ) );
-            scores[i].airgrenadeCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 22 ) );
-            scores[i].fullshotgunCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 23 ) );
-            scores[i].rocketRailCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 24 ) );
-            scores[i].itemDeniedCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 25 ) );
-            scores[i].health = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 26 ) );
-            scores[i].armor = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 27 ) );
-            scores[i].yellowArmor = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 28 ) );
-            scores[i].redArmor = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 29 ) );
-            scores[i].megaHealth = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 30 ) );
-            scores[i].accuracys[0][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 31 ) );
-            scores[i].accuracys[0][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 32 ) );
-            scores[i].accuracys[1][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 33 ) );
-            scores[i].accuracys[1][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 34 ) );
-            scores[i].accuracys[2][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 35 ) );
-            scores[i].accuracys[2][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 36 ) );
-            scores[i].accuracys[3][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 37 ) );
-            scores[i].accuracys[3][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 38 ) );
-            scores[i].accuracys[4][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 39 ) );
-            scores[i].accuracys[4][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 40 ) );
-            scores[i].accuracys[5][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 41 ) );
-            scores[i].accuracys[5][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 42 ) );
-            scores[i].accuracys[6][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 43 ) );
-            scores[i].accuracys[6][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 44 ) );
-            scores[i].accuracys[7][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 45 ) );
-            scores[i].accuracys[7][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 46 ) );
-            scores[i].spawnkillCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 47 ) );
+            scores[i].client = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 1 );
+            scores[i].score = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 2 );
+            scores[i].ping = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 3 );
+            scores[i].time = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 4 );
+            scores[i].scoreFlags = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 5 );
+            scores[i].powerUps = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 6 );
+            scores[i].accuracy = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 7 );
+            scores[i].impressiveCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 8 );
+            scores[i].excellentCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 9 );
+            scores[i].guantletCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 10 );
+            scores[i].defendCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 11 );
+            scores[i].assistCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 12 );
+            scores[i].perfect = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 13 );
+            scores[i].captures = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 14 );
+            scores[i].isDead = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 15 );
+            scores[i].dmgdone = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 16 );
+            scores[i].dmgtaken = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 17 );
+            scores[i].specOnly = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 18 );
+            scores[i].deathCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 19 );
+            scores[i].frags = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 20 );
+            scores[i].airrocketCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 21 );
+            scores[i].airgrenadeCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 22 );
+            scores[i].fullshotgunCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 23 );
+            scores[i].rocketRailCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 24 );
+            scores[i].itemDeniedCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 25 );
+            scores[i].health = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 26 );
+            scores[i].armor = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 27 );
+            scores[i].yellowArmor = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 28 );
+            scores[i].redArmor = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 29 );
+            scores[i].megaHealth = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 30 );
+            scores[i].accuracys[0][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 31 );
+            scores[i].accuracys[0][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 32 );
+            scores[i].accuracys[1][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 33 );
+            scores[i].accuracys[1][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 34 );
+            scores[i].accuracys[2][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 35 );
+            scores[i].accuracys[2][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 36 );
+            scores[i].accuracys[3][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 37 );
+            scores[i].accuracys[3][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 38 );
+            scores[i].accuracys[4][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 39 );
+            scores[i].accuracys[4][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 40 );
+            scores[i].accuracys[5][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 41 );
+            scores[i].accuracys[5][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 42 );
+            scores[i].accuracys[6][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 43 );
+            scores[i].accuracys[6][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 44 );
+            scores[i].accuracys[7][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 45 );
+            scores[i].accuracys[7][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 46 );
+            scores[i].spawnkillCount = CG_ServerArgInt ( num_in_packet * NUM_DATA_DUEL + FIRST_DATA + 47 );
 
         }
         else {
-            scores[i].client = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 1 ) );
-            scores[i].score = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 2 ) );
-            scores[i].ping = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 3 ) );
-            scores[i].time = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 4 ) );
-            scores[i].scoreFlags = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 5 ) );
-            scores[i].powerUps = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 6 ) );
-            scores[i].accuracy = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 7 ) );
-            scores[i].impressiveCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 8 ) );
-            scores[i].excellentCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 9 ) );
-            scores[i].guantletCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 10 ) );
-            scores[i].defendCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 11 ) );
-            scores[i].assistCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 12 ) );
-            scores[i].perfect = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 13 ) );
-            scores[i].captures = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 14 ) );
-            scores[i].isDead = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 15 ) );
-            scores[i].dmgdone = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 16 ) );
-            scores[i].dmgtaken = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 17 ) );
-            scores[i].specOnly = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 18 ) );
-            scores[i].deathCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 19 ) );
-            scores[i].frags = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 20 ) );
-            scores[i].airrocketCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 21 ) );
-            scores[i].airgrenadeCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 22 ) );
-            scores[i].fullshotgunCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 23 ) );
-            scores[i].rocketRailCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 24 ) );
-            scores[i].itemDeniedCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 25 ) );
-            scores[i].spawnkillCount = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 26 ) );    
-            scores[i].accuracys[0][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 27 ) );
-            scores[i].accuracys[0][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 28 ) );
-            scores[i].accuracys[1][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 29 ) );
-            scores[i].accuracys[1][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 30 ) );
-            scores[i].accuracys[2][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 31 ) );
-            scores[i].accuracys[2][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 32 ) );
-            scores[i].accuracys[3][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 33 ) );
-            scores[i].accuracys[3][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 34 ) );
-            scores[i].accuracys[4][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 35 ) );
-            scores[i].accuracys[4][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 36 ) );
-            scores[i].accuracys[5][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 37 ) );
-            scores[i].accuracys[5][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 38 ) );
-            scores[i].accuracys[6][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 39 ) );
-            scores[i].accuracys[6][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 40 ) );
-            scores[i].accuracys[7][0] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 41 ) );
-            scores[i].accuracys[7][1] = atoi ( CG_Argv ( num_in_packet * NUM_DATA + FIRST_DATA + 42 ) );
+            scores[i].client = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 1 );
+            scores[i].score = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 2 );
+            scores[i].ping = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 3 );
+            scores[i].time = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 4 );
+            scores[i].scoreFlags = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 5 );
+            scores[i].powerUps = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 6 );
+            scores[i].accuracy = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 7 );
+            scores[i].impressiveCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 8 );
+            scores[i].excellentCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 9 );
+            scores[i].guantletCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 10 );
+            scores[i].defendCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 11 );
+            scores[i].assistCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 12 );
+            scores[i].perfect = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 13 );
+            scores[i].captures = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 14 );
+            scores[i].isDead = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 15 );
+            scores[i].dmgdone = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 16 );
+            scores[i].dmgtaken = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 17 );
+            scores[i].specOnly = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 18 );
+            scores[i].deathCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 19 );
+            scores[i].frags = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 20 );
+            scores[i].airrocketCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 21 );
+            scores[i].airgrenadeCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 22 );
+            scores[i].fullshotgunCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 23 );
+            scores[i].rocketRailCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 24 );
+            scores[i].itemDeniedCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 25 );
+            scores[i].spawnkillCount = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 26 );    
+            scores[i].accuracys[0][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 27 );
+            scores[i].accuracys[0][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 28 );
+            scores[i].accuracys[1][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 29 );
+            scores[i].accuracys[1][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 30 );
+            scores[i].accuracys[2][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 31 );
+            scores[i].accuracys[2][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 32 );
+            scores[i].accuracys[3][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 33 );
+            scores[i].accuracys[3][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 34 );
+            scores[i].accuracys[4][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 35 );
+            scores[i].accuracys[4][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 36 );
+            scores[i].accuracys[5][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 37 );
+            scores[i].accuracys[5][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 38 );
+            scores[i].accuracys[6][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 39 );
+            scores[i].accuracys[6][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 40 );
+            scores[i].accuracys[7][0] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 41 );
+            scores[i].accuracys[7][1] = CG_ServerArgInt ( num_in_packet * NUM_DATA + FIRST_DATA + 42 );
             
         }
     }
@@ -316,10 +423,10 @@ static void CG_ParseScores ( void ) {
 			cg.numScores = MAX_CLIENTS;
 		}
 
-		cg.teamScores[0] = atoi(CG_Argv(2));
-		cg.teamScores[1] = atoi(CG_Argv(3));
+		cg.teamScores[0] = CG_ServerArgInt(2);
+		cg.teamScores[1] = CG_ServerArgInt(3);
 
-		cgs.roundStartTime = atoi(CG_Argv(4));
+		cgs.roundStartTime = CG_ServerArgInt(4);
 
 		//Update thing in lower-right corner
 		if(cgs.gametype == GT_ELIMINATION || cgs.gametype == GT_CTF_ELIMINATION) {
@@ -448,14 +555,14 @@ CG_PreParseStatistics
 static void CG_PreParseStatistics ( void ) {
     int		i, j, numStats;
 
-    numStats = atoi ( CG_Argv ( 1 ) );
+    numStats = CG_ServerArgInt ( 1 );
     if ( numStats+clientStatsPresent > MAX_CLIENTS ) {
         numStats = MAX_CLIENTS-clientStatsPresent;
     }
     for ( i = clientStatsPresent ; i < clientStatsPresent+numStats ; i++ ) {
 
         for ( j = 0; j < STATISTIC_MAX; j++ ) {
-            clientStats[i][j] = atoi ( CG_Argv ( (i-clientStatsPresent) * NUM_DATA_STATS + FIRST_DATA_STATS + 1 + j ) );
+            clientStats[i][j] = CG_ServerArgInt ( (i-clientStatsPresent) * NUM_DATA_STATS + FIRST_DATA_STATS + 1 + j );
         }
     }
     clientStatsPresent = i;
@@ -496,14 +603,14 @@ static void CG_ParseStatistics ( void ) {
         "D"
     };
 
-    numStats = atoi ( CG_Argv ( 1 ) );
+    numStats = CG_ServerArgInt ( 1 );
     if ( numStats+clientStatsPresent > MAX_CLIENTS ) {
         numStats = MAX_CLIENTS-clientStatsPresent;
     }
     for ( i = clientStatsPresent ; i < clientStatsPresent+numStats ; i++ ) {
 
         for ( j = 0; j < STATISTIC_MAX; j++ ) {
-            clientStats[i][j] = atoi ( CG_Argv ( (i-clientStatsPresent) * NUM_DATA_STATS + FIRST_DATA_STATS + 1 + j ) );
+            clientStats[i][j] = CG_ServerArgInt ( (i-clientStatsPresent) * NUM_DATA_STATS + FIRST_DATA_STATS + 1 + j );
         }
     }
     clientStatsPresent = i;
@@ -720,8 +827,8 @@ static void CG_ParseAccuracy ( void ) {
     int		i;
 
     for ( i = 0 ; i < 8 ; i++ ) {
-        cg.accuracys[i][0] = atoi ( CG_Argv ( i*2 + 1 ) );
-        cg.accuracys[i][1] = atoi ( CG_Argv ( i*2 + 2 ) );
+        cg.accuracys[i][0] = CG_ServerArgInt ( i*2 + 1 );
+        cg.accuracys[i][1] = CG_ServerArgInt ( i*2 + 2 );
     }
 
 }
@@ -735,9 +842,9 @@ CG_ParseTimeout
 static void CG_ParseTimeout ( void ) {
     qhandle_t sound;
     cgs.timeout = qtrue;
-    cgs.timeoutTime = atoi ( CG_Argv ( 1 ) );
-    cgs.timeoutAdd = atoi ( CG_Argv ( 2 ) );
-    cgs.roundStartTime = atoi ( CG_Argv ( 3 ) );
+    cgs.timeoutTime = CG_ServerArgInt ( 1 );
+    cgs.timeoutAdd = CG_ServerArgInt ( 2 );
+    cgs.roundStartTime = CG_ServerArgInt ( 3 );
     cgs.timeoutDelay = cgs.timeoutDelay + cgs.timeoutAdd;
 
     CG_Printf ( "Timeout for %f seconds\n", ( ( float ) cgs.timeoutAdd ) /1000.0f );
@@ -776,13 +883,13 @@ static void CG_ParseRespawnTimer ( void ) {
 
     found = qfalse;
 
-    entityNum = atoi ( CG_Argv ( 1 ) );
-    itemType = atoi ( CG_Argv ( 2 ) );
-    quantity = atoi ( CG_Argv ( 3 ) );
-    respawnTime = atoi ( CG_Argv ( 4 ) );
-    nextItem = atoi ( CG_Argv ( 5 ) );
-    team = atoi ( CG_Argv ( 6 ) );
-    clientNum = atoi ( CG_Argv ( 7 ) );
+    entityNum = CG_ServerArgInt ( 1 );
+    itemType = CG_ServerArgInt ( 2 );
+    quantity = CG_ServerArgInt ( 3 );
+    respawnTime = CG_ServerArgInt ( 4 );
+    nextItem = CG_ServerArgInt ( 5 );
+    team = CG_ServerArgInt ( 6 );
+    clientNum = CG_ServerArgInt ( 7 );
 
 
 
@@ -817,7 +924,7 @@ CG_ParseRespawnTimer
 */
 static void CG_ParseReadyMask ( void ) {
     int readyMask, i;
-    readyMask = atoi ( CG_Argv ( 1 ) );
+    readyMask = CG_ServerArgInt ( 1 );
 
     if ( cg.warmup >= 0 )
         return;
@@ -844,10 +951,10 @@ CG_ParseElimination
 */
 static void CG_ParseElimination ( void ) {
     if ( cgs.gametype == GT_ELIMINATION || cgs.gametype == GT_CTF_ELIMINATION ) {
-        cgs.scores1 = atoi ( CG_Argv ( 1 ) );
-        cgs.scores2 = atoi ( CG_Argv ( 2 ) );
+        cgs.scores1 = CG_ServerArgInt ( 1 );
+        cgs.scores2 = CG_ServerArgInt ( 2 );
     }
-    cgs.roundStartTime = atoi ( CG_Argv ( 3 ) );
+    cgs.roundStartTime = CG_ServerArgInt ( 3 );
 }
 
 /*
@@ -863,7 +970,7 @@ static void CG_ParseMappage ( void ) {
     const char*	c;
     int i;
 
-    temp = CG_Argv ( 1 );
+    temp = CG_ServerArgv ( 1 );
     for ( c = temp; *c; ++c ) {
         switch ( *c ) {
         case '\n':
@@ -876,7 +983,7 @@ static void CG_ParseMappage ( void ) {
     }
     Q_strncpyz ( command,va ( "ui_mappage %s",temp ),1024 );
     for ( i=2;i<12;i++ ) {
-        temp = CG_Argv ( i );
+        temp = CG_ServerArgv ( i );
         for ( c = temp; *c; ++c ) {
             switch ( *c ) {
             case '\n':
@@ -902,7 +1009,7 @@ CG_ParseDDtimetaken
 =================
 */
 static void CG_ParseDDtimetaken ( void ) {
-    cgs.timetaken = atoi ( CG_Argv ( 1 ) );
+    cgs.timetaken = CG_ServerArgInt ( 1 );
 }
 
 /*
@@ -913,11 +1020,11 @@ CG_ParseDomPointNames
 
 static void CG_ParseDomPointNames ( void ) {
     int i,j;
-    cgs.domination_points_count = atoi ( CG_Argv ( 1 ) );
+    cgs.domination_points_count = CG_ServerArgInt ( 1 );
     if ( cgs.domination_points_count>=MAX_DOMINATION_POINTS )
         cgs.domination_points_count = MAX_DOMINATION_POINTS;
     for ( i = 0;i<cgs.domination_points_count;i++ ) {
-        Q_strncpyz ( cgs.domination_points_names[i],CG_Argv ( 2 ) +i*MAX_DOMINATION_POINTS_NAMES,MAX_DOMINATION_POINTS_NAMES-1 );
+        Q_strncpyz ( cgs.domination_points_names[i],CG_ServerArgv ( 2 ) +i*MAX_DOMINATION_POINTS_NAMES,MAX_DOMINATION_POINTS_NAMES-1 );
         for ( j=MAX_DOMINATION_POINTS_NAMES-1; cgs.domination_points_names[i][j] < '0' && j>0; j-- ) {
             cgs.domination_points_names[i][j] = 0;
         }
@@ -932,12 +1039,12 @@ CG_ParseDomScores
 
 static void CG_ParseDomStatus ( void ) {
     int i;
-    if ( cgs.domination_points_count!=atoi ( CG_Argv ( 1 ) ) ) {
+    if ( cgs.domination_points_count!=CG_ServerArgInt ( 1 ) ) {
         cgs.domination_points_count = 0;
         return;
     }
     for ( i = 0;i<cgs.domination_points_count;i++ ) {
-        cgs.domination_points_status[i] = atoi ( CG_Argv ( 2+i ) );
+        cgs.domination_points_status[i] = CG_ServerArgInt ( 2+i );
     }
 }
 
@@ -948,7 +1055,7 @@ CG_ParseChallenge
 */
 
 static void CG_ParseChallenge ( void ) {
-    addChallenge ( atoi ( CG_Argv ( 1 ) ) );
+    addChallenge ( CG_ServerArgInt ( 1 ) );
 }
 
 /*
@@ -963,8 +1070,8 @@ static void CG_ParseRewards ( void ) {
     if ( !cg_newRewards.integer )
         return;
 
-    reward = atoi ( CG_Argv ( 1 ) );
-    rewardCount = atoi ( CG_Argv ( 2 ) );
+    reward = CG_ServerArgInt ( 1 );
+    rewardCount = CG_ServerArgInt ( 2 );
     if ( reward == REWARD_AIRROCKET ) {
         pushReward ( cgs.media.airrocketSound, cgs.media.medalAirrocket, rewardCount );
     } else if ( reward == REWARD_AIRGRENADE ) {
@@ -993,7 +1100,7 @@ CG_ParseTeam
 static void CG_ParseTeam ( void ) {
     //TODO: Add code here
     if ( cg_voip_teamonly.integer )
-        trap_Cvar_Set ( "cl_voipSendTarget",CG_Argv ( 1 ) );
+        trap_Cvar_Set ( "cl_voipSendTarget",CG_ServerArgv ( 1 ) );
 }
 
 /*
@@ -1004,7 +1111,7 @@ CG_ParseAttackingTeam
 */
 static void CG_ParseAttackingTeam ( void ) {
     int temp;
-    temp = atoi ( CG_Argv ( 1 ) );
+    temp = CG_ServerArgInt ( 1 );
     if ( temp==TEAM_RED )
         cgs.attackingTeam = TEAM_RED;
     else if ( temp==TEAM_BLUE )
@@ -1023,7 +1130,7 @@ static void CG_ParseTeamInfo ( void ) {
     int		i;
     int		client;
 
-    numSortedTeamPlayers = atoi ( CG_Argv ( 1 ) );
+    numSortedTeamPlayers = CG_ServerArgInt ( 1 );
     if ( numSortedTeamPlayers < 0 || numSortedTeamPlayers > TEAM_MAXOVERLAY ) {
         CG_Error ( "CG_ParseTeamInfo: numSortedTeamPlayers out of range (%d)",
                    numSortedTeamPlayers );
@@ -1031,7 +1138,7 @@ static void CG_ParseTeamInfo ( void ) {
     }
 
     for ( i = 0 ; i < numSortedTeamPlayers ; i++ ) {
-        client = atoi ( CG_Argv ( i * 6 + 2 ) );
+        client = CG_ServerArgInt ( i * 6 + 2 );
         if ( client < 0 || client >= MAX_CLIENTS ) {
             CG_Error ( "CG_ParseTeamInfo: bad client number: %d", client );
             return;
@@ -1040,27 +1147,27 @@ static void CG_ParseTeamInfo ( void ) {
 
         sortedTeamPlayers[i] = client;
 
-        cgs.clientinfo[ client ].location = atoi ( CG_Argv ( i * 6 + 3 ) );
-        cgs.clientinfo[ client ].health = atoi ( CG_Argv ( i * 6 + 4 ) );
-        cgs.clientinfo[ client ].armor = atoi ( CG_Argv ( i * 6 + 5 ) );
-        cgs.clientinfo[ client ].curWeapon = atoi ( CG_Argv ( i * 6 + 6 ) );
-        cgs.clientinfo[ client ].powerups = atoi ( CG_Argv ( i * 6 + 7 ) );
+        cgs.clientinfo[ client ].location = CG_ServerArgInt ( i * 6 + 3 );
+        cgs.clientinfo[ client ].health = CG_ServerArgInt ( i * 6 + 4 );
+        cgs.clientinfo[ client ].armor = CG_ServerArgInt ( i * 6 + 5 );
+        cgs.clientinfo[ client ].curWeapon = CG_ServerArgInt ( i * 6 + 6 );
+        cgs.clientinfo[ client ].powerups = CG_ServerArgInt ( i * 6 + 7 );
     }
 }
 
 static void CG_ParseWeaponProperties(void) {
-	wp_gauntletRate     = atoi(CG_Argv(1));
-	wp_machinegunRate   = atoi(CG_Argv(2));
-	wp_machinegunSpread = atoi(CG_Argv(3));
-	wp_shotgunRate      = atoi(CG_Argv(4));
-	wp_shotgunCount     = atoi(CG_Argv(5));
-	wp_shotgunSpread    = atoi(CG_Argv(6));
-	wp_plasmaRate       = atoi(CG_Argv(7));
-	wp_lightningRate    = atoi(CG_Argv(8));
-	wp_grenadeRate      = atoi(CG_Argv(9));
-	wp_rocketRate       = atoi(CG_Argv(10));
-	wp_railRate         = atoi(CG_Argv(11));
-	wp_bfgRate          = atoi(CG_Argv(12));
+	wp_gauntletRate     = CG_ServerArgInt(1);
+	wp_machinegunRate   = CG_ServerArgInt(2);
+	wp_machinegunSpread = CG_ServerArgInt(3);
+	wp_shotgunRate      = CG_ServerArgInt(4);
+	wp_shotgunCount     = CG_ServerArgInt(5);
+	wp_shotgunSpread    = CG_ServerArgInt(6);
+	wp_plasmaRate       = CG_ServerArgInt(7);
+	wp_lightningRate    = CG_ServerArgInt(8);
+	wp_grenadeRate      = CG_ServerArgInt(9);
+	wp_rocketRate       = CG_ServerArgInt(10);
+	wp_railRate         = CG_ServerArgInt(11);
+	wp_bfgRate          = CG_ServerArgInt(12);
 }
 
 
@@ -1259,7 +1366,7 @@ static void CG_ConfigStringModified ( void ) {
     const char	*str;
     int		num;
 
-    num = atoi ( CG_Argv ( 1 ) );
+    num = CG_ServerArgInt ( 1 );
 
     // get the gamestate from the client system, which will have the
     // new configstring already integrated
@@ -1945,8 +2052,8 @@ void CG_ParseLivingCount ( void ) {
     int newRed, newBlue;
     int countRed, countBlue;
 
-    countRed = atoi ( CG_Argv ( 3 ) );
-    countBlue = atoi ( CG_Argv ( 4 ) );
+    countRed = CG_ServerArgInt ( 3 );
+    countBlue = CG_ServerArgInt ( 4 );
 
     if ( cg.warmup < 0 ) {
         cgs.redLivingCount = countRed;
@@ -1954,10 +2061,10 @@ void CG_ParseLivingCount ( void ) {
         return;
     }
 
-    newRed = atoi ( CG_Argv ( 1 ) );
-    newBlue = atoi ( CG_Argv ( 2 ) );
-    countRed = atoi ( CG_Argv ( 3 ) );
-    countBlue = atoi ( CG_Argv ( 4 ) );
+    newRed = CG_ServerArgInt ( 1 );
+    newBlue = CG_ServerArgInt ( 2 );
+    countRed = CG_ServerArgInt ( 3 );
+    countBlue = CG_ServerArgInt ( 4 );
 
     if ( newRed == 1 && newRed != cgs.redLivingCount && cgs.clientinfo[cg.clientNum].team == TEAM_RED && !cgs.clientinfo[cg.clientNum].isDead ) {
         if ( countRed != 1 )
@@ -1991,15 +2098,15 @@ static void CG_RemoveChatEscapeChar ( char *text ) {
 
 static void CG_ParseSpawnpoints( void ){
     int i;
-    cg.numSpawnpoints = atoi( CG_Argv(1) );
+    cg.numSpawnpoints = CG_ServerArgInt(1);
     for( i = 0; i < cg.numSpawnpoints ; i++ ){
-	cg.spawnOrg[i][0] = atof(CG_Argv( 2 + i*7 ));
-	cg.spawnOrg[i][1] = atof(CG_Argv( 3 + i*7 ));
-	cg.spawnOrg[i][2] = atof(CG_Argv( 4 + i*7 ));
-	cg.spawnAngle[i][0] = atof(CG_Argv( 5 + i*7 ));
-	cg.spawnAngle[i][1] = atof(CG_Argv( 6 + i*7 ));
-	cg.spawnAngle[i][2] = atof(CG_Argv( 7 + i*7 ));
-	cg.spawnTeam[i] = atoi(CG_Argv( 8 + i*7 ));
+	cg.spawnOrg[i][0] = CG_ServerArgFloat( 2 + i*7 );
+	cg.spawnOrg[i][1] = CG_ServerArgFloat( 3 + i*7 );
+	cg.spawnOrg[i][2] = CG_ServerArgFloat( 4 + i*7 );
+	cg.spawnAngle[i][0] = CG_ServerArgFloat( 5 + i*7 );
+	cg.spawnAngle[i][1] = CG_ServerArgFloat( 6 + i*7 );
+	cg.spawnAngle[i][2] = CG_ServerArgFloat( 7 + i*7 );
+	cg.spawnTeam[i] = CG_ServerArgInt( 8 + i*7 );
     }
 }
 
@@ -2007,11 +2114,11 @@ static void CG_GotoServerForce( void ){
 	char		otherserver[MAX_TOKEN_CHARS];
   char *cmd;
 
-	if ( trap_Argc() < 2 ) {
+	if ( CG_ServerArgc() < 2 ) {
                 //G_Printf("Usage: gotoOtherServerForce <clientnum or *> <otherserver>\n");
 		return;
 	}
-	trap_Argv( 1, otherserver, sizeof( otherserver ) );
+	Q_strncpyz( otherserver, CG_ServerArgv( 1 ), sizeof( otherserver ) );
 
   cmd = va ( "connect %s\n", otherserver );
   trap_SendConsoleCommand ( cmd );
@@ -2022,14 +2129,15 @@ static void CG_GotoServerForce( void ){
 CG_ServerCommand
 
 The string has been tokenized and can be retrieved with
-Cmd_Argc() / Cmd_Argv()
+CG_ServerArgc() / CG_ServerArgv()
 =================
 */
 static void CG_ServerCommand ( void ) {
     const char	*cmd;
     char		text[MAX_SAY_TEXT];
 
-    cmd = CG_Argv ( 0 );
+    CG_TokenizeServerArgs();
+    cmd = CG_ServerArgv ( 0 );
 
     if ( !cmd[0] ) {
         // server claimed the command
@@ -2052,7 +2160,7 @@ static void CG_ServerCommand ( void ) {
     }
     
     if ( !strcmp ( cmd, "quadKill" ) ) {
-        cg.quadKills = atoi( CG_Argv(1) );
+        cg.quadKills = CG_ServerArgInt(1);
         return;
     }
 
@@ -2067,7 +2175,7 @@ static void CG_ServerCommand ( void ) {
     }
 
     if ( !strcmp ( cmd, "cp" ) ) {
-        CG_CenterPrint ( CG_Argv ( 1 ), SCREEN_HEIGHT * 0.30, BIGCHAR_WIDTH );
+        CG_CenterPrint ( CG_ServerArgv ( 1 ), SCREEN_HEIGHT * 0.30, BIGCHAR_WIDTH );
 	if( !strcmp ( cmd, "^1Defend!" ) )
 		cgs.csStatus = 1;
 	if( !strcmp ( cmd, "^2Capture!" ) )
@@ -2081,8 +2189,8 @@ static void CG_ServerCommand ( void ) {
     }
 
     if ( !strcmp ( cmd, "print" ) ) {
-        CG_Printf ( "%s", CG_Argv ( 1 ) );
-        cmd = CG_Argv ( 1 );			// yes, this is obviously a hack, but so is the way we hear about
+        CG_Printf ( "%s", CG_ServerArgv ( 1 ) );
+        cmd = CG_ServerArgv ( 1 );			// yes, this is obviously a hack, but so is the way we hear about
 
 		// Check that cmd is exact failed/pass string with exact length.
 		// Otherwise the sound might can be triggered if someone renames to "vote passed"
@@ -2097,25 +2205,25 @@ static void CG_ServerCommand ( void ) {
         return;
     }
     if ( !strcmp ( cmd, "screenPrint" ) ) {
-        Q_strncpyz ( text, CG_Argv ( 1 ), MAX_SAY_TEXT );
+        Q_strncpyz ( text, CG_ServerArgv ( 1 ), MAX_SAY_TEXT );
         CG_RemoveChatEscapeChar ( text );
         CG_AddToChat ( text );
         return;
     }
     if ( !strcmp ( cmd, "secho" ) ) {
         // do a screenPrint and consoleprint in one serverclient command
-        Q_strncpyz ( text, CG_Argv ( 1 ), MAX_SAY_TEXT );
+        Q_strncpyz ( text, CG_ServerArgv ( 1 ), MAX_SAY_TEXT );
         CG_RemoveChatEscapeChar ( text );
         CG_AddToChat ( text );
         // add the \n in the console
-        CG_Printf ( "%s\n", CG_Argv ( 1 ) );
+        CG_Printf ( "%s\n", CG_ServerArgv ( 1 ) );
         return;
     }
     if ( !strcmp ( cmd, "chat" ) ) {
         if ( !cg_teamChatsOnly.integer && !cg_noChat.integer ) {
             if ( cg_chatBeep.integer )
                 trap_S_StartLocalSound ( cgs.media.talkSound, CHAN_LOCAL_SOUND );
-            Q_strncpyz ( text, CG_Argv ( 1 ), MAX_SAY_TEXT );
+            Q_strncpyz ( text, CG_ServerArgv ( 1 ), MAX_SAY_TEXT );
             CG_RemoveChatEscapeChar ( text );
             CG_AddToChat ( text );
             CG_Printf ( "%s\n", text );
@@ -2127,7 +2235,7 @@ static void CG_ServerCommand ( void ) {
         if ( !cg_noChat.integer ) {
             if ( cg_teamChatBeep.integer )
                 trap_S_StartLocalSound ( cgs.media.talkSound, CHAN_LOCAL_SOUND );
-            Q_strncpyz ( text, CG_Argv ( 1 ), MAX_SAY_TEXT );
+            Q_strncpyz ( text, CG_ServerArgv ( 1 ), MAX_SAY_TEXT );
             CG_RemoveChatEscapeChar ( text );
             CG_AddToTeamChat ( text );
             CG_Printf ( "%s\n", text );
@@ -2210,14 +2318,14 @@ static void CG_ServerCommand ( void ) {
     }
 
     if ( Q_stricmp ( cmd, "remapShader" ) == 0 ) {
-        if ( trap_Argc() == 4 ) {
+        if ( CG_ServerArgc() == 4 ) {
             char shader1[MAX_QPATH];
             char shader2[MAX_QPATH];
             char shader3[MAX_QPATH];
 
-            Q_strncpyz ( shader1, CG_Argv ( 1 ), sizeof ( shader1 ) );
-            Q_strncpyz ( shader2, CG_Argv ( 2 ), sizeof ( shader2 ) );
-            Q_strncpyz ( shader3, CG_Argv ( 3 ), sizeof ( shader3 ) );
+            Q_strncpyz ( shader1, CG_ServerArgv ( 1 ), sizeof ( shader1 ) );
+            Q_strncpyz ( shader2, CG_ServerArgv ( 2 ), sizeof ( shader2 ) );
+            Q_strncpyz ( shader3, CG_ServerArgv ( 3 ), sizeof ( shader3 ) );
 
             trap_R_RemapShader ( shader1, shader2, shader3 );
         }
@@ -2280,7 +2388,7 @@ static void CG_ServerCommand ( void ) {
         //TODO: Create a ParseCustomvotes function
         memset ( &infoString,0,sizeof ( infoString ) );
         for ( i=1;i<=12;i++ ) {
-            Q_strcat ( infoString,sizeof ( infoString ),CG_Argv ( i ) );
+            Q_strcat ( infoString,sizeof ( infoString ),CG_ServerArgv ( i ) );
             Q_strcat ( infoString,sizeof ( infoString )," " );
         }
         trap_Cvar_Set ( "cg_vote_custom_commands",infoString );
@@ -80,7 +80,7 @@ static void CG_SetHudFontsize( int hudnumber, char* arg1, char* arg2, char* arg3
 static void CG_SetHudImage( int hudnumber, char* arg1, char* arg2, char* arg3, char* arg4 ){
 	cgs.hud[hudnumber].image = arg1;
 	//CG_Printf("%s\n", arg1);
-	cgs.hud[hudnumber].imageHandle = trap_R_RegisterShader( arg1 );
+	cgs.hud[hudnumber].imageHandle = CG_CachedShader( arg1 );
 	if( !cgs.hud[hudnumber].imageHandle )
 		CG_Printf("%s not found\n", arg1);
 }
@@ -526,6 +526,8 @@ void CG_LoadHudFile( const char* hudFile ){
 	int len;
 	fileHandle_t	f;
 	
+	cgs.hudGeneration++;
+
 	// Default hud init
 	cgs.hud[HUD_DEFAULT].text = (char*)"";
 	cgs.hud[HUD_DEFAULT].image = (char*)"";
@@ -616,6 +618,8 @@ void CG_LoadHudFile( const char* hudFile ){
 
 void CG_ClearHud( void ){
 	int i;
+
+	cgs.hudGeneration++;
 	for( i = 0; i < HUD_MAX; i++ ){
 		cgs.hud[i].bgcolor[0] = 0;
 		cgs.hud[i].bgcolor[1] = 0;
@@ -633,7 +637,7 @@ void CG_ClearHud( void ){
 		cgs.hud[i].height = 0;
 		cgs.hud[i].width = 0;
 		cgs.hud[i].image = (char*)"";
-		cgs.hud[i].imageHandle = trap_R_RegisterShader(cgs.hud[i].image);
+		cgs.hud[i].imageHandle = 0;
 		cgs.hud[i].inuse = qfalse;
 		cgs.hud[i].text = (char*)"";
 		cgs.hud[i].textAlign = 1;
@@ -643,6 +647,31 @@ void CG_ClearHud( void ){
 		cgs.hud[i].ypos = 0;
 	}
 }
+/*
+=================
+CG_HudCost
+
+Prints the draw calls every visible hud element issues per frame and
+how often its draw list had to be rebuilt since the last readout.
+Elements rebuilt on nearly every frame are the expensive ones.
+=================
+*/
+static void CG_HudCost( void ){
+	int i;
+	int ops, rebuilds, frames;
+	int totalOps = 0;
+
+	CG_Printf("%-24s %6s %10s\n", "element", "calls", "rebuilt");
+	for( i = HUD_DEFAULT+1; i < HUD_MAX; i++ ){
+		CG_HudListStats( i, &ops, &rebuilds, &frames );
+		if( !cgs.hud[i].inuse || !frames )
+			continue;
+		CG_Printf("%-24s %6i %4i/%-5i\n", HudNames[i], ops, rebuilds, frames );
+		totalOps += ops;
+	}
+	CG_Printf("%i draw calls per frame\n", totalOps );
+}
+
 //TODO: complete this
 void CG_HudEdit_f( void ){
 	int i;
@@ -657,8 +686,16 @@ void CG_HudEdit_f( void ){
 			CG_Printf("%s, ", HudNames[i]);
 		}
 		CG_Printf("\n");
+		CG_Printf("hudedit cost: show draw calls per hud element\n");
 		return;
 	}
+
+	if( !strcmp( CG_Argv(1), "cost" ) ){
+		CG_HudCost();
+		return;
+	}
+
+	cgs.hudGeneration++;
 	
 	for( i = 0; i < HUD_MAX; i++ ){
 		if( !strcmp( CG_Argv(1), HudNames[i] ) )
@@ -986,6 +986,7 @@ static void CG_AddMultiviewWindow( stereoFrame_t stereoView ) {
     while ( j <= 4 && j <= cg_multiview.integer ) {
         i = CG_GetEntityNumForMV(j);
         CG_SetMultiviewRect(j);
+        CG_HudListView(j-1);
         j++;
 
         if ( i == -1 )
@@ -1020,6 +1021,7 @@ static void CG_AddMultiviewWindow( stereoFrame_t stereoView ) {
     }
 
     //Set everything back to the main-spec values
+    CG_HudListView(0);
     cg.snap->ps.stats[STAT_HEALTH] = health;
     cg.snap->ps.stats[STAT_ARMOR] = armor;
     cg.snap->ps.persistant[PERS_TEAM] = team;
@@ -1158,6 +1160,9 @@ void CG_DrawActiveFrame( int serverTime, stereoFrame_t stereoView, qboolean demo
     // let the client system know what our weapon and zoom settings are
     trap_SetUserCmdValue( cg.weaponSelect, cg.zoomSensitivity );
 
+    // load a slice of any queued player models
+    CG_UpdateClientModels();
+
     // this counter will be bumped for every valid scene we generate
     cg.clientFrame++;
 
@@ -250,7 +250,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 		
 		if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 			if( localPlayer->team != ci->team ){
-				CG_setRGBA(re->shaderRGBA, cg_enemyWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], re->shaderRGBA);
 				/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 				re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 				re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -262,7 +262,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 				le->color[3] = ((float)re->shaderRGBA[3])/255.0;
 			}
 			else{
-				CG_setRGBA(re->shaderRGBA, cg_teamWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], re->shaderRGBA);
 				/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 				re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 				re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -275,7 +275,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 			}
 		}
 		else if( localPlayer != ci ){
-			CG_setRGBA(re->shaderRGBA, cg_enemyWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], re->shaderRGBA);
 			/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 			re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 			re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -287,7 +287,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 			le->color[3] = ((float)re->shaderRGBA[3])/255.0;
 		}
 		else{
-			CG_setRGBA(re->shaderRGBA, cg_teamWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], re->shaderRGBA);
 			/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 			re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 			re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -358,7 +358,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 		
 				if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 					if( localPlayer->team != ci->team ){
-						CG_setRGBA(re->shaderRGBA, cg_enemyWeaponColor.string);
+						Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], re->shaderRGBA);
 						/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 						re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 						re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -370,7 +370,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 						le->color[3] = ((float)re->shaderRGBA[3])/255.0;
 					}
 					else{
-						CG_setRGBA(re->shaderRGBA, cg_teamWeaponColor.string);
+						Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], re->shaderRGBA);
 						/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 						re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 						re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -383,7 +383,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 					}
 				}
 				else if( localPlayer != ci ){
-					CG_setRGBA(re->shaderRGBA, cg_enemyWeaponColor.string);
+					Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], re->shaderRGBA);
 					/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 					re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 					re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -395,7 +395,7 @@ void CG_RailTrail (clientInfo_t *ci, vec3_t start, vec3_t end) {
 					le->color[3] = ((float)re->shaderRGBA[3])/255.0;
 				}
 				else{
-					CG_setRGBA(re->shaderRGBA, cg_teamWeaponColor.string);
+					Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], re->shaderRGBA);
 					/*re->shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 					re->shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 					re->shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
@@ -474,26 +474,26 @@ static void CG_RocketTrail( centity_t *ent, const weaponInfo_t *wi ) {
 	if( ( ( wi->item->giTag == WP_GRENADE_LAUNCHER ) && ( cg_forceWeaponColor.integer & 2 ) ) || ( ( wi->item->giTag == WP_ROCKET_LAUNCHER ) && ( cg_forceWeaponColor.integer & 4 ) ) ){
 		if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 			if( local->team != other->team ){
-				CG_setRGBA(color,cg_enemyWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], color);
 				/*red = ((float)hexToRed( cg_enemyWeaponColor.string ))/255.0f;
 				green = ((float)hexToGreen( cg_enemyWeaponColor.string ))/255.0f;
 				blue = ((float)hexToBlue( cg_enemyWeaponColor.string ))/255.0f;*/
 			}
 			else{
-				CG_setRGBA(color,cg_teamWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], color);
 				/*red = ((float)hexToRed( cg_teamWeaponColor.string ))/255.0f;
 				green = ((float)hexToGreen( cg_teamWeaponColor.string ))/255.0f;
 				blue = ((float)hexToBlue( cg_teamWeaponColor.string ))/255.0f;*/
 			}
 		}
 		else if( cg.clientNum != cg_entities[ent->currentState.otherEntityNum].currentState.number ){
-			CG_setRGBA(color,cg_enemyWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], color);
 			/*red = ((float)hexToRed( cg_enemyWeaponColor.string ))/255.0f;
 			green = ((float)hexToGreen( cg_enemyWeaponColor.string ))/255.0f;
 			blue = ((float)hexToBlue( cg_enemyWeaponColor.string ))/255.0f;*/
 		}
 		else{
-			CG_setRGBA(color,cg_teamWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], color);
 			/*red = ((float)hexToRed( cg_teamWeaponColor.string ))/255.0f;
 			green = ((float)hexToGreen( cg_teamWeaponColor.string ))/255.0f;
 			blue = ((float)hexToBlue( cg_teamWeaponColor.string ))/255.0f;*/
@@ -1630,14 +1630,14 @@ static void CG_LightningBolt( centity_t *cent, vec3_t origin ) {
 		beam.customShader = cgs.media.lightningShaderColor[style];
 		if( cgs.gametype >= GT_TEAM && cgs.ffa_gt != 1 ){
 			if( local->team != other->team ){
-				CG_setRGBA(beam.shaderRGBA, cg_enemyWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], beam.shaderRGBA);
 				/*beam.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 				beam.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 				beam.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
 				beam.shaderRGBA[3] = hexToAlpha( cg_enemyWeaponColor.string );*/
 			}
 			else{
-				CG_setRGBA(beam.shaderRGBA, cg_teamWeaponColor.string);
+				Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], beam.shaderRGBA);
 				/*beam.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 				beam.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
 				beam.shaderRGBA[2] = hexToBlue( cg_teamWeaponColor.string );
@@ -1645,14 +1645,14 @@ static void CG_LightningBolt( centity_t *cent, vec3_t origin ) {
 			}
 		}
 		else if( cg.clientNum != cent->currentState.number ){
-			CG_setRGBA(beam.shaderRGBA, cg_enemyWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_ENEMY_WEAPON], beam.shaderRGBA);
 			/*beam.shaderRGBA[0] = hexToRed( cg_enemyWeaponColor.string );
 			beam.shaderRGBA[1] = hexToGreen( cg_enemyWeaponColor.string );
 			beam.shaderRGBA[2] = hexToBlue( cg_enemyWeaponColor.string );
 			beam.shaderRGBA[3] = hexToAlpha( cg_enemyWeaponColor.string );*/
 		}
 		else{
-			CG_setRGBA(beam.shaderRGBA, cg_teamWeaponColor.string);
+			Vector4Copy(cgs.cvarColors[CC_TEAM_WEAPON], beam.shaderRGBA);
 			/*beam.shaderRGBA[0] = hexToRed( cg_teamWeaponColor.string );
 			beam.shaderRGBA[1] = hexToGreen( cg_teamWeaponColor.string );
 			beam.shaderRGBA[2] = hexToBlue( cg_teamWeaponColor.string );
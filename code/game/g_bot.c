@@ -120,6 +120,175 @@ int G_ParseInfos( char *buf, int max, char *infos[] ) {
 	return count;
 }
 
+/*
+==============================================================================
+
+INFO CACHE
+
+Parsing every .arena and .bot file again on each map change is most of what
+the bots cost at level load.  The parsed infos are kept under cache/ and
+used as long as the same files with the same contents are there.  Hashing
+the files means reading them, but that is cheap next to parsing them.
+Set g_infoCache 0 to always parse.
+
+==============================================================================
+*/
+
+#define	INFO_CACHE_IDENT	( ( 'C' << 24 ) + ( 'F' << 16 ) + ( 'N' << 8 ) + 'I' )
+#define	INFO_CACHE_VERSION	2
+#define	INFO_CACHE_SIZE		131072
+
+typedef struct {
+	int		ident;
+	int		version;
+	int		signature;		// of the source files
+	int		checksum;		// of the data
+	int		count;
+	int		length;
+} infoCacheHeader_t;
+
+/*
+===============
+G_InfoCacheHash
+===============
+*/
+static int G_InfoCacheHash( int hash, const char *data, int length ) {
+	unsigned	h;
+	int			i;
+
+	h = (unsigned)hash;
+	for ( i = 0; i < length; i++ ) {
+		h = ( h ^ (byte)data[i] ) * 16777619u;
+	}
+	return (int)h;
+}
+
+/*
+===============
+G_InfoFileSignature
+
+Adds a source file's name, size and contents to a signature
+===============
+*/
+static int G_InfoFileSignature( int signature, const char *filename ) {
+	fileHandle_t	f;
+	char			buf[4096];
+	int				len, pos, chunk;
+
+	len = trap_FS_FOpenFile( filename, &f, FS_READ );
+	signature = G_InfoCacheHash( signature, filename, strlen( filename ) + 1 );
+	signature = G_InfoCacheHash( signature, (const char *)&len, sizeof( len ) );
+	if ( !f ) {
+		return signature;
+	}
+
+	for ( pos = 0; pos < len; pos += chunk ) {
+		chunk = len - pos;
+		if ( chunk > sizeof( buf ) ) {
+			chunk = sizeof( buf );
+		}
+		trap_FS_Read( buf, chunk, f );
+		signature = G_InfoCacheHash( signature, buf, chunk );
+	}
+	trap_FS_FCloseFile( f );
+
+	return signature;
+}
+
+/*
+===============
+G_ReadInfoCache
+
+Returns the number of infos read, or -1 if the cache is missing or stale
+===============
+*/
+static int G_ReadInfoCache( const char *filename, int signature, int max, char *infos[] ) {
+	static char			data[INFO_CACHE_SIZE];
+	infoCacheHeader_t	header;
+	fileHandle_t		f;
+	char				*s;
+	int					len, count, size;
+
+	if ( !g_infoCache.integer ) {
+		return -1;
+	}
+
+	len = trap_FS_FOpenFile( filename, &f, FS_READ );
+	if ( !f ) {
+		return -1;
+	}
+	if ( len < sizeof( header ) ) {
+		trap_FS_FCloseFile( f );
+		return -1;
+	}
+	trap_FS_Read( &header, sizeof( header ), f );
+	if ( header.ident != INFO_CACHE_IDENT || header.version != INFO_CACHE_VERSION ||
+		header.signature != signature || header.count > max ||
+		header.length <= 0 || header.length > sizeof( data ) || header.length != len - sizeof( header ) ) {
+		trap_FS_FCloseFile( f );
+		return -1;
+	}
+	trap_FS_Read( data, header.length, f );
+	trap_FS_FCloseFile( f );
+
+	if ( data[header.length - 1] || G_InfoCacheHash( 0, data, header.length ) != header.checksum ) {
+		return -1;
+	}
+
+	s = data;
+	for ( count = 0; count < header.count && s < data + header.length; count++ ) {
+		len = strlen( s );
+		// the same room for the arena number as G_ParseInfos leaves
+		size = len + strlen( "\\num\\" ) + strlen( va( "%d", MAX_ARENAS ) ) + 1;
+		if ( !BG_CanAlloc( size ) ) {
+			break;
+		}
+		infos[count] = BG_Alloc( size );
+		strcpy( infos[count], s );
+		s += len + 1;
+	}
+	return count;
+}
+
+/*
+===============
+G_WriteInfoCache
+===============
+*/
+static void G_WriteInfoCache( const char *filename, int signature, int count, char *infos[] ) {
+	infoCacheHeader_t	header;
+	fileHandle_t		f;
+	int					i;
+
+	if ( !g_infoCache.integer ) {
+		return;
+	}
+
+	header.ident = INFO_CACHE_IDENT;
+	header.version = INFO_CACHE_VERSION;
+	header.signature = signature;
+	header.checksum = 0;
+	header.count = count;
+	header.length = 0;
+	for ( i = 0; i < count; i++ ) {
+		header.checksum = G_InfoCacheHash( header.checksum, infos[i], strlen( infos[i] ) + 1 );
+		header.length += strlen( infos[i] ) + 1;
+	}
+	if ( !header.length || header.length > INFO_CACHE_SIZE ) {
+		return;
+	}
+
+	trap_FS_FOpenFile( filename, &f, FS_WRITE );
+	if ( !f ) {
+		return;
+	}
+	trap_FS_Write( &header, sizeof( header ), f );
+	for ( i = 0; i < count; i++ ) {
+		trap_FS_Write( infos[i], strlen( infos[i] ) + 1, f );
+	}
+	trap_FS_FCloseFile( f );
+}
+
 /*
 ===============
 G_LoadArenasFromFile
@@ -156,35 +325,58 @@ G_LoadArenas
 static void G_LoadArenas( void ) {
 	int			numdirs;
 	vmCvar_t	arenasFile;
+	char		arenas[MAX_QPATH];
 	char		filename[128];
 	char		dirlist[1024];
 	char*		dirptr;
 	int			i, n;
 	int			dirlen;
+	int			signature;
+	mapInfo_t	*m;
 
 	g_numArenas = 0;
 
 	trap_Cvar_Register( &arenasFile, "g_arenasFile", "", CVAR_INIT|CVAR_ROM );
 	if( *arenasFile.string ) {
-		G_LoadArenasFromFile(arenasFile.string);
+		Q_strncpyz( arenas, arenasFile.string, sizeof( arenas ) );
 	}
 	else {
-		G_LoadArenasFromFile("scripts/arenas.txt");
+		Q_strncpyz( arenas, "scripts/arenas.txt", sizeof( arenas ) );
 	}
 
-	// get all arenas from .arena files
 	numdirs = trap_FS_GetFileList("scripts", ".arena", dirlist, 1024 );
+
+	signature = G_InfoFileSignature( 0, arenas );
 	dirptr  = dirlist;
 	for (i = 0; i < numdirs; i++, dirptr += dirlen+1) {
 		dirlen = strlen(dirptr);
-		strcpy(filename, "scripts/");
-		strcat(filename, dirptr);
-		G_LoadArenasFromFile(filename);
+		signature = G_InfoFileSignature( signature, va( "scripts/%s", dirptr ) );
+	}
+
+	g_numArenas = G_ReadInfoCache( "cache/arenas.dat", signature, MAX_ARENAS, g_arenaInfos );
+	if( g_numArenas < 0 ) {
+		g_numArenas = 0;
+		G_LoadArenasFromFile(arenas);
+
+		// get all arenas from .arena files
+		dirptr  = dirlist;
+		for (i = 0; i < numdirs; i++, dirptr += dirlen+1) {
+			dirlen = strlen(dirptr);
+			strcpy(filename, "scripts/");
+			strcat(filename, dirptr);
+			G_LoadArenasFromFile(filename);
+		}
+
+		G_WriteInfoCache( "cache/arenas.dat", signature, g_numArenas, g_arenaInfos );
 	}
 	trap_Printf( va( "%i arenas parsed\n", g_numArenas ) );
 	
 	for( n = 0; n < g_numArenas; n++ ) {
 		Info_SetValueForKey( g_arenaInfos[n], "num", va( "%i", n ) );
+		m = G_FindMap( Info_ValueForKey( g_arenaInfos[n], "map" ) );
+		if( m && m->arena < 0 ) {
+			m->arena = n;
+		}
 	}
 }
 
@@ -195,8 +387,15 @@ G_GetArenaInfoByNumber
 ===============
 */
 const char *G_GetArenaInfoByMap( const char *map ) {
+	mapInfo_t	*m;
 	int			n;
 
+	m = G_FindMap( map );
+	if( m ) {
+		return m->arena >= 0 ? g_arenaInfos[m->arena] : NULL;
+	}
+
+	// a map without a .bsp, or one that didn't fit in the catalog
 	for( n = 0; n < g_numArenas; n++ ) {
 		if( Q_stricmp( Info_ValueForKey( g_arenaInfos[n], "map" ), map ) == 0 ) {
 			return g_arenaInfos[n];
@@ -896,11 +1095,13 @@ G_LoadBots
 static void G_LoadBots( void ) {
 	vmCvar_t	botsFile;
 	int			numdirs;
+	char		bots[MAX_QPATH];
 	char		filename[128];
 	char		dirlist[1024];
 	char*		dirptr;
 	int			i;
 	int			dirlen;
+	int			signature;
 
 	if ( !trap_Cvar_VariableIntegerValue( "bot_enable" ) ) {
 		return;
@@ -910,20 +1111,36 @@ static void G_LoadBots( void ) {
 
 	trap_Cvar_Register( &botsFile, "g_botsFile", "", CVAR_INIT|CVAR_ROM );
 	if( *botsFile.string ) {
-		G_LoadBotsFromFile(botsFile.string);
+		Q_strncpyz( bots, botsFile.string, sizeof( bots ) );
 	}
 	else {
-		G_LoadBotsFromFile("scripts/bots.txt");
+		Q_strncpyz( bots, "scripts/bots.txt", sizeof( bots ) );
 	}
 
-	// get all bots from .bot files
 	numdirs = trap_FS_GetFileList("scripts", ".bot", dirlist, 1024 );
+
+	signature = G_InfoFileSignature( 0, bots );
 	dirptr  = dirlist;
 	for (i = 0; i < numdirs; i++, dirptr += dirlen+1) {
 		dirlen = strlen(dirptr);
-		strcpy(filename, "scripts/");
-		strcat(filename, dirptr);
-		G_LoadBotsFromFile(filename);
+		signature = G_InfoFileSignature( signature, va( "scripts/%s", dirptr ) );
+	}
+
+	g_numBots = G_ReadInfoCache( "cache/bots.dat", signature, MAX_BOTS, g_botInfos );
+	if( g_numBots < 0 ) {
+		g_numBots = 0;
+		G_LoadBotsFromFile(bots);
+
+		// get all bots from .bot files
+		dirptr  = dirlist;
+		for (i = 0; i < numdirs; i++, dirptr += dirlen+1) {
+			dirlen = strlen(dirptr);
+			strcpy(filename, "scripts/");
+			strcat(filename, dirptr);
+			G_LoadBotsFromFile(filename);
+		}
+
+		G_WriteInfoCache( "cache/bots.dat", signature, g_numBots, g_botInfos );
 	}
 	trap_Printf( va( "%i bots parsed\n", g_numBots ) );
 }
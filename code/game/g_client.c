@@ -1653,6 +1653,8 @@ Sago: I am not happy with this exception
 
 	// this is not the userinfo, more like the configstring actually
 	G_LogPrintf( "ClientUserinfoChanged: %i %s\\id\\%s\n", clientNum, s, Info_ValueForKey(userinfo, "cl_guid") );
+	G_LogEvent( "userinfo", "isiss", "client", clientNum, "name", client->pers.netname,
+		"team", client->sess.sessionTeam, "model", model, "guid", Info_ValueForKey( userinfo, "cl_guid" ) );
 }
 
 
@@ -1704,7 +1706,7 @@ char *ClientConnect( int clientNum, qboolean firstTime, qboolean isBot ) {
 	value = Info_ValueForKey (userinfo, "ip");
 	Q_strncpyz( client->pers.ip, value, sizeof( client->pers.ip ) );
 	
-	if ( G_FilterPacket( value ) && !Q_stricmp(value,"localhost") ) {
+	if ( Q_stricmp( value, "localhost" ) && G_FilterPacket( value ) ) {
             G_Printf("Player with IP: %s is banned\n",value);
 		return "You are banned from this server.";
 	}
@@ -1780,6 +1782,7 @@ char *ClientConnect( int clientNum, qboolean firstTime, qboolean isBot ) {
 	// get and distribute relevent paramters
 	ClientUserinfoChanged( clientNum );
 	G_LogPrintf( "ClientConnect: %i\n", clientNum );
+	G_LogEvent( "connect", "isi", "client", clientNum, "ip", client->pers.ip, "bot", isBot );
 	
 
 	// don't do the "xxx connected" messages if they were caried over from previous level
@@ -1954,7 +1957,7 @@ void ClientBegin( int clientNum ) {
   // restore what needs to be restored
 
         /*if( client->sess.sessionTeam != TEAM_SPECTATOR )
-            PlayerStore_restore(Info_ValueForKey(userinfo,"cl_guid"),&(client->ps));*/
+            PlayerStore_restore(Info_ValueForKey(userinfo,"cl_guid"),client);*/
 	
 	client->ps.eFlags = flags;
 	for ( i = 0 ; i < MAX_PERSISTANT ; i++ ) {
@@ -1989,6 +1992,7 @@ void ClientBegin( int clientNum ) {
         motd ( ent );
         
 	G_LogPrintf( "ClientBegin: %i\n", clientNum );
+	G_LogEvent( "begin", "ii", "client", clientNum, "team", client->sess.sessionTeam );
 	
 	// log to demo
 	/*Info_SetValueForKey( buffer, "name", client->pers.netname );
@@ -2863,6 +2867,10 @@ void ClientDisconnect( int clientNum ) {
 		level.disconnectedClients[level.disconnectedClientsNumber].pers.enterTime = (level.time - level.disconnectedClients[level.disconnectedClientsNumber].pers.enterTime);
 		level.disconnectedClientsNumber++;
 	}
+	if ( ent->client->pers.connected == CON_CONNECTED ) {
+		G_StatsPlayer( ent->client, qtrue );
+	}
+	G_ClearServerCommands( clientNum );
 
 	// stop any following clients
 	for ( i = 0 ; i < level.maxclients ; i++ ) {
@@ -2913,7 +2921,7 @@ void ClientDisconnect( int clientNum ) {
 
 
         /*if ( ent->client->pers.connected == CON_CONNECTED && ent->client->sess.sessionTeam != TEAM_SPECTATOR)
-            PlayerStore_store(Info_ValueForKey(userinfo,"cl_guid"),ent->client->ps);*/
+            PlayerStore_store(Info_ValueForKey(userinfo,"cl_guid"),ent->client);*/
 	
 	if( ( level.time - ent->client->lastKilledTime ) < 4000 && ( level.time - ent->client->lastKilledTime ) > 750 )
 		trap_SendServerCommand( -1, va("screenPrint \"" S_COLOR_YELLOW "%s" S_COLOR_RED " disconnected in RAGE!\"", ent->client->pers.netname) );
@@ -2921,6 +2929,7 @@ void ClientDisconnect( int clientNum ) {
 		trap_SendServerCommand( -1, va("screenPrint \"" S_COLOR_YELLOW "%s" S_COLOR_YELLOW " disconnected\"", ent->client->pers.netname) );
 	
 	G_LogPrintf( "ClientDisconnect: %i\n", clientNum );
+	G_LogEvent( "disconnect", "i", "client", clientNum );
 
 	// if we are playing in tourney mode and losing, give a win to the other player
 	if ( (g_gametype.integer == GT_TOURNAMENT )
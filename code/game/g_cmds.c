@@ -202,7 +202,12 @@ void DeathmatchScoreboardMessage( gentity_t *ent ) {
 			// This way the scores can be transferred in several packets
 			// if the score data gets too big and there does not need to be
 			// any change in the protocol for now.
-			trap_SendServerCommand( ent-g_entities, va("scores %i %i %i %i%s", i | (start << 8), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
+			// the first part replaces every part of an older scoreboard
+			// still waiting, so the client never gets a mix of the two
+			if ( start == 0 )
+				G_QueueServerCommand( ent-g_entities, SCMD_SCORES, "scores", va("scores %i %i %i %i%s", i | (start << 8), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
+			else
+				G_AppendServerCommand( ent-g_entities, SCMD_SCORES, "scores", va("scores %i %i %i %i%s", i | (start << 8), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
 			start = i;
 			stringlength = 0;
 		}
@@ -211,7 +216,10 @@ void DeathmatchScoreboardMessage( gentity_t *ent ) {
     }
 
 	if(stringlength != 0) {
-		trap_SendServerCommand( ent-g_entities, va("scores %i %i %i %i%s", i | (start << 8) | (1 << 16), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
+		if ( start == 0 )
+			G_QueueServerCommand( ent-g_entities, SCMD_SCORES, "scores", va("scores %i %i %i %i%s", i | (start << 8) | (1 << 16), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
+		else
+			G_AppendServerCommand( ent-g_entities, SCMD_SCORES, "scores", va("scores %i %i %i %i%s", i | (start << 8) | (1 << 16), level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime, string ) );
 	}
 }
 
@@ -332,7 +340,8 @@ void G_SendRespawnTimer( int entityNum, int type, int quantity, int respawnTime,
 	for (i = 0; i < MAX_CLIENTS; i++) {
 		ent = &g_entities[i];
 		if ( ( ent->inuse ) && ( ent->client->sess.sessionTeam == TEAM_SPECTATOR ) ) {
-			trap_SendServerCommand( ent-g_entities, va("respawnTime%s", entry ));
+			// only sent again on the next pickup, so it must not be dropped
+			G_QueueServerCommand( ent-g_entities, SCMD_STATE, va("respawnTime %i", entityNum), va("respawnTime%s", entry ));
 		}
 	}	
 }
@@ -519,8 +528,7 @@ void G_StartServerDemos( void ) {
 			}
 		}
 		playerName[count] = '\0';
-		trap_Cvar_Set(va( "demopath%i", i ), va("%s/%s-POV(%s)", gamestring, matchstring, playerName));
-		//Com_sprintf(level.clients[i].demopath, MAX_QPATH, "%s/%s-POV(%s)", gamestring, matchstring, playerName );
+		Com_sprintf(level.clients[i].sess.demopath, MAX_QPATH, "%s/%s-POV(%s)", gamestring, matchstring, playerName );
 		trap_SendConsoleCommand(EXEC_APPEND, va("svrecord %li %s/%s-POV(%s) \n", &level.clients[i] - level.clients, gamestring, matchstring, playerName ) );
 	}
 }
@@ -578,8 +586,8 @@ EliminationMessage
 */
 
 void EliminationMessage(gentity_t *ent) {
-    trap_SendServerCommand( ent-g_entities, va("elimination %i %i %i",
-                            level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime) );
+    G_QueueServerCommand( ent-g_entities, SCMD_STATE, "elimination", va("elimination %i %i %i",
+                          level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], level.roundStartTime) );
 }
 
 /*
@@ -735,7 +743,7 @@ void SendReadymask( int clientnum ) {
 	level.readyMask = readyMask;
 	Com_sprintf (entry, sizeof(entry), " %i ", readyMask);
 
-	trap_SendServerCommand( clientnum, va("readyMask%s", entry ));
+	G_QueueServerCommand( clientnum, SCMD_STATE, "readyMask", va("readyMask%s", entry ));
 }
 
 /*
@@ -1521,7 +1529,7 @@ int SetTeam( gentity_t *ent, char *s ) {
     }
 
     /*if(oldTeam!=TEAM_SPECTATOR)
-        PlayerStore_store(Info_ValueForKey(userinfo,"cl_guid"),client->ps);*/
+        PlayerStore_store(Info_ValueForKey(userinfo,"cl_guid"),client);*/
 
     // they go to the end of the line for tournements
     if ( team == TEAM_SPECTATOR ) {
@@ -1956,8 +1964,336 @@ static void G_SayTo( gentity_t *ent, gentity_t *other, int mode, int color, cons
 
 #define EC		"\x19"
 
+/*
+==================
+G_SayLocation
+
+The location shown in front of team chat and for #L.  A bind can send
+several messages in one frame, so the lookup is kept for the frame.
+==================
+*/
+static qboolean G_SayLocation( gentity_t *ent, char *loc, int loclen ) {
+    static struct {
+        int         time;
+        int         clientNum;
+        qboolean    found;
+        char        location[64];
+    } cache = { -1, -1 };
+
+    if ( cache.time != level.time || cache.clientNum != ent->s.number ) {
+        cache.time = level.time;
+        cache.clientNum = ent->s.number;
+        cache.location[0] = '\0';
+        cache.found = Team_GetLocationMsg( ent, cache.location, sizeof(cache.location) );
+    }
+
+    Q_strncpyz( loc, cache.found ? cache.location : "", loclen );
+    return cache.found;
+}
+
+/*
+==================
+Team chat macros
+
+Each #<letter> in a team message is replaced by what its function writes
+into out.  A message is expanded in one pass, and each macro is worked out
+at most once per message however often it is used.
+==================
+*/
+
+static void SayMacro_Armor( gentity_t *ent, char *out, int size ) {
+    int armor = ent->client->ps.stats[STAT_ARMOR];
+
+    Com_sprintf( out, size, "%s%i", armor < 50 ? "^1" : armor < 100 ? "^3" : "^2", armor );
+}
+
+static void SayMacro_ArmorValue( gentity_t *ent, char *out, int size ) {
+    Com_sprintf( out, size, "%i", ent->client->ps.stats[STAT_ARMOR] );
+}
+
+static void SayMacro_DeathLocation( gentity_t *ent, char *out, int size ) {
+    if ( ent->client->ps.persistant[PERS_KILLED] && !Team_GetDeathLocationMsg( ent, out, size ) )
+        out[0] = '\0';
+}
+
+static void SayMacro_Drop( gentity_t *ent, char *out, int size ) {
+    Q_strncpyz( out, ent->client->lastDrop, size );
+}
+
+static void SayMacro_ClientName( int clientNum, char *out, int size ) {
+    if ( clientNum != -1 && g_entities[clientNum].client )
+        Q_strncpyz( out, g_entities[clientNum].client->pers.netname, size );
+}
+
+static void SayMacro_Attacker( gentity_t *ent, char *out, int size ) {
+    SayMacro_ClientName( ent->client->lastAttacker, out, size );
+}
+
+static void SayMacro_Killer( gentity_t *ent, char *out, int size ) {
+    SayMacro_ClientName( ent->client->lastKiller, out, size );
+}
+
+static void SayMacro_Target( gentity_t *ent, char *out, int size ) {
+    SayMacro_ClientName( ent->client->lastTarget, out, size );
+}
+
+static void SayMacro_Teammate( gentity_t *ent, char *out, int size ) {
+    SayMacro_ClientName( G_FindNearestTeammate( ent ), out, size );
+}
+
+/*
+==================
+SayMacro_Powerups
+
+The flags and powerups a player carries, each followed by a space
+==================
+*/
+static void SayMacro_Powerups( gclient_t *client, qboolean invis, char *out, int size ) {
+    static const struct {
+        int     powerup;
+        char    *name;
+    } powerups[] = {
+        { PW_BLUEFLAG, "^4FLAG" },
+        { PW_REDFLAG, "^1FLAG" },
+        { PW_NEUTRALFLAG, "^7FLAG" },
+        { PW_INVIS, "^7INVIS" },
+        { PW_QUAD, "^5QUAD" },
+        { PW_REGEN, "^1REGEN" },
+        { PW_FLIGHT, "^2FLIGHT" },
+        { PW_BATTLESUIT, "^2BATTLESUIT" }
+    };
+    int i;
+
+    for ( i = 0 ; i < sizeof(powerups) / sizeof(powerups[0]) ; i++ ) {
+        if ( powerups[i].powerup == PW_INVIS && !invis )
+            continue;
+        if ( client->ps.powerups[powerups[i].powerup] == INT_MAX )
+            Q_strcat( out, size, va( "%s ", powerups[i].name ) );
+    }
+}
+
+/*
+==================
+SayMacro_Enemies
+
+The enemies in view, with the flags and powerups of those carrying any
+==================
+*/
+static void SayMacro_Enemies( gentity_t *ent, char *out, int size ) {
+    gentity_t   *other;
+    trace_t     tr;
+    vec3_t      forward, right, up, muzzle, dist, angles;
+    char        userinfo[MAX_INFO_STRING];
+    char        carried[MAX_SAY_TEXT];
+    float       fov;
+    int         i, enemies;
+
+    enemies = 0;
+
+    AngleVectors (ent->client->ps.viewangles, forward, right, up);
+    CalcMuzzlePoint ( ent, forward, right, up, muzzle );
+
+    trap_GetUserinfo( ent->client->ps.clientNum , userinfo, sizeof(userinfo) );
+    fov = atof( Info_ValueForKey( userinfo, "cg_fov" ) );
+
+    for ( i = 0; i < level.maxclients; i++ ) {
+        other = &g_entities[i];
+
+        if ( !other->inuse || other->s.eType != ET_PLAYER || ent->health <= 0 ||
+                other->client->ps.persistant[PERS_TEAM] == ent->client->ps.persistant[PERS_TEAM] ||
+                other->client->ps.persistant[PERS_TEAM] == TEAM_SPECTATOR ) {
+            continue;
+        }
+
+        trap_Trace(&tr, muzzle, NULL, NULL, other->r.currentOrigin, ENTITYNUM_NONE, MASK_SOLID);
+        if ( tr.fraction != 1.0 )
+            continue;
+
+        VectorSubtract( other->r.currentOrigin, muzzle, dist );
+        vectoangles(dist, angles);
+
+        angles[1] = AngleNormalize180( ent->client->ps.viewangles[1] - angles[1] );
+        angles[0] = AngleNormalize180( ent->client->ps.viewangles[0] - angles[0] );
+
+        if ( angles[1] < -fov/2 || angles[1] > fov/2 || angles[0] < -fov/2 || angles[0] > fov/2 )
+            continue;
+
+        carried[0] = '\0';
+        SayMacro_Powerups( other->client, qfalse, carried, sizeof(carried) );
+        if ( carried[0] ) {
+            Q_strcat( out, size, carried );
+            Q_strcat( out, size, "+ " );
+        } else {
+            enemies++;
+        }
+    }
+
+    if ( enemies == 1 )
+        Q_strcat( out, size, "1 enemy" );
+    else
+        Q_strcat( out, size, va( "%i enemies", enemies ) );
+}
+
+static void SayMacro_Health( gentity_t *ent, char *out, int size ) {
+    Com_sprintf( out, size, "%s%i", ent->health < 25 ? "^1" : ent->health < 75 ? "^3" : "^2", ent->health );
+}
+
+static void SayMacro_HealthValue( gentity_t *ent, char *out, int size ) {
+    Com_sprintf( out, size, "%i", ent->health );
+}
+
+static void SayMacro_Item( gentity_t *ent, char *out, int size ) {
+    int item = G_FindNearestItem( ent );
+
+    if ( item != -1 )
+        Q_strncpyz( out, g_entities[item].item->shortPickup_name, size );
+}
+
+static void SayMacro_ItemSpawn( gentity_t *ent, char *out, int size ) {
+    int item = G_FindNearestItemSpawn( ent );
+
+    if ( item != -1 )
+        Q_strncpyz( out, g_entities[item].item->shortPickup_name, size );
+}
+
+static void SayMacro_Location( gentity_t *ent, char *out, int size ) {
+    G_SayLocation( ent, out, size );
+}
+
+static void SayMacro_Ammo( gentity_t *ent, char *out, int size ) {
+    Com_sprintf( out, size, "%i", ent->client->ps.ammo[ ent->client->ps.weapon ] );
+}
+
+static void SayMacro_Pickup( gentity_t *ent, char *out, int size ) {
+    Q_strncpyz( out, ent->client->lastPickup, size );
+}
+
+static void SayMacro_Sight( gentity_t *ent, char *out, int size ) {
+    trace_t tr;
+    vec3_t  forward, right, up, muzzle, end;
+
+    AngleVectors (ent->client->ps.viewangles, forward, right, up);
+    CalcMuzzlePoint ( ent, forward, right, up, muzzle );
+    VectorMA (muzzle, 8192 * 16, forward, end);
+    trap_Trace (&tr, muzzle, NULL, NULL, end, ent->s.number, MASK_ALL);
+
+    if ( g_entities[tr.entityNum].inuse && g_entities[tr.entityNum].s.eType == ET_ITEM )
+        Q_strncpyz( out, g_entities[tr.entityNum].item->shortPickup_name, size );
+}
+
+static void SayMacro_Carried( gentity_t *ent, char *out, int size ) {
+    SayMacro_Powerups( ent->client, qtrue, out, size );
+}
+
+static void SayMacro_Weapon( gentity_t *ent, char *out, int size ) {
+    switch ( ent->client->ps.weapon ) {
+    case WP_GAUNTLET:
+        Q_strncpyz( out, "^5Gaunt", size );
+        break;
+    case WP_MACHINEGUN:
+        Q_strncpyz( out, "^3MG^5", size );
+        break;
+    case WP_SHOTGUN:
+        Q_strncpyz( out, "^3SG^5", size );
+        break;
+    case WP_GRENADE_LAUNCHER:
+        Q_strncpyz( out, "^2GL^5", size );
+        break;
+    case WP_ROCKET_LAUNCHER:
+        Q_strncpyz( out, "^1RL^5", size );
+        break;
+    case WP_LIGHTNING:
+        Q_strncpyz( out, "^7LG^5", size );
+        break;
+    case WP_RAILGUN:
+        Q_strncpyz( out, "^2RG^5", size );
+        break;
+    case WP_PLASMAGUN:
+        Q_strncpyz( out, "^6PG^5", size );
+        break;
+    case WP_BFG:
+        Q_strncpyz( out, "^5BFG", size );
+        break;
+    default:
+        break;
+    }
+}
+
+static const struct {
+    char    letter;
+    void    (*func)( gentity_t *ent, char *out, int size );
+} sayMacros[] = {
+    { 'A', SayMacro_Armor },
+    { 'a', SayMacro_ArmorValue },
+    { 'C', SayMacro_DeathLocation },
+    { 'd', SayMacro_Drop },
+    { 'D', SayMacro_Attacker },
+    { 'E', SayMacro_Enemies },
+    { 'F', SayMacro_Teammate },
+    { 'H', SayMacro_Health },
+    { 'h', SayMacro_HealthValue },
+    { 'I', SayMacro_Item },
+    { 'K', SayMacro_Killer },
+    { 'l', SayMacro_ItemSpawn },
+    { 'L', SayMacro_Location },
+    { 'M', SayMacro_Ammo },
+    { 'P', SayMacro_Pickup },
+    { 'S', SayMacro_Sight },
+    { 'T', SayMacro_Target },
+    { 'U', SayMacro_Carried },
+    { 'W', SayMacro_Weapon }
+};
+
+#define NUM_SAY_MACROS	( sizeof(sayMacros) / sizeof(sayMacros[0]) )
+
+/*
+==================
+G_ExpandSayMacros
+
+Copies in to out with the team chat macros replaced.  The replacements are
+not expanded again, and neither the message nor the replacements are ever
+used as a format string.
+==================
+*/
+static void G_ExpandSayMacros( gentity_t *ent, const char *in, char *out, int size ) {
+    char    values[NUM_SAY_MACROS][MAX_SAY_TEXT];
+    int     done[NUM_SAY_MACROS];
+    int     i, len;
+    const char *value;
+
+    memset( done, 0, sizeof(done) );
+    len = 0;
+
+    while ( *in && len < size - 1 ) {
+        if ( in[0] == '#' && in[1] ) {
+            for ( i = 0 ; i < NUM_SAY_MACROS ; i++ ) {
+                if ( sayMacros[i].letter == in[1] )
+                    break;
+            }
+            if ( i < NUM_SAY_MACROS ) {
+                if ( !done[i] ) {
+                    values[i][0] = '\0';
+                    sayMacros[i].func( ent, values[i], sizeof(values[i]) );
+                    done[i] = qtrue;
+                }
+                for ( value = values[i] ; *value && len < size - 1 ; value++ )
+                    out[len++] = *value;
+                in += 2;
+                continue;
+            }
+        }
+        out[len++] = *in++;
+    }
+
+    out[len] = '\0';
+}
+
+/*
+==================
+G_Say
+==================
+*/
 void G_Say( gentity_t *ent, gentity_t *target, int mode, const char *chatText ) {
-    int 		counter;
     int			j;
     gentity_t	*other;
     int			color;
@@ -1965,15 +2301,6 @@ void G_Say( gentity_t *ent, gentity_t *target, int mode, const char *chatText )
     // don't let text be too long for malicious reasons
     char		text[MAX_SAY_TEXT];
     char		location[64];
-    trace_t		tr;
-    vec3_t		end, forward, right, up, muzzle;
-    int		count;
-    int 		enemies;
-    qboolean	powerup;
-    char	userinfo[MAX_INFO_STRING];
-    float		fov;
-    vec3_t		angles;
-    vec3_t		dist;
 
     if ((ent->r.svFlags & SVF_BOT) && trap_Cvar_VariableValue( "bot_nochat" )>1) return;
 
@@ -1991,13 +2318,15 @@ void G_Say( gentity_t *ent, gentity_t *target, int mode, const char *chatText )
     default:
     case SAY_ALL:
         G_LogPrintf( "say: %s: %s\n", ent->client->pers.netname, chatText );
+        G_LogEvent( "say", "is", "client", ent->s.number, "text", chatText );
         Com_sprintf (name, sizeof(name), "%s%c%c"EC": ", ent->client->pers.netname, Q_COLOR_ESCAPE, COLOR_WHITE );
         color = COLOR_GREEN;
         //G_DemoCommand( DC_SERVER_COMMAND, va( "chat \"%s^2%s\"", name, chatText ) );
         break;
     case SAY_TEAM:
         G_LogPrintf( "sayteam: %s: %s\n", ent->client->pers.netname, chatText );
-        if (Team_GetLocationMsg(ent, location, sizeof(location)))
+        G_LogEvent( "sayteam", "is", "client", ent->s.number, "text", chatText );
+        if (G_SayLocation(ent, location, sizeof(location)))
             Com_sprintf (name, sizeof(name), EC"(%s%c%c"EC") (%s)"EC": ",
                          ent->client->pers.netname, Q_COLOR_ESCAPE, COLOR_WHITE, location);
         else
@@ -2009,7 +2338,7 @@ void G_Say( gentity_t *ent, gentity_t *target, int mode, const char *chatText )
     case SAY_TELL:
         if (target && g_gametype.integer >= GT_TEAM && g_ffa_gt != 1 &&
                 target->client->sess.sessionTeam == ent->client->sess.sessionTeam &&
-                Team_GetLocationMsg(ent, location, sizeof(location)))
+                G_SayLocation(ent, location, sizeof(location)))
             Com_sprintf (name, sizeof(name), EC"[%s%c%c"EC"] (%s)"EC": ", ent->client->pers.netname, Q_COLOR_ESCAPE, COLOR_WHITE, location );
         else
             Com_sprintf (name, sizeof(name), EC"[%s%c%c"EC"]"EC": ", ent->client->pers.netname, Q_COLOR_ESCAPE, COLOR_WHITE );
@@ -2017,293 +2346,10 @@ void G_Say( gentity_t *ent, gentity_t *target, int mode, const char *chatText )
         break;
     }
 
-    Q_strncpyz( text, chatText, sizeof(text) );
-
-
     if ( mode == SAY_TEAM  && ent->client->ps.persistant[PERS_TEAM] != TEAM_SPECTATOR ) {
-        for ( counter = 0 ; counter < MAX_SAY_TEXT ; counter++ ) {
-            if ( ( text[counter] == '#' ) && ( counter < MAX_SAY_TEXT - 1 ) ) {
-
-                if ( text[counter + 1] == 'A' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( ent->client->ps.stats[STAT_ARMOR] < 50 )
-                        Com_sprintf( text, sizeof(text), text, va("^1%i",ent->client->ps.stats[STAT_ARMOR]) );
-                    else if ( ent->client->ps.stats[STAT_ARMOR] < 100 )
-                        Com_sprintf( text, sizeof(text), text, va("^3%i",ent->client->ps.stats[STAT_ARMOR]) );
-                    else
-                        Com_sprintf( text, sizeof(text), text, va("^2%i",ent->client->ps.stats[STAT_ARMOR]) );
-                }
-                else if ( text[counter + 1] == 'a' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 'i';
-                    Com_sprintf( text, sizeof(text), text, ent->client->ps.stats[STAT_ARMOR] );
-                }
-                else if ( text[counter + 1] == 'C' ) {
-
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( ent->client->ps.persistant[PERS_KILLED] ) {
-                        Team_GetDeathLocationMsg(ent, location, sizeof(location));
-                        Com_sprintf( text, sizeof(text), text, location );
-                    }
-                    else
-                        Com_sprintf( text, sizeof(text), text, "");
-                }
-                else if ( text[counter + 1] == 'd' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    Com_sprintf( text, sizeof(text), text, ent->client->lastDrop );
-                }
-                else if ( text[counter + 1] == 'D' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    if ( ent->client->lastAttacker != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[ent->client->lastAttacker].client->pers.netname );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "");
-
-                }
-                else if ( text[counter + 1] == 'E' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    enemies = 0;
-
-                    AngleVectors (ent->client->ps.viewangles, forward, right, up);
-                    CalcMuzzlePoint ( ent, forward, right, up, muzzle );
-
-                    trap_GetUserinfo( ent->client->ps.clientNum , userinfo, sizeof(userinfo) );
-                    fov = atof( Info_ValueForKey( userinfo, "cg_fov" ) );
-
-                    for ( count = 0; count < MAX_GENTITIES; count++ ) {
-
-                        if ( g_entities[count].inuse && g_entities[count].s.eType == ET_PLAYER &&
-                                ( g_entities[count].client->ps.persistant[PERS_TEAM] != ent->client->ps.persistant[PERS_TEAM] ) && ( ent->health > 0 ) &&
-                                g_entities[count].client->ps.persistant[PERS_TEAM] != TEAM_SPECTATOR ) {
-
-                            trap_Trace(&tr, muzzle, NULL, NULL, g_entities[count].r.currentOrigin, ENTITYNUM_NONE, MASK_SOLID);
-
-                            dist[0] = g_entities[count].r.currentOrigin[0]-muzzle[0];
-                            dist[1] = g_entities[count].r.currentOrigin[1]-muzzle[1];
-                            dist[2] = g_entities[count].r.currentOrigin[2]-muzzle[2];
-
-                            vectoangles(dist, angles);
-
-                            //G_Printf(" %f   %f   %f\n", angles[0], angles[1], angles[2]);
-
-                            angles[1] = ent->client->ps.viewangles[1] - angles[1];
-
-                            if ( angles[1] < -180 )
-                                angles[1] += 360;
-                            if ( angles[1] > 180 )
-                                angles[1] -= 360;
-
-                            angles[0] = ent->client->ps.viewangles[0] - angles[0];
-
-                            if ( angles[0] < -180 )
-                                angles[0] += 360;
-                            if ( angles[0] > 180 )
-                                angles[0] -= 360;
-
-                            //G_Printf("angle %f   %f\n", angles[1], angles[0] );
-
-                            if ( tr.fraction == 1.0 && ( angles[1] >= -fov/2 && angles[1] <= fov/2) && ( angles[0] >= -fov/2 && angles[0] <= fov/2) ) {
-                                powerup = qfalse;
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_BLUEFLAG] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^4FLAG", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_REDFLAG] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^1FLAG", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_NEUTRALFLAG] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^7FLAG", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                /*if( g_entities[tr.entityNum].client->ps.powerups[PW_INVIS] == INT_MAX )
-                                	Com_sprintf( text, sizeof(text), text, va("%s %s", "^7INVIS", "%s" ));*/
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_QUAD] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^5QUAD", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_REGEN] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^1REGEN", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_FLIGHT] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^2FLIGHT", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( g_entities[tr.entityNum].client->ps.powerups[PW_BATTLESUIT] == INT_MAX ) {
-                                    Com_sprintf( text, sizeof(text), text, va("%s %s", "^2BATTLESUIT", "%s" ));
-                                    powerup = qtrue;
-                                }
-                                if ( !powerup )
-                                    enemies++;
-                                else
-                                    Com_sprintf( text, sizeof(text), text, va("+ %s","%s"));
-                            }
-                        }
-                    }
-                    if ( enemies == 0 )
-                        Com_sprintf( text, sizeof(text), text, "0 enemies");
-                    else if ( enemies == 1 )
-                        Com_sprintf( text, sizeof(text), text, "1 enemy");
-                    else
-                        Com_sprintf( text, sizeof(text), text, va("%i enemies", enemies ));
-                }
-                else if ( text[counter + 1] == 'F' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( G_FindNearestTeammate( ent ) != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[G_FindNearestTeammate( ent )].client->pers.netname );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "" );
-                }
-                else if ( text[counter + 1] == 'H' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( ent->health < 25 )
-                        Com_sprintf( text, sizeof(text), text, va("^1%i",ent->health) );
-                    else if ( ent->health < 75 )
-                        Com_sprintf( text, sizeof(text), text, va("^3%i",ent->health) );
-                    else
-                        Com_sprintf( text, sizeof(text), text, va("^2%i",ent->health) );
-                }
-                else if ( text[counter + 1] == 'h' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 'i';
-                    Com_sprintf( text, sizeof(text), text, ent->health );
-                }
-                else if ( text[counter + 1] == 'I' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( G_FindNearestItem( ent ) != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[G_FindNearestItem( ent )].item->shortPickup_name );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "" );
-                }
-                else if ( text[counter + 1] == 'K' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    if ( ent->client->lastKiller != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[ent->client->lastKiller].client->pers.netname );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "");
-
-                }
-                else if ( text[counter + 1] == 'l' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    if ( G_FindNearestItemSpawn( ent ) != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[G_FindNearestItemSpawn( ent )].item->shortPickup_name );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "" );
-                }
-                else if ( text[counter + 1] == 'L' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    Team_GetLocationMsg(ent, location, sizeof(location));
-                    Com_sprintf( text, sizeof(text), text, location );
-                }
-                else if ( text[counter + 1] == 'M' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 'i';
-                    Com_sprintf( text, sizeof(text), text, ent->client->ps.ammo[ ent->client->ps.weapon ] );
-                }
-                else if ( text[counter + 1] == 'P' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    Com_sprintf( text, sizeof(text), text, ent->client->lastPickup );
-                }
-                else if ( text[counter + 1] == 'S' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    AngleVectors (ent->client->ps.viewangles, forward, right, up);
-                    CalcMuzzlePoint ( ent, forward, right, up, muzzle );
-                    VectorMA (muzzle, 8192 * 16, forward, end);
-                    trap_Trace (&tr, muzzle, NULL, NULL, end, ent->s.number, MASK_ALL);
-
-                    if ( g_entities[tr.entityNum].inuse && g_entities[tr.entityNum].s.eType == ET_ITEM )
-                        Com_sprintf( text, sizeof(text), text, g_entities[tr.entityNum].item->shortPickup_name );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "" );
-                }
-                else if ( text[counter + 1] == 'T' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    if ( ent->client->lastTarget != -1 )
-                        Com_sprintf( text, sizeof(text), text, g_entities[ent->client->lastTarget].client->pers.netname );
-                    else
-                        Com_sprintf( text, sizeof(text), text, "");
-
-                }
-                else if ( text[counter + 1] == 'U' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-
-                    if ( ent->client->ps.powerups[PW_BLUEFLAG] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^4FLAG", "%s" ));
-                    if ( ent->client->ps.powerups[PW_REDFLAG] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^1FLAG", "%s" ));
-                    if ( ent->client->ps.powerups[PW_NEUTRALFLAG] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^7FLAG", "%s" ));
-                    if ( ent->client->ps.powerups[PW_INVIS] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^7INVIS", "%s" ));
-                    if ( ent->client->ps.powerups[PW_QUAD] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^5QUAD", "%s" ));
-                    if ( ent->client->ps.powerups[PW_REGEN] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^1REGEN", "%s" ));
-                    if ( ent->client->ps.powerups[PW_FLIGHT] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^2FLIGHT", "%s" ));
-                    if ( ent->client->ps.powerups[PW_BATTLESUIT] == INT_MAX )
-                        Com_sprintf( text, sizeof(text), text, va("%s %s", "^2BATTLESUIT", "%s" ));
-                    Com_sprintf( text, sizeof(text), text, "");
-
-                }
-                else if ( text[counter + 1] == 'W' ) {
-                    text[counter] = '%';
-                    text[counter + 1] = 's';
-                    switch ( ent->client->ps.weapon ) {
-                    case WP_GAUNTLET:
-                        Com_sprintf( text, sizeof(text), text, "^5Gaunt" );
-                        break;
-                    case WP_MACHINEGUN:
-                        Com_sprintf( text, sizeof(text), text, "^3MG^5" );
-                        break;
-                    case WP_SHOTGUN:
-                        Com_sprintf( text, sizeof(text), text, "^3SG^5" );
-                        break;
-                    case WP_GRENADE_LAUNCHER:
-                        Com_sprintf( text, sizeof(text), text, "^2GL^5" );
-                        break;
-                    case WP_ROCKET_LAUNCHER:
-                        Com_sprintf( text, sizeof(text), text, "^1RL^5" );
-                        break;
-                    case WP_LIGHTNING:
-                        Com_sprintf( text, sizeof(text), text, "^7LG^5" );
-                        break;
-                    case WP_RAILGUN:
-                        Com_sprintf( text, sizeof(text), text, "^2RG^5" );
-                        break;
-                    case WP_PLASMAGUN:
-                        Com_sprintf( text, sizeof(text), text, "^6PG^5" );
-                        break;
-                    case WP_BFG:
-                        Com_sprintf( text, sizeof(text), text, "^5BFG" );
-                        break;
-                    default:
-                        Com_sprintf( text, sizeof(text), text, "" );
-                    }
-                }
-            }
-        }
+        G_ExpandSayMacros( ent, chatText, text, sizeof(text) );
+    } else {
+        Q_strncpyz( text, chatText, sizeof(text) );
     }
 
     if ( target ) {
@@ -2410,6 +2456,7 @@ static void Cmd_Tell_f( gentity_t *ent ) {
     p = ConcatArgs( 2 );
 
     G_LogPrintf( "tell: %s to %s: %s\n", ent->client->pers.netname, target->client->pers.netname, p );
+    G_LogEvent( "tell", "iis", "client", ent->s.number, "target", target->s.number, "text", p );
     G_Say( ent, target, SAY_TELL, p );
     // don't tell to the player self if it was already directed to this player
     // also don't send the chat back to a bot
@@ -2864,6 +2911,7 @@ void Cmd_Ref_f( gentity_t *ent ) {
 
         if (!allowedMap(arg2)) {
             trap_SendServerCommand( ent-g_entities, "print \"Map is not available.\n\"" );
+            G_SuggestMaps( ent, arg2 );
             return;
         }
 
@@ -3353,6 +3401,7 @@ void Cmd_CallVote_f( gentity_t *ent ) {
         else {
             if (!allowedMap(arg3)) {
                 trap_SendServerCommand( ent-g_entities, "print \"Map is not available.\n\"" );
+                G_SuggestMaps( ent, arg3 );
                 mapAllowed = qfalse;
             }
         }
@@ -3393,6 +3442,7 @@ void Cmd_CallVote_f( gentity_t *ent ) {
         else {
             if (!allowedMap(arg2)) {
                 trap_SendServerCommand( ent-g_entities, "print \"Map is not available.\n\"" );
+                G_SuggestMaps( ent, arg2 );
                 return;
             }
         }
@@ -533,6 +533,7 @@ void player_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 	G_LogPrintf("Kill: %i %i %i: %s killed %s by %s\n", 
 		killer, self->s.number, meansOfDeath, killerName, 
 		self->client->pers.netname, obit );
+	G_LogEvent( "kill", "iis", "attacker", killer, "target", self->s.number, "mod", obit );
 
 	// broadcast the death event to everyone
 	ent = G_TempEntity( self->r.currentOrigin, EV_OBITUARY );
@@ -578,6 +579,7 @@ void player_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 				// play humiliation on player
 				attacker->client->ps.persistant[PERS_GAUNTLET_FRAG_COUNT]++;
                                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 0, attacker->client->pers.netname, "GAUNTLET" );
+                                G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "GAUNTLET" );
 
 				// add the sprite over the player's head
 				attacker->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
@@ -788,6 +790,7 @@ void player_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 				} // play excellent on player
 				attacker->client->ps.persistant[PERS_EXCELLENT_COUNT]++;
                                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 1, attacker->client->pers.netname, "EXCELLENT" );
+                                G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "EXCELLENT" );
                                 if(!level.hadBots) //There has not been any bots
                                     ChallengeMessage(attacker,AWARD_EXCELLENT);
 				// add the sprite over the player's head
@@ -531,6 +531,7 @@ void Touch_Item (gentity_t *ent, gentity_t *other, trace_t *trace) {
 	
 
 	G_LogPrintf( "Item: %i %s\n", other->s.number, ent->item->classname );
+	G_LogEvent( "item", "is", "client", other->s.number, "item", ent->item->classname );
 
 	predict = other->client->pers.predictItemPickup;
 
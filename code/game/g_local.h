@@ -247,9 +247,10 @@ typedef struct {
 #define	FOLLOW_ACTIVE2	-2
 
 // client data that stays across multiple levels or tournament restarts
-// this is achieved by writing all the data to cvar strings at game shutdown
-// time and reading them back at connection time.  Anything added here
-// MUST be dealt with in G_InitSessionData() / G_ReadSessionData() / G_WriteSessionData()
+// this is achieved by writing all the data to the session file at game
+// shutdown time and reading it back at connection time.  The struct is
+// saved as it is, so anything added here only needs a starting value in
+// G_InitSessionData()
 typedef struct {
 	team_t		sessionTeam;
 	int			spectatorTime;		// for determining next-in-line to play
@@ -258,6 +259,7 @@ typedef struct {
 	int			wins, losses;		// tournament stats
 	qboolean	teamLeader;			// true when this client is a team leader
 	int			specOnly;
+	char		demopath[MAX_QPATH];	// server demo of the current match
 } clientSession_t;
 
 //
@@ -429,6 +431,9 @@ struct gclient_s {
 
 	gentity_t	*locPing;		    // location ping
 
+	int			teamInfoVersion;	// team overlay last sent, 0 to send it again
+	int			teamInfoTime;		// level.time it was sent
+
 	int			switchTeamTime;		// time the player switched teams
 
 	// timeResidual is used to handle events that happen every second
@@ -553,6 +558,8 @@ typedef struct {
 	int			warmupTime;			// restart match at this time
 
 	fileHandle_t	logFile;
+	fileHandle_t	eventLogFile;	// g_logevents
+	fileHandle_t	statsFile;		// g_statsFormat 1 stream for this match
 
 	// store latched cvars here that we want to get at often
 	int			maxclients;
@@ -818,6 +825,20 @@ qboolean G_CheckDeniedReward( gentity_t *attacker, gentity_t *other );
 int G_ModelIndex( char *name );
 int		G_SoundIndex( char *name );
 void	G_TeamCommand( team_t team, char *cmd );
+
+// classes of queued server commands, sent in this order
+typedef enum {
+	SCMD_STATE,		// game state, like elimination rounds, the readymask and item timers
+	SCMD_SCORES,
+	SCMD_INFO,		// only what is sent again anyway, may be dropped if the queue is full
+	SCMD_NUM_CLASSES
+} scmdClass_t;
+
+void	G_QueueServerCommand( int clientNum, scmdClass_t cls, const char *key, const char *cmd );
+void	G_AppendServerCommand( int clientNum, scmdClass_t cls, const char *key, const char *cmd );
+void	G_ClearServerCommands( int clientNum );
+void	G_FlushServerCommands( void );
+void	Svcmd_CommandStats_f( void );
 void	G_KillBox (gentity_t *ent);
 gentity_t *G_Find (gentity_t *from, int fieldofs, const char *match);
 gentity_t *G_PickTarget (char *targetname);
@@ -987,6 +1008,7 @@ char *Com_SHA256String( const char *in );
 qboolean	ConsoleCommand( void );
 void G_ProcessIPBans(void);
 qboolean G_FilterPacket (char *from);
+void Svcmd_ListIP_f( void );
 void G_RegisterOAXcommands( void );
 
 //KK-OAX Added this to make accessible from g_svcmds_ext.c
@@ -1033,7 +1055,14 @@ void FindIntermissionPoint( void );
 void SetLeader(int team, int client);
 void CheckTeamLeader( int team );
 void G_RunThink (gentity_t *ent);
+void G_LogOpen( void );
+void G_LogFlush( void );
+void G_LogClose( void );
+void G_LogOpenStats( const char *filename );
+void G_LogCloseStats( void );
 void QDECL G_LogPrintf( const char *fmt, ... );
+void QDECL G_LogEvent( const char *event, const char *fields, ... );
+void Svcmd_LogStats_f( void );
 void SendScoreboardMessageToAllClients( void );
 void SendEliminationMessageToAllClients( void );
 void SendDDtimetakenMessageToAllClients( void );
@@ -1093,6 +1122,9 @@ void Svcmd_GameMem_f( void );
 // g_serverstats.c
 //
 void G_WriteXMLStats( void );
+void G_StatsBegin( qboolean newGameString );
+void G_StatsPlayer( gclient_t *cl, qboolean disconnected );
+void G_WriteStatsTrailer( void );
 void G_SetGameString( void );
 
 //
@@ -1108,7 +1140,7 @@ void G_ReadSessionDataRestart( gclient_t *client );
 void G_InitSessionData( gclient_t *client, char *userinfo );
 
 void G_InitWorldSession( void );
-void G_WriteSessionData( void );
+void G_WriteSessionData( qboolean restart );
 
 //
 // g_arenas.c
@@ -1135,8 +1167,10 @@ void BotInterbreedEndMatch( void );
 //
 
 void PlayerStoreInit( void );
-void PlayerStore_store(char* guid, playerState_t ps);
-void PlayerStore_restore(char* guid, playerState_t *ps);
+void PlayerStore_store(char* guid, gclient_t *client);
+void PlayerStore_restore(char* guid, gclient_t *client);
+void PlayerStore_write(fileHandle_t f);
+void PlayerStore_read(fileHandle_t f, int len);
 
 //
 // g_vote.c
@@ -1192,6 +1226,28 @@ typedef struct {
 
 extern char custom_vote_info[4096];
 
+// map catalog flags
+#define MAPF_BSP		0x0001	// maps/<name>.bsp is on the server
+#define MAPF_VOTEMAPS	0x0002	// listed in votemaps.cfg
+#define MAPF_CYCLE		0x0004	// in the mapcycle
+#define MAPF_ALLOWED	0x0008	// in the mapcycle's allowed list
+
+typedef struct {
+	char	name[MAX_QPATH];
+	int		flags;
+	int		minplayers;		// mapcycle player bounds
+	int		maxplayers;
+	int		arena;			// index of its arena info, -1 if none
+	int		hashNext;		// next map + 1 with the same hash
+} mapInfo_t;
+
+void G_BuildMapCatalog( void );
+mapInfo_t *G_FindMap( const char *name );
+qboolean G_MapExists( const char *name );
+void G_ClearMapFlags( int flags );
+int G_FindMapsByPrefix( const char *prefix, int flags, mapInfo_t **list, int max );
+void G_SuggestMaps( gentity_t *ent, const char *prefix );
+
 extern t_mappage getMappage(int page);
 extern int allowedMap(char *mapname);
 extern int allowedGametype(char *gametypeStr);
@@ -1260,6 +1316,10 @@ extern	vmCvar_t	g_debugDamage;
 extern	vmCvar_t	g_weaponRespawn;
 extern	vmCvar_t	g_weaponTeamRespawn;
 extern	vmCvar_t	g_synchronousClients;
+extern	vmCvar_t	g_randomSeed;
+extern	vmCvar_t	g_profileInit;
+extern	vmCvar_t	g_infoCache;
+extern	vmCvar_t	g_commandBudget;
 extern	vmCvar_t	g_motd;
 extern  vmCvar_t	g_minigame;
 extern	vmCvar_t	g_warmup;
@@ -1269,6 +1329,7 @@ extern	vmCvar_t	g_allowVote;
 extern	vmCvar_t	g_teamAutoJoin;
 extern	vmCvar_t	g_teamForceBalance;
 extern	vmCvar_t	g_banIPs;
+extern	vmCvar_t	g_banIPFile;
 extern	vmCvar_t	g_filterBan;
 extern	vmCvar_t	g_obeliskHealth;
 extern	vmCvar_t	g_obeliskRegenPeriod;
@@ -1410,6 +1471,7 @@ extern vmCvar_t	    g_itemDrop;
 
 extern vmCvar_t	    g_writeStats;
 extern vmCvar_t	    g_statsPath;
+extern vmCvar_t	    g_statsFormat;
 
 extern vmCvar_t	    g_teamLock;
 extern vmCvar_t     g_redLocked;
@@ -1791,7 +1853,6 @@ void Svcmd_BannerPrint_f( void );
 void Svcmd_EjectClient_f( void );
 void Svcmd_DumpUser_f( void );
 void Svcmd_Chat_f( void );
-void Svcmd_ListIP_f( void );
 void Svcmd_MessageWrapper( void );
 
 #include "g_killspree.h"
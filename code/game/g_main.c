@@ -69,12 +69,17 @@ vmCvar_t	g_weaponRespawn;
 vmCvar_t	g_weaponTeamRespawn;
 vmCvar_t	g_motd;
 vmCvar_t	g_synchronousClients;
+vmCvar_t	g_randomSeed;
+vmCvar_t	g_profileInit;
+vmCvar_t	g_infoCache;
+vmCvar_t	g_commandBudget;
 vmCvar_t	g_minigame;
 vmCvar_t	g_warmup;
 vmCvar_t	g_doWarmup;
 vmCvar_t	g_restarted;
 vmCvar_t	g_logfile;
 vmCvar_t	g_logfileSync;
+vmCvar_t	g_logEvents;
 vmCvar_t	g_gibs;
 vmCvar_t	g_podiumDist;
 vmCvar_t	g_podiumDrop;
@@ -82,6 +87,7 @@ vmCvar_t	g_allowVote;
 vmCvar_t	g_teamAutoJoin;
 vmCvar_t	g_teamForceBalance;
 vmCvar_t	g_banIPs;
+vmCvar_t	g_banIPFile;
 vmCvar_t	g_filterBan;
 vmCvar_t	g_smoothClients;
 vmCvar_t	pmove_fixed;
@@ -223,6 +229,7 @@ vmCvar_t     g_itemDrop;
 
 vmCvar_t     g_writeStats;
 vmCvar_t     g_statsPath;
+vmCvar_t     g_statsFormat;
 
 vmCvar_t     g_teamLock;
 vmCvar_t     g_redLocked;
@@ -392,6 +399,10 @@ static cvarTable_t		gameCvarTable[] = {
 	{ &g_capturelimit, "capturelimit", "8", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue },
 
 	{ &g_synchronousClients, "g_synchronousClients", "0", CVAR_SYSTEMINFO, 0, qfalse  },
+	{ &g_randomSeed, "g_randomSeed", "0", 0, 0, qfalse  },
+	{ &g_profileInit, "g_profileInit", "0", 0, 0, qfalse  },
+	{ &g_infoCache, "g_infoCache", "1", CVAR_ARCHIVE, 0, qfalse  },
+	{ &g_commandBudget, "g_commandBudget", "4000", CVAR_ARCHIVE, 0, qfalse  },
 
 	{ &g_friendlyFire, "g_friendlyFire", "0", CVAR_ARCHIVE, 0, qtrue  },
 
@@ -403,10 +414,12 @@ static cvarTable_t		gameCvarTable[] = {
 	{ &g_doWarmup, "g_doWarmup", "1", CVAR_CHEAT | CVAR_SERVERINFO | CVAR_ARCHIVE, 0, qtrue  },
 	{ &g_logfile, "g_log", "games.log", CVAR_ARCHIVE, 0, qfalse  },
 	{ &g_logfileSync, "g_logsync", "0", CVAR_ARCHIVE, 0, qfalse  },
+	{ &g_logEvents, "g_logevents", "", CVAR_ARCHIVE, 0, qfalse  },
 
 	{ &g_password, "g_password", "", CVAR_USERINFO, 0, qfalse  },
 
 	{ &g_banIPs, "g_banIPs", "", CVAR_ARCHIVE, 0, qfalse  },
+	{ &g_banIPFile, "g_banIPFile", "banip.dat", CVAR_ARCHIVE, 0, qfalse  },
 	{ &g_filterBan, "g_filterBan", "1", CVAR_ARCHIVE, 0, qfalse  },
 
 	{ &g_needpass, "g_needpass", "0", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse },
@@ -592,6 +605,7 @@ static cvarTable_t		gameCvarTable[] = {
 	
 	{ &g_writeStats, "g_writeStats", "1", CVAR_ARCHIVE | CVAR_NORESTART, 0, qfalse },
 	{ &g_statsPath, "g_statsPath", "serverstats", CVAR_ARCHIVE | CVAR_NORESTART, 0, qfalse },
+	{ &g_statsFormat, "g_statsFormat", "0", CVAR_ARCHIVE, 0, qfalse },
 	
 	{ &g_teamLock, "g_teamLock", "0", CVAR_SERVERINFO |CVAR_NORESTART, 0, qfalse },
 	{ &g_redLocked, "g_redLocked", "0", CVAR_SERVERINFO | CVAR_NORESTART, 0, qfalse },
@@ -1075,6 +1089,31 @@ void G_UpdateWeaponProperties(void) {
 	wp_railRate = g_railRate.integer;
 	wp_bfgRate = g_bfgRate.integer;
 }
+static int	initStartTime;
+static int	initStepTime;
+
+/*
+============
+G_InitProfile
+
+With g_profileInit set, prints how long each step of G_InitGame took.
+Called with NULL to start timing.
+============
+*/
+static void G_InitProfile( const char *step ) {
+	int		now;
+
+	now = trap_Milliseconds();
+	if ( !step ) {
+		initStartTime = initStepTime = now;
+		return;
+	}
+	if ( g_profileInit.integer ) {
+		G_Printf( "init: %-16s %5i ms\n", step, now - initStepTime );
+	}
+	initStepTime = now;
+}
+
 /*
 ============
 G_InitGame
@@ -1083,6 +1122,7 @@ G_InitGame
 */
 void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	int					i;
+	qboolean			warmupEnded;
 	char 		mapname[64];
 	char 		mapfile[MAX_QPATH];
 	char 		lastmap[64];
@@ -1095,19 +1135,24 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
         G_Printf ("gamename: %s\n", GAMEVERSION);
         G_Printf ("gamedate: %s\n", __DATE__);
 
+	G_InitProfile( NULL );
+
 	srand( randomSeed );
 
 	G_RegisterCvars();
 	G_RegisterOAXcommands();
+	G_InitProfile( "cvars" );
+
+	// a fixed seed makes benchmark and profiling runs repeatable
+	if ( g_randomSeed.integer ) {
+		srand( g_randomSeed.integer );
+	}
 
     G_UpdateTimestamp();
 	
 	if( restart == 0 ){
 		trap_Cvar_Set("g_redLocked","0");
 		trap_Cvar_Set("g_blueLocked","0");
-		for( i = 0; i < MAX_CLIENTS; i++ ){
-			trap_Cvar_Set(va( "demopath%i", i ), "");
-		}
 	}
         
         //disable unwanted cvars
@@ -1119,6 +1164,7 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
         }
 
 	G_ProcessIPBans();
+	G_InitProfile( "ip filters" );
     
     //KK-OAX Changed to Tremulous's BG_InitMemory
 	BG_InitMemory();
@@ -1150,36 +1196,41 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 
 	level.snd_fry = G_SoundIndex("sound/player/fry.wav");	// FIXME standing in lava / slime
 
-	if ( g_gametype.integer != GT_SINGLE_PLAYER && g_logfile.string[0] ) {
-		if ( g_logfileSync.integer ) {
-			trap_FS_FOpenFile( g_logfile.string, &level.logFile, FS_APPEND_SYNC );
-		} else {
-			trap_FS_FOpenFile( g_logfile.string, &level.logFile, FS_APPEND );
-		}
-		if ( !level.logFile ) {
-			G_Printf( "WARNING: Couldn't open logfile: %s\n", g_logfile.string );
-		} else {
-			char	serverinfo[MAX_INFO_STRING];
-
-			trap_GetServerinfo( serverinfo, sizeof( serverinfo ) );
+	if ( g_gametype.integer != GT_SINGLE_PLAYER && ( g_logfile.string[0] || g_logEvents.string[0] ) ) {
+		char	serverinfo[MAX_INFO_STRING];
 
+		G_LogOpen();
+		trap_GetServerinfo( serverinfo, sizeof( serverinfo ) );
+		if ( level.logFile ) {
 			G_LogPrintf("------------------------------------------------------------\n" );
 			G_LogPrintf("InitGame: %s\n", serverinfo );
                         G_LogPrintf("Info: ServerInfo length: %d of %d\n", strlen(serverinfo), MAX_INFO_STRING );
 		}
+		G_LogEvent( "init", "ss", "map", Info_ValueForKey( serverinfo, "mapname" ),
+			"gametype", g_gametype.string );
 	} else {
 		G_Printf( "Not logging to disk.\n" );
 	}
 
+	G_InitProfile( "logs" );
+
         //Parse the custom vote names:
         VoteParseCustomVotes();
+	G_InitProfile( "custom votes" );
+
+	// index the maps for votes, the mapcycle and the map pages
+	G_BuildMapCatalog();
+	G_InitProfile( "map catalog" );
 
 	G_InitWorldSession();
+	G_InitProfile( "session" );
     
     //KK-OAX Get Admin Configuration
     G_admin_readconfig( NULL, 0 );
+	G_InitProfile( "admin config" );
 	//Let's Load up any killing sprees/multikills
 	G_ReadAltKillSettings( NULL, 0 );
+	G_InitProfile( "killing sprees" );
 
 	// initialize all entities for this game
 	memset( g_entities, 0, MAX_GENTITIES * sizeof(g_entities[0]) );
@@ -1212,8 +1263,13 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 
 	ClearRegisteredItems();
 
+	// set for the map_restart at the end of the warmup, and cleared
+	// again while spawning
+	warmupEnded = g_restarted.integer;
+
 	// parse the key/value pairs and spawn gentities
 	G_SpawnEntitiesFromString();
+	G_InitProfile( "entities" );
 
 	// general initialization
 	G_FindTeams();
@@ -1224,6 +1280,12 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	}
 
 	SaveRegisteredItems();
+
+	// the match is live from here on, either after the warmup restart
+	// or straight away without a warmup
+	if ( level.warmupTime == 0 ) {
+		G_StatsBegin( !warmupEnded );
+	}
 	
 	trap_Cvar_VariableStringBuffer("lastmap", lastmap, sizeof(lastmap));
 	trap_Cvar_VariableStringBuffer("mapfile", mapfile, sizeof(mapfile));
@@ -1241,6 +1303,7 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 			G_GetMapfile(mapname);
 		
 	}
+	G_InitProfile( "mapcycle" );
         
         G_Printf ("-----------------------------------\n");
 
@@ -1255,6 +1318,7 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 		BotAILoadMap( restart );
 		G_InitBots( restart );
 	}
+	G_InitProfile( "bots" );
 
 	G_RemapTeamShaders();
 
@@ -1282,8 +1346,6 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 		level.domination_points_count = 0; //make sure its not too big
 	}
 
-        PlayerStoreInit();
-
         //Set vote flags
         {
             int voteflags=0;
@@ -1331,6 +1393,11 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	
 	memset(level.disconnectedClients, 0, MAX_DISCONNECTEDCLIENTS * sizeof(level.disconnectedClients[0]));
 	level.disconnectedClientsNumber = 0;
+
+	G_InitProfile( "items" );
+	if ( g_profileInit.integer ) {
+		G_Printf( "init: %-16s %5i ms\n", "total", trap_Milliseconds() - initStartTime );
+	}
 }
 
 
@@ -1346,11 +1413,12 @@ void G_ShutdownGame( int restart ) {
 	if ( level.logFile ) {
 		G_LogPrintf("ShutdownGame:\n" );
 		G_LogPrintf("------------------------------------------------------------\n" );
-		trap_FS_FCloseFile( level.logFile );
 	}
+	G_LogEvent( "shutdown", "i", "restart", restart );
+	G_LogClose();
 
 	// write all the client session data so we can get it back
-	G_WriteSessionData();
+	G_WriteSessionData( restart );
 	
 	//KK-OAX Admin Cleanup
     G_admin_cleanup( );
@@ -2126,7 +2194,7 @@ void ExitLevel (void) {
 	}
 
 	// we need to do this here before chaning to CON_CONNECTING
-	G_WriteSessionData();
+	G_WriteSessionData( qfalse );
 
 	// change all client states to connecting, so the early players into the
 	// next level will know the others aren't done reconnecting
@@ -2138,6 +2206,207 @@ void ExitLevel (void) {
 
 }
 
+/*
+========================================================================
+
+LOG BUFFERING
+
+Log lines are collected per file and written once at the end of the frame,
+or sooner if the buffer fills, so that a busy server issues one write per
+frame rather than one for every kill, pickup and chat line.  This matters
+most with g_logsync, where every write is a synchronous append.
+
+g_logEvents names an optional second log that gets the main events as JSON
+lines, for stats tools that would rather not parse the text log.  The same
+events go to the per-match stats stream while g_serverstats.c has one open.
+
+========================================================================
+*/
+
+#define	LOG_BUFFER_SIZE		16384
+
+typedef struct {
+	char	buffer[LOG_BUFFER_SIZE];
+	int		length;
+	int		bufferedTime;	// trap_Milliseconds when the oldest line came in
+
+	// counters for logstats
+	int		lines;
+	int		bytes;
+	int		flushes;
+	int		totalLatency;
+	int		maxLatency;
+	int		writeMsec;		// time spent in trap_FS_Write
+	int		openTime;
+	int		second;			// level.time / 1000 of secondBytes
+	int		secondBytes;
+	int		peakBytes;		// most bytes written in one second
+} logBuffer_t;
+
+static logBuffer_t	gameLog;
+static logBuffer_t	eventLog;
+static logBuffer_t	statsLog;
+
+/*
+=================
+G_LogBufferReset
+=================
+*/
+static void G_LogBufferReset( logBuffer_t *log ) {
+	memset( log, 0, sizeof( *log ) );
+	log->openTime = trap_Milliseconds();
+}
+
+/*
+=================
+G_LogBufferFlush
+=================
+*/
+static void G_LogBufferFlush( logBuffer_t *log, fileHandle_t f ) {
+	int		start, latency;
+
+	if ( !log->length ) {
+		return;
+	}
+
+	start = trap_Milliseconds();
+	latency = start - log->bufferedTime;
+	trap_FS_Write( log->buffer, log->length, f );
+	log->writeMsec += trap_Milliseconds() - start;
+
+	log->flushes++;
+	log->totalLatency += latency;
+	if ( latency > log->maxLatency ) {
+		log->maxLatency = latency;
+	}
+	log->length = 0;
+}
+
+/*
+=================
+G_LogBufferWrite
+=================
+*/
+static void G_LogBufferWrite( logBuffer_t *log, fileHandle_t f, const char *s, int len ) {
+	if ( log->length + len > LOG_BUFFER_SIZE ) {
+		G_LogBufferFlush( log, f );
+	}
+	if ( !log->length ) {
+		log->bufferedTime = trap_Milliseconds();
+	}
+	memcpy( log->buffer + log->length, s, len );
+	log->length += len;
+
+	log->lines++;
+	log->bytes += len;
+	if ( level.time / 1000 != log->second ) {
+		log->second = level.time / 1000;
+		log->secondBytes = 0;
+	}
+	log->secondBytes += len;
+	if ( log->secondBytes > log->peakBytes ) {
+		log->peakBytes = log->secondBytes;
+	}
+}
+
+/*
+=================
+G_LogOpen
+
+Opens the text log and the event log, if they are set
+=================
+*/
+void G_LogOpen( void ) {
+	fsMode_t	mode;
+
+	G_LogBufferReset( &gameLog );
+	G_LogBufferReset( &eventLog );
+
+	mode = g_logfileSync.integer ? FS_APPEND_SYNC : FS_APPEND;
+
+	if ( g_logfile.string[0] ) {
+		trap_FS_FOpenFile( g_logfile.string, &level.logFile, mode );
+		if ( !level.logFile ) {
+			G_Printf( "WARNING: Couldn't open logfile: %s\n", g_logfile.string );
+		}
+	}
+
+	if ( g_logEvents.string[0] ) {
+		trap_FS_FOpenFile( g_logEvents.string, &level.eventLogFile, mode );
+		if ( !level.eventLogFile ) {
+			G_Printf( "WARNING: Couldn't open event log: %s\n", g_logEvents.string );
+		}
+	}
+}
+
+/*
+=================
+G_LogFlush
+
+Writes out everything logged since the last flush.  Called at the end of
+every frame.
+=================
+*/
+void G_LogFlush( void ) {
+	if ( level.logFile ) {
+		G_LogBufferFlush( &gameLog, level.logFile );
+	}
+	if ( level.eventLogFile ) {
+		G_LogBufferFlush( &eventLog, level.eventLogFile );
+	}
+	if ( level.statsFile ) {
+		G_LogBufferFlush( &statsLog, level.statsFile );
+	}
+}
+
+/*
+=================
+G_LogClose
+=================
+*/
+void G_LogClose( void ) {
+	G_LogFlush();
+	if ( level.logFile ) {
+		trap_FS_FCloseFile( level.logFile );
+		level.logFile = 0;
+	}
+	if ( level.eventLogFile ) {
+		trap_FS_FCloseFile( level.eventLogFile );
+		level.eventLogFile = 0;
+	}
+	G_LogCloseStats();
+}
+
+/*
+=================
+G_LogOpenStats
+
+Starts sending events to a stats stream as well
+=================
+*/
+void G_LogOpenStats( const char *filename ) {
+	G_LogCloseStats();
+	G_LogBufferReset( &statsLog );
+	trap_FS_FOpenFile( filename, &level.statsFile, FS_WRITE );
+	if ( !level.statsFile ) {
+		G_Printf( "WARNING: Couldn't open stats stream: %s\n", filename );
+	}
+}
+
+/*
+=================
+G_LogCloseStats
+=================
+*/
+void G_LogCloseStats( void ) {
+	if ( !level.statsFile ) {
+		return;
+	}
+	G_LogBufferFlush( &statsLog, level.statsFile );
+	trap_FS_FCloseFile( level.statsFile );
+	level.statsFile = 0;
+}
+
 /*
 =================
 G_LogPrintf
@@ -2171,7 +2440,139 @@ void QDECL G_LogPrintf( const char *fmt, ... ) {
 		return;
 	}
 
-	trap_FS_Write( string, strlen( string ), level.logFile );
+	G_LogBufferWrite( &gameLog, level.logFile, string, strlen( string ) );
+}
+
+/*
+=================
+G_LogEvent
+
+Adds one JSON object to the event log and the stats stream.  fields has a
+letter for each key/value pair that follows: 'i' for an int, 's' for a
+string, 'j' for a string that already holds JSON.
+
+  G_LogEvent( "kill", "iis", "attacker", a, "target", t, "mod", modName );
+
+gives {"time":81250,"event":"kill","attacker":2,"target":5,"mod":"MOD_RAILGUN"}
+=================
+*/
+void QDECL G_LogEvent( const char *event, const char *fields, ... ) {
+	va_list		argptr;
+	char		string[4096];
+	char		field[2048];
+	const char	*key, *s;
+	char		*out, *end;
+	int			c, len;
+	qboolean	full;
+
+	if ( !level.eventLogFile && !level.statsFile ) {
+		return;
+	}
+
+	Com_sprintf( string, sizeof( string ), "{\"time\":%i,\"event\":\"%s\"", level.time, event );
+	out = string + strlen( string );
+	// leave room for the closing "}\n"
+	end = string + sizeof( string ) - 3;
+
+	va_start( argptr, fields );
+	for ( ; *fields ; fields++ ) {
+		key = va_arg( argptr, const char * );
+		Com_sprintf( field, sizeof( field ), ",\"%s\":", key );
+		len = strlen( field );
+		full = qfalse;
+
+		if ( *fields == 'i' ) {
+			Com_sprintf( field + len, sizeof( field ) - len, "%i", va_arg( argptr, int ) );
+			len += strlen( field + len );
+		} else if ( *fields == 'j' ) {
+			s = va_arg( argptr, const char * );
+			if ( len + strlen( s ) < sizeof( field ) ) {
+				strcpy( field + len, s );
+				len += strlen( s );
+			} else {
+				full = qtrue;
+			}
+		} else {
+			s = va_arg( argptr, const char * );
+			field[len++] = '"';
+			for ( ; *s ; s++ ) {
+				// room for the longest escape and the closing quote
+				if ( len > sizeof( field ) - 8 ) {
+					full = qtrue;
+					break;
+				}
+				c = *(const unsigned char *)s;
+				if ( c == '"' || c == '\\' ) {
+					field[len++] = '\\';
+					field[len++] = c;
+				} else if ( c < ' ' ) {
+					Com_sprintf( field + len, sizeof( field ) - len, "\\u%04x", c );
+					len += strlen( field + len );
+				} else {
+					field[len++] = c;
+				}
+			}
+			field[len++] = '"';
+		}
+
+		// a field that doesn't fit is left out whole, so that the line
+		// is still valid JSON
+		if ( full || out + len > end ) {
+			G_Printf( "WARNING: G_LogEvent: left %s out of a %s event\n", key, event );
+			continue;
+		}
+		memcpy( out, field, len );
+		out += len;
+	}
+	va_end( argptr );
+
+	*out++ = '}';
+	*out++ = '\n';
+
+	if ( level.eventLogFile ) {
+		G_LogBufferWrite( &eventLog, level.eventLogFile, string, out - string );
+	}
+	if ( level.statsFile ) {
+		G_LogBufferWrite( &statsLog, level.statsFile, string, out - string );
+	}
+}
+
+/*
+=================
+G_LogPrintStats
+=================
+*/
+static void G_LogPrintStats( const char *name, const logBuffer_t *log ) {
+	int		msec;
+
+	msec = trap_Milliseconds() - log->openTime;
+	G_Printf( "%s: %i lines, %i bytes in %i writes, %i bytes buffered\n",
+		name, log->lines, log->bytes, log->flushes, log->length );
+	G_Printf( "  %i bytes/s average, %i bytes/s peak\n",
+		msec > 0 ? (int)( log->bytes * 1000.0f / msec ) : 0, log->peakBytes );
+	G_Printf( "  flush latency %i ms average, %i ms max, %i ms writing\n",
+		log->flushes ? log->totalLatency / log->flushes : 0, log->maxLatency, log->writeMsec );
+}
+
+/*
+=================
+Svcmd_LogStats_f
+=================
+*/
+void Svcmd_LogStats_f( void ) {
+	if ( !level.logFile && !level.eventLogFile && !level.statsFile ) {
+		G_Printf( "Not logging to disk.\n" );
+		return;
+	}
+	if ( level.logFile ) {
+		G_LogPrintStats( g_logfile.string, &gameLog );
+	}
+	if ( level.eventLogFile ) {
+		G_LogPrintStats( g_logEvents.string, &eventLog );
+	}
+	if ( level.statsFile ) {
+		G_LogPrintStats( "stats stream", &statsLog );
+	}
 }
 
 /*
@@ -2188,6 +2589,7 @@ void LogExit( const char *string ) {
 	qboolean won = qtrue;
 #endif
 	G_LogPrintf( "Exit: %s\n", string );
+	G_LogEvent( "exit", "s", "reason", string );
 
 	level.intermissionQueued = level.time;
 
@@ -2204,6 +2606,7 @@ void LogExit( const char *string ) {
 	if ( g_gametype.integer >= GT_TEAM && g_ffa_gt!=1) {
 		G_LogPrintf( "red:%i  blue:%i\n",
 			level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE] );
+		G_LogEvent( "teamscore", "ii", "red", level.teamScores[TEAM_RED], "blue", level.teamScores[TEAM_BLUE] );
 	}
 
 	for (i=0 ; i < numSorted ; i++) {
@@ -2221,6 +2624,7 @@ void LogExit( const char *string ) {
 		ping = cl->ps.ping < 999 ? cl->ps.ping : 999;
 
 		G_LogPrintf( "score: %i  ping: %i  client: %i %s\n", cl->ps.persistant[PERS_SCORE], ping, level.sortedClients[i],	cl->pers.netname );
+		G_LogEvent( "score", "iii", "client", level.sortedClients[i], "score", cl->ps.persistant[PERS_SCORE], "ping", ping );
 #ifdef MISSIONPACK
 		if (g_singlePlayer.integer && g_gametype.integer == GT_TOURNAMENT) {
 			if (g_entities[cl - level.clients].r.svFlags & SVF_BOT && cl->ps.persistant[PERS_RANK] == 0) {
@@ -2387,8 +2791,12 @@ void CheckExitRules( void ) {
 		if( ( level.time > level.intermissiontime + 500 ) && ( !level.endgameSend ) ){
 			//G_StopServerDemo();
 			G_SendEndGame();
-			if( g_writeStats.integer )
-				G_WriteXMLStats();
+			if( g_writeStats.integer ) {
+				if ( g_statsFormat.integer )
+					G_WriteStatsTrailer();
+				else
+					G_WriteXMLStats();
+			}
 			G_StopServerDemos();
 		}
 		if( (g_useMapcycle.integer >= 2) &&  ( level.time > level.intermissiontime + 3000 )  ){
@@ -3684,5 +4092,8 @@ void G_RunFrame( int levelTime ) {
 	// accepting commands from connected clients
 	level.frameStartTime = trap_Milliseconds();
 //unlagged - backward reconciliation #4
+
+	G_FlushServerCommands();
+	G_LogFlush();
 }
 
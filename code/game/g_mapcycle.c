@@ -158,20 +158,6 @@ qboolean SkippedChar ( char in ) {
 	return ( in == '\n' || in == '\r' || in == ';' || in == '\t' || in == ' ' );
 }
 
-/*
-=================
-G_MapAvailable
-search for a map in the mapfolder,
-if the map is not found return qfalse
-=================
-*/
-static qboolean G_MapAvailable ( char* map ) {
-	if( !trap_FS_FOpenFile ( va ( "maps/%s.bsp",map ), NULL,FS_READ ) )
-		return qfalse; //maps/MAPNAME.bsp does not exist
-	
-	return qtrue;
-}
-
 static int G_findCharInString( char charin, char* string, int size ){
 	int i;
 	for( i = 0; i < size; i++ ){
@@ -210,7 +196,7 @@ static void G_setMapcycle ( token_t *in, int min, int max ) {
 				mapcycle.mapfiles[mapcycle.mapcycleCount][0] = '\0';
 			}
 			
-			if ( G_MapAvailable ( in[i].value ) ) {
+			if ( G_MapExists ( in[i].value ) ) {
 				mapcycle.maps[mapcycle.mapcycleCount] = in[i].value;
 				mapcycle.mapcycleCount++;
 				lastMapAvailable = qtrue;
@@ -258,7 +244,7 @@ static void G_setAllowedMaps ( token_t *in, int min, int max ) {
 				mapcycle.allowedmapfiles[mapcycle.allowedMapsCount][0] = '\0';
 			}
 			
-			if ( G_MapAvailable ( in[i].value ) ) {
+			if ( G_MapExists ( in[i].value ) ) {
 				mapcycle.allowedMaps[mapcycle.allowedMapsCount] = in[i].value;
 				mapcycle.allowedMapsCount++;
 			} else {
@@ -468,8 +454,18 @@ in the argument is voteable
 =================
 */
 qboolean G_mapIsVoteable ( char* map ) {
+	mapInfo_t *m;
 	int i;
-	if ( mapcycle.allAllowed && G_MapAvailable ( map ) )
+
+	m = G_FindMap ( map );
+	if ( m ) {
+		if ( m->flags & ( MAPF_CYCLE | MAPF_ALLOWED ) )
+			return qtrue;
+		return mapcycle.allAllowed && ( m->flags & MAPF_BSP );
+	}
+
+	// not in the map catalog, which only happens when it is full
+	if ( mapcycle.allAllowed && G_MapExists ( map ) )
 		return qtrue;
 
 	for ( i = 0; i < mapcycle.mapcycleCount; i++ ) {
@@ -608,6 +604,7 @@ static void G_initMapcycle ( void ) {
 	mapcycle.mapcycleCount = 0;
 	mapcycle.allowedMapsCount = 0;
 	mapcycle.allAllowed = qtrue;
+	G_ClearMapFlags ( MAPF_CYCLE | MAPF_ALLOWED );
 	for ( i = 0; i < MAX_MAPCYCLECOUNT; i++ ) {
 		mapcycle.minplayers[i] = 0;
 		mapcycle.maxplayers[i] = MAX_CLIENTS;
@@ -615,6 +612,36 @@ static void G_initMapcycle ( void ) {
 	}
 }
 
+/*
+=================
+G_IndexMapcycle
+marks the mapcycle and the
+allowed maps in the map catalog
+=================
+*/
+static void G_IndexMapcycle ( void ) {
+	mapInfo_t *m;
+	int i;
+
+	for ( i = 0; i < mapcycle.mapcycleCount; i++ ) {
+		m = G_FindMap ( mapcycle.maps[i] );
+		if ( !m )
+			continue;
+		// a map that is in the cycle more than once gets the widest bounds
+		if ( !( m->flags & MAPF_CYCLE ) || mapcycle.minplayers[i] < m->minplayers )
+			m->minplayers = mapcycle.minplayers[i];
+		if ( !( m->flags & MAPF_CYCLE ) || mapcycle.maxplayers[i] > m->maxplayers )
+			m->maxplayers = mapcycle.maxplayers[i];
+		m->flags |= MAPF_CYCLE;
+	}
+
+	for ( i = 0; i < mapcycle.allowedMapsCount; i++ ) {
+		m = G_FindMap ( mapcycle.allowedMaps[i] );
+		if ( m )
+			m->flags |= MAPF_ALLOWED;
+	}
+}
+
 token_t tokens[MAX_MAPCYCLETOKENS];
 
 /*
@@ -731,5 +758,6 @@ void G_LoadMapcycle ( void ) {
   }
 
 	mapcycle.allAllowed = allAllowed;
+	G_IndexMapcycle();
 }
 
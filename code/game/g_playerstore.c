@@ -22,17 +22,27 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "g_local.h"
 
-#define MAX_PLAYERS_STORED 32
+#define MAX_PLAYERS_STORED 256
+#define PLAYERSTORE_HASH_SIZE 512
 
 #define GUID_SIZE 32
 
 typedef struct {
     char guid[GUID_SIZE+1]; //The guid is 32 chars long
-    int age; //int that grows each time a new player is stored. The lowest number is always replaced. Reset to 0 then retrieved.
-    int	persistant[MAX_PERSISTANT]; //This is the only information we need to save
+    int age; //int that grows each time a new player is stored. The lowest number is always replaced. 0 if unused, -1 once retrieved.
+    int hashNext; //Next record with the same hash, index+1
+    int	persistant[MAX_PERSISTANT];
+    //Stats, so they carry on where they left off
+    int accuracy[WP_NUM_WEAPONS][5];
+    int accuracy_shots;
+    int accuracy_hits;
+    int dmgdone;
+    int dmgtaken;
+    int kills;
 } playerstore_t;
 
 static playerstore_t playerstore[MAX_PLAYERS_STORED];
+static int playerstoreHash[PLAYERSTORE_HASH_SIZE]; //First record for each hash, index+1
 
 static int nextAge;
 
@@ -41,59 +51,158 @@ static int nextAge;
  */
 void PlayerStoreInit( void ) {
     memset(playerstore,0,sizeof(playerstore));
+    memset(playerstoreHash,0,sizeof(playerstoreHash));
     nextAge = 1;
 }
 
-void PlayerStore_store(char* guid, playerState_t ps) {
-    int place2store = -1;
-    int lowestAge = 32000;
+/*
+ *Guids are compared without case, so they are hashed that way too
+ */
+static int PlayerStore_hash(const char *guid) {
+    unsigned hash = 2166136261u;
+    int i;
+    for(i=0;i<GUID_SIZE && guid[i];i++)
+        hash = (hash ^ (unsigned)tolower(guid[i])) * 16777619u;
+    return hash % PLAYERSTORE_HASH_SIZE;
+}
+
+static void PlayerStore_link(int place) {
+    int hash = PlayerStore_hash(playerstore[place].guid);
+    playerstore[place].hashNext = playerstoreHash[hash];
+    playerstoreHash[hash] = place+1;
+}
+
+static void PlayerStore_unlink(int place) {
+    int *link = &playerstoreHash[PlayerStore_hash(playerstore[place].guid)];
+    while(*link) {
+        if(*link == place+1) {
+            *link = playerstore[place].hashNext;
+            return;
+        }
+        link = &playerstore[*link-1].hashNext;
+    }
+}
+
+/*
+ *Returns the record holding guid or -1
+ */
+static int PlayerStore_find(const char *guid) {
+    int place = playerstoreHash[PlayerStore_hash(guid)];
+    while(place) {
+        if(!Q_stricmpn(guid,playerstore[place-1].guid,GUID_SIZE))
+            return place-1;
+        place = playerstore[place-1].hashNext;
+    }
+    return -1;
+}
+
+void PlayerStore_store(char* guid, gclient_t *client) {
+    int place2store;
     int i;
     if(strlen(guid)<32)
     {
         G_LogPrintf("Playerstore: Failed to store player. Invalid guid: %s\n",guid);
         return;
     }
-    for(i=0;i<MAX_PLAYERS_STORED;i++) {
-        if(!Q_stricmp(guid,playerstore[i].guid)) {
-            place2store=i;
-        }
-    }
 
-    if(place2store<0)
-    for(i=0;i<MAX_PLAYERS_STORED;i++) {
-        if(playerstore[i].age < lowestAge) {
-            place2store = i;
-            lowestAge = playerstore[i].age;
+    place2store = PlayerStore_find(guid);
+
+    if(place2store<0) {
+        //Only a new player has to look for a place, so the scan is fine here
+        place2store = 0;
+        for(i=1;i<MAX_PLAYERS_STORED;i++) {
+            if(playerstore[i].age < playerstore[place2store].age)
+                place2store = i;
         }
+        if(playerstore[place2store].age)
+            PlayerStore_unlink(place2store);
+        Q_strncpyz(playerstore[place2store].guid,guid,GUID_SIZE+1);
+        PlayerStore_link(place2store);
     }
 
-    //Make sure we don't store in -1
-    if(place2store<0)
-        place2store = 0;
     //place2store is now the place to store to.
     playerstore[place2store].age = nextAge++;
-    Q_strncpyz(playerstore[place2store].guid,guid,GUID_SIZE+1);
-    memcpy(playerstore[place2store].persistant,ps.persistant,sizeof(int[MAX_PERSISTANT]));
+    memcpy(playerstore[place2store].persistant,client->ps.persistant,sizeof(int[MAX_PERSISTANT]));
+    memcpy(playerstore[place2store].accuracy,client->accuracy,sizeof(playerstore[place2store].accuracy));
+    playerstore[place2store].accuracy_shots = client->accuracy_shots;
+    playerstore[place2store].accuracy_hits = client->accuracy_hits;
+    playerstore[place2store].dmgdone = client->dmgdone;
+    playerstore[place2store].dmgtaken = client->dmgtaken;
+    playerstore[place2store].kills = client->kills;
     G_LogPrintf("Playerstore: Stored player with guid: %s in %u\n", playerstore[place2store].guid,place2store);
 }
 
-void PlayerStore_restore(char* guid, playerState_t *ps)  {
+void PlayerStore_restore(char* guid, gclient_t *client)  {
     int i;
     if(strlen(guid)<32)
     {
         G_LogPrintf("Playerstore: Failed to restore player. Invalid guid: %s\n",guid);
         return;
     }
+    i = PlayerStore_find(guid);
+    if(i>=0 && playerstore[i].age != -1) {
+        memcpy(client->ps.persistant,playerstore[i].persistant,sizeof(int[MAX_PERSISTANT]));
+        //Never ever restore a player with negative score
+        if(client->ps.persistant[PERS_SCORE]<0)
+            client->ps.persistant[PERS_SCORE]=0;
+        memcpy(client->accuracy,playerstore[i].accuracy,sizeof(client->accuracy));
+        client->accuracy_shots = playerstore[i].accuracy_shots;
+        client->accuracy_hits = playerstore[i].accuracy_hits;
+        client->dmgdone = playerstore[i].dmgdone;
+        client->dmgtaken = playerstore[i].dmgtaken;
+        client->kills = playerstore[i].kills;
+        playerstore[i].age = -1;
+        G_LogPrintf("Restored player with guid: %s\n",guid);
+        return;
+    }
+    G_LogPrintf("Playerstore: Nothing to restore. Guid: %s\n",guid);
+}
+
+/*
+ *Writes the stored players that have not been restored yet to the session file.
+ *Format: count, record size, then the records.
+ */
+void PlayerStore_write(fileHandle_t f) {
+    int count, size, i;
+
+    count = 0;
     for(i=0;i<MAX_PLAYERS_STORED;i++) {
-        if(!Q_stricmpn(guid,playerstore[i].guid,GUID_SIZE) && playerstore[i].age != -1) {
-            memcpy(ps->persistant,playerstore[i].persistant,sizeof(int[MAX_PERSISTANT]));
-            //Never ever restore a player with negative score
-            if(ps->persistant[PERS_SCORE]<0)
-                ps->persistant[PERS_SCORE]=0;
-            playerstore[i].age = -1;
-            G_LogPrintf("Restored player with guid: %s\n",guid);
-            return;
+        if(playerstore[i].age > 0)
+            count++;
+    }
+    size = sizeof(playerstore_t);
+    trap_FS_Write(&count,sizeof(count),f);
+    trap_FS_Write(&size,sizeof(size),f);
+    for(i=0;i<MAX_PLAYERS_STORED;i++) {
+        if(playerstore[i].age > 0)
+            trap_FS_Write(&playerstore[i],sizeof(playerstore_t),f);
+    }
+}
+
+/*
+ *Reads back what PlayerStore_write wrote. len is what is left of the file, and
+ *must not be negative.
+ */
+void PlayerStore_read(fileHandle_t f, int len) {
+    int count, size, i;
+
+    PlayerStoreInit();
+    if(len < (int)(sizeof(count)+sizeof(size)))
+        return;
+    trap_FS_Read(&count,sizeof(count),f);
+    trap_FS_Read(&size,sizeof(size),f);
+    if(size != (int)sizeof(playerstore_t) || count < 0 || count > MAX_PLAYERS_STORED ||
+            len != (int)(sizeof(count)+sizeof(size)) + count*size)
+        return;
+    for(i=0;i<count;i++) {
+        trap_FS_Read(&playerstore[i],sizeof(playerstore_t),f);
+        playerstore[i].guid[GUID_SIZE] = '\0';
+        if(playerstore[i].age <= 0) {
+            memset(&playerstore[i],0,sizeof(playerstore_t));
+            continue;
         }
+        PlayerStore_link(i);
+        if(playerstore[i].age >= nextAge)
+            nextAge = playerstore[i].age+1;
     }
-    G_LogPrintf("Playerstore: Nothing to restore. Guid: %s\n",guid);
 }
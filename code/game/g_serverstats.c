@@ -122,9 +122,29 @@ void G_SetGameString ( void ) {
 	trap_Cvar_Set( "matchstring", gameString );
 }
 
+// the XML is collected here and written in a few large pieces instead of
+// one trap_FS_Write per line
+static char xmlBuffer[16384];
+static int xmlLength;
+
+static void flushFile ( fileHandle_t *f ) {
+	if ( xmlLength ) {
+		trap_FS_Write ( xmlBuffer, xmlLength, *f );
+		xmlLength = 0;
+	}
+}
+
 static void writeToFile ( char *string, fileHandle_t *f ) {
 	int len =strlen ( string );
-	trap_FS_Write ( string, len, *f );
+
+	if ( xmlLength + len > sizeof ( xmlBuffer ) )
+		flushFile ( f );
+	if ( len > sizeof ( xmlBuffer ) ) {
+		trap_FS_Write ( string, len, *f );
+		return;
+	}
+	memcpy ( xmlBuffer + xmlLength, string, len );
+	xmlLength += len;
 }
 
 static char *boolToChar ( qboolean in ) {
@@ -177,7 +197,7 @@ static void writePlayerData ( gclient_t *cl, fileHandle_t *f, qboolean disconnec
 	}
 	
 	if( ( g_gametype.integer == GT_TOURNAMENT ) && g_autoServerDemos.integer ) {
-		trap_Cvar_VariableStringBuffer(va("demopath%i", cl->ps.clientNum), demopath, sizeof(demopath));
+		Q_strncpyz(demopath, cl->sess.demopath, sizeof(demopath));
 		if( Q_stricmp(demopath, "" ) )
 			writeToFile ( va ( "\t\t\t<stat name=\"Demopath\" value=\"%s.dm_71\"/>\n", demopath ), f );
 	}
@@ -305,6 +325,7 @@ void G_WriteXMLStats ( void ) {
 	trap_Cvar_VariableStringBuffer ( "mapname", mapname, sizeof ( mapname ) );
 
 	trap_FS_FOpenFile ( va ( "%s/%s.xml", g_statsPath.string,gameString ), &f, FS_WRITE );
+	xmlLength = 0;
 
 	writeToFile ( "<?xml version=\"1.0\"?><?xml-stylesheet type=\"text/xsl\"?>\n", &f );
 	writeToFile ( va ( "<match datetime=\"%i/%02i/%02i %02i:%02i:%02i\" duration=\"%i\" map=\"%s\" type=\"%s\" isTeamGame=\"%s\" instagib=\"%i\" rocketsOnly=\"%s\" reducedLightning=\"%s\" reducedRail=\"%s\" reducedMachinegun=\"%s\" aftershockRevision=\"%i\" g_ruleset=\"%s\" serverdemo=\"%s\">\n\n",
@@ -369,6 +390,250 @@ void G_WriteXMLStats ( void ) {
 
 	writeToFile ( "</match>\n",&f );
 
+	flushFile ( &f );
 	trap_FS_FCloseFile ( f );
 	return;
 }
+
+/*
+==============================================================================
+
+STATS STREAM
+
+With g_statsFormat 1 the match is written as JSON lines while it is played
+instead of as XML at the end.  Every kill, pickup, award and flag event goes
+into the stream through G_LogEvent as it happens, a "player" record with the
+totals is added when someone leaves, and the intermission only adds the
+"player" records of whoever is still there and an "end" record.  The stream
+shares the game log buffering, so it costs at most one write per frame.
+
+==============================================================================
+*/
+
+static const struct {
+	int		weapon;
+	char	*name;
+} statsWeapons[] = {
+	{ WP_GAUNTLET, "GAUNT" },
+	{ WP_MACHINEGUN, "MG" },
+	{ WP_SHOTGUN, "SG" },
+	{ WP_GRENADE_LAUNCHER, "GL" },
+	{ WP_ROCKET_LAUNCHER, "RL" },
+	{ WP_LIGHTNING, "LG" },
+	{ WP_RAILGUN, "RG" },
+	{ WP_PLASMAGUN, "PG" },
+	{ WP_BFG, "BFG" }
+};
+
+static const struct {
+	int		reward;
+	char	*name;
+} statsRewards[] = {
+	{ REWARD_AIRROCKET, "Airrocket" },
+	{ REWARD_DOUBLE_AIRROCKET, "DoubleAirrocket" },
+	{ REWARD_AIRGRENADE, "Airgrenade" },
+	{ REWARD_FULLSG, "FullSG" },
+	{ REWARD_RLRG, "Rocket2Rail" },
+	{ REWARD_ITEMDENIED, "Itemdenied" },
+	{ REWARD_SPAWNKILL, "Spawnkill" },
+	{ REWARD_LGACCURACY, "LightningAccuracy" }
+};
+
+/*
+=================
+statsJsonValue
+
+Adds "key":value to the JSON object or array being built in buf, which
+was started with "{" or "["
+=================
+*/
+static void statsJsonValue ( char *buf, int size, const char *key, const char *value ) {
+	int len = strlen ( buf );
+
+	if ( buf[len - 1] != '{' && buf[len - 1] != '[' )
+		Q_strcat ( buf, size, "," );
+	if ( key )
+		Q_strcat ( buf, size, va ( "\"%s\":", key ) );
+	Q_strcat ( buf, size, value );
+}
+
+static void statsJsonInt ( char *buf, int size, const char *key, int value ) {
+	if ( value )
+		statsJsonValue ( buf, size, key, va ( "%i", value ) );
+}
+
+/*
+=================
+G_StatsBegin
+
+Opens the stats stream for a match that has just gone live.  The
+gamestring is set when the warmup countdown starts, so a match without
+a warmup needs a new one here.
+=================
+*/
+void G_StatsBegin ( qboolean newGameString ) {
+	char		gameString[128];
+	char		filename[MAX_QPATH];
+	char		mapname[MAX_MAPNAME];
+	char		datetime[32];
+	qtime_t		now;
+	int			i;
+
+	if ( !g_writeStats.integer || !g_statsFormat.integer || g_gametype.integer == GT_SINGLE_PLAYER )
+		return;
+
+	trap_Cvar_VariableStringBuffer ( "gamestring", gameString, sizeof ( gameString ) );
+	if ( newGameString || !gameString[0] ) {
+		G_SetGameString ();
+		trap_Cvar_VariableStringBuffer ( "gamestring", gameString, sizeof ( gameString ) );
+	}
+
+	// never write over the stream of a match that has been played
+	Com_sprintf ( filename, sizeof ( filename ), "%s/%s.jsonl", g_statsPath.string, gameString );
+	for ( i = 1; trap_FS_FOpenFile ( filename, NULL, FS_READ ) > 0; i++ ) {
+		if ( i > 9 ) {
+			G_Printf ( "WARNING: stats stream %s/%s.jsonl already exists\n", g_statsPath.string, gameString );
+			return;
+		}
+		Com_sprintf ( filename, sizeof ( filename ), "%s/%s-%i.jsonl", g_statsPath.string, gameString, i );
+	}
+
+	G_LogOpenStats ( filename );
+	if ( !level.statsFile )
+		return;
+
+	trap_RealTime ( &now );
+	Com_sprintf ( datetime, sizeof ( datetime ), "%i/%02i/%02i %02i:%02i:%02i",
+	              1900 + now.tm_year, 1 + now.tm_mon, now.tm_mday, now.tm_hour, now.tm_min, now.tm_sec );
+	trap_Cvar_VariableStringBuffer ( "mapname", mapname, sizeof ( mapname ) );
+
+	G_LogEvent ( "match", "sssiiiiiiis",
+	             "datetime", datetime,
+	             "map", mapname,
+	             "type", gameShortNames[g_gametype.integer],
+	             "isTeamGame", g_gametype.integer >= GT_TEAM,
+	             "instagib", g_instantgib.integer,
+	             "rocketsOnly", g_rockets.integer == 1,
+	             "reducedLightning", g_reduceLightningDamage.integer == 1,
+	             "reducedRail", g_reduceRailDamage.integer == 1,
+	             "reducedMachinegun", g_reduceMachinegunDamage.integer == 1,
+	             "aftershockRevision", REVISION,
+	             "g_ruleset", g_ruleset.string );
+}
+
+/*
+=================
+G_StatsPlayer
+
+Adds a player's totals to the stats stream, the same numbers the XML
+has for them
+=================
+*/
+void G_StatsPlayer ( gclient_t *cl, qboolean disconnected ) {
+	char	weapons[512], items[128], rewards[512], powerups[128], captures[768];
+	char	demopath[MAX_QPATH];
+	int		i, w;
+	int		*acc;
+
+	if ( !level.statsFile )
+		return;
+
+	Q_strncpyz ( weapons, "{", sizeof ( weapons ) );
+	for ( i = 0; i < sizeof ( statsWeapons ) / sizeof ( statsWeapons[0] ); i++ ) {
+		w = statsWeapons[i].weapon;
+		acc = cl->accuracy[w];
+		// the gauntlet has no shots, only damage
+		if ( acc[0] || ( w == WP_GAUNTLET && acc[2] ) )
+			statsJsonValue ( weapons, sizeof ( weapons ), statsWeapons[i].name,
+			                 va ( "[%i,%i,%i,%i,%i]", acc[0], acc[1], acc[2], acc[3], acc[4] ) );
+	}
+	Q_strcat ( weapons, sizeof ( weapons ), "}" );
+
+	Q_strncpyz ( items, "{", sizeof ( items ) );
+	statsJsonInt ( items, sizeof ( items ), "MH", cl->stats[STATS_MH] );
+	statsJsonInt ( items, sizeof ( items ), "RA", cl->stats[STATS_RA] );
+	statsJsonInt ( items, sizeof ( items ), "YA", cl->stats[STATS_YA] );
+	Q_strcat ( items, sizeof ( items ), "}" );
+
+	Q_strncpyz ( rewards, "{", sizeof ( rewards ) );
+	statsJsonInt ( rewards, sizeof ( rewards ), "Assist", cl->ps.persistant[PERS_ASSIST_COUNT] );
+	statsJsonInt ( rewards, sizeof ( rewards ), "Defense", cl->ps.persistant[PERS_DEFEND_COUNT] );
+	statsJsonInt ( rewards, sizeof ( rewards ), "Capture", cl->ps.persistant[PERS_CAPTURES] );
+	statsJsonInt ( rewards, sizeof ( rewards ), "Impressive", cl->ps.persistant[PERS_IMPRESSIVE_COUNT] );
+	statsJsonInt ( rewards, sizeof ( rewards ), "Excellent", cl->ps.persistant[PERS_EXCELLENT_COUNT] );
+	for ( i = 0; i < sizeof ( statsRewards ) / sizeof ( statsRewards[0] ); i++ )
+		statsJsonInt ( rewards, sizeof ( rewards ), statsRewards[i].name, cl->rewards[statsRewards[i].reward] );
+	Q_strcat ( rewards, sizeof ( rewards ), "}" );
+
+	Q_strncpyz ( powerups, "{", sizeof ( powerups ) );
+	if ( cl->stats[STATS_QUAD] )
+		statsJsonValue ( powerups, sizeof ( powerups ), "QuadDamage",
+		                 va ( "[%i,%i,%i]", cl->stats[STATS_QUAD], cl->stats[STATS_QUADKILLS], cl->stats[STATS_QUADSTREAK] ) );
+	Q_strcat ( powerups, sizeof ( powerups ), "}" );
+
+	Q_strncpyz ( captures, "[", sizeof ( captures ) );
+	for ( i = 0; i < cl->captureCount; i++ ) {
+		statsJsonValue ( captures, sizeof ( captures ), NULL,
+		                 va ( "{\"team\":\"%s\",\"perfect\":%i,\"duration\":%i,\"gametime\":%i}",
+		                      cl->captures[i].team == TEAM_RED ? "Red" : "Blue", cl->captures[i].perfect,
+		                      cl->captures[i].duration, cl->captures[i].gametime ) );
+	}
+	Q_strcat ( captures, sizeof ( captures ), "]" );
+
+	demopath[0] = '\0';
+	if ( ( g_gametype.integer == GT_TOURNAMENT ) && g_autoServerDemos.integer )
+		Q_strncpyz ( demopath, cl->sess.demopath, sizeof ( demopath ) );
+
+	G_LogEvent ( "player", "issssisiiiiiiiiiiiiijjjjjs",
+	             "client", cl->ps.clientNum,
+	             "name", cl->pers.netname,
+	             "guid", cl->pers.guid,
+	             "aftershock_login", cl->aftershock_name,
+	             "aftershock_hash", cl->aftershock_hash,
+	             "disconnected", disconnected,
+	             "team", teamToChar ( cl->sess.sessionTeam ),
+	             "time", ( level.time - cl->pers.enterTime ) / 1000,
+	             "timeouts", cl->timeouts,
+	             "handicap", cl->pers.maxHealth,
+	             "score", cl->ps.persistant[PERS_SCORE],
+	             "kills", cl->kills,
+	             "deaths", cl->ps.persistant[PERS_KILLED],
+	             "damageGiven", cl->dmgdone,
+	             "damageTaken", cl->dmgtaken,
+	             "healthTotal", cl->stats[STATS_HEALTH],
+	             "armorTotal", cl->stats[STATS_ARMOR],
+	             "isBot", ( g_entities[cl->ps.clientNum].r.svFlags & SVF_BOT ) != 0,
+	             "shots", cl->accuracy_shots,
+	             "hits", cl->accuracy_hits,
+	             "weapons", weapons,
+	             "items", items,
+	             "rewards", rewards,
+	             "powerups", powerups,
+	             "captures", captures,
+	             "demopath", demopath );
+}
+
+/*
+=================
+G_WriteStatsTrailer
+
+Ends the stats stream at intermission.  The events and team scores are
+already in it, so this is only the remaining players and the "end" record.
+=================
+*/
+void G_WriteStatsTrailer ( void ) {
+	int i;
+
+	if ( !level.statsFile )
+		return;
+
+	for ( i = 0; i < level.numConnectedClients; i++ )
+		G_StatsPlayer ( &level.clients[level.sortedClients[i]], qfalse );
+
+	G_LogEvent ( "end", "iiii",
+	             "duration", level.time - level.startTime,
+	             "players", level.numConnectedClients,
+	             "red", level.teamScores[TEAM_RED],
+	             "blue", level.teamScores[TEAM_BLUE] );
+	G_LogCloseStats ();
+}
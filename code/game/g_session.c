@@ -30,9 +30,149 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 Session data is the only data that stays persistant across level loads
 and tournament restarts.
+
+It is kept in memory while the level runs and written at shutdown to
+cache/session<port>.dat, along with the player store, as one binary
+file.  The "session" cvar holds the gametype and a stamp that the file
+has to match, so a file left over from another run or another server
+is never used.  If the file can't be written the sessions go into
+session<client> cvars the old way instead, and the stamp is 0.
 =======================================================================
 */
 
+#define	SESSION_IDENT		( ( 'S' << 24 ) + ( 'S' << 16 ) + ( 'E' << 8 ) + 'S' )
+#define	SESSION_VERSION		1
+
+typedef struct {
+	int		ident;
+	int		version;
+	int		stamp;				// must match the "session" cvar
+	int		gametype;
+	int		restart;			// written by a map_restart
+	int		keepStore;			// the player store is still good
+	int		sessionSize;		// sizeof( clientSession_t )
+} sessionHeader_t;
+
+static clientSession_t	sessions[MAX_CLIENTS];
+
+/*
+================
+G_SessionFile
+================
+*/
+static const char *G_SessionFile( void ) {
+	return va( "cache/session%i.dat", trap_Cvar_VariableIntegerValue( "net_port" ) );
+}
+
+/*
+================
+G_ReadSessionFile
+
+Returns qfalse if the file is missing or not the one the stamp is for
+================
+*/
+static qboolean G_ReadSessionFile( int stamp ) {
+	sessionHeader_t	header;
+	fileHandle_t	f;
+	int				len, i;
+
+	len = trap_FS_FOpenFile( G_SessionFile(), &f, FS_READ );
+	if ( !f ) {
+		return qfalse;
+	}
+	if ( len < (int)( sizeof( header ) + sizeof( sessions ) ) ) {
+		trap_FS_FCloseFile( f );
+		return qfalse;
+	}
+	trap_FS_Read( &header, sizeof( header ), f );
+	if ( header.ident != SESSION_IDENT || header.version != SESSION_VERSION ||
+		header.stamp != stamp || header.sessionSize != sizeof( clientSession_t ) ) {
+		trap_FS_FCloseFile( f );
+		return qfalse;
+	}
+	trap_FS_Read( sessions, sizeof( sessions ), f );
+
+	// server demos only run until the end of the map
+	if ( !header.restart ) {
+		for ( i = 0 ; i < MAX_CLIENTS ; i++ ) {
+			sessions[i].demopath[0] = '\0';
+		}
+	}
+
+	if ( header.keepStore ) {
+		// already checked to be at least this long
+		PlayerStore_read( f, len - (int)( sizeof( header ) + sizeof( sessions ) ) );
+	}
+	trap_FS_FCloseFile( f );
+
+	return qtrue;
+}
+
+/*
+================
+G_WriteSessionCvars
+
+For when there is no session file.  Server demo paths go into the old
+demopath<client> cvars, and only across a map_restart
+================
+*/
+static void G_WriteSessionCvars( qboolean restart ) {
+	clientSession_t	*sess;
+	int				i;
+
+	for ( i = 0 ; i < MAX_CLIENTS ; i++ ) {
+		sess = &sessions[i];
+		trap_Cvar_Set( va( "session%i", i ), va( "%i %i %i %i %i %i %i %i",
+			sess->sessionTeam,
+			sess->spectatorTime,
+			sess->spectatorState,
+			sess->spectatorClient,
+			sess->wins,
+			sess->losses,
+			sess->teamLeader,
+			sess->specOnly ) );
+		trap_Cvar_Set( va( "demopath%i", i ), restart ? sess->demopath : "" );
+	}
+}
+
+/*
+================
+G_ReadSessionCvars
+
+Runs before level.maxclients is set, so all the slots are read
+================
+*/
+static void G_ReadSessionCvars( void ) {
+	clientSession_t	*sess;
+	char			s[MAX_STRING_CHARS];
+	int				i;
+	int				sessionTeam, spectatorState, teamLeader;
+
+	for ( i = 0 ; i < MAX_CLIENTS ; i++ ) {
+		sess = &sessions[i];
+		memset( sess, 0, sizeof( *sess ) );
+		sessionTeam = spectatorState = teamLeader = 0;
+
+		trap_Cvar_VariableStringBuffer( va( "session%i", i ), s, sizeof(s) );
+		sscanf( s, "%i %i %i %i %i %i %i %i",
+			&sessionTeam,
+			&sess->spectatorTime,
+			&spectatorState,
+			&sess->spectatorClient,
+			&sess->wins,
+			&sess->losses,
+			&teamLeader,
+			&sess->specOnly
+			);
+
+		sess->sessionTeam = (team_t)sessionTeam;
+		sess->spectatorState = (spectatorState_t)spectatorState;
+		sess->teamLeader = (qboolean)teamLeader;
+
+		trap_Cvar_VariableStringBuffer( va( "demopath%i", i ), sess->demopath, sizeof( sess->demopath ) );
+	}
+}
+
 /*
 ================
 G_WriteClientSessionData
@@ -41,23 +181,7 @@ Called on game shutdown
 ================
 */
 void G_WriteClientSessionData( gclient_t *client ) {
-	const char	*s;
-	const char	*var;
-
-	s = va("%i %i %i %i %i %i %i %i", 
-		client->sess.sessionTeam,
-		client->sess.spectatorTime,
-		client->sess.spectatorState,
-		client->sess.spectatorClient,
-		client->sess.wins,
-		client->sess.losses,
-		client->sess.teamLeader,
-		client->sess.specOnly
-		);
-
-	var = va( "session%i", (int)(client - level.clients) );
-
-	trap_Cvar_Set( var, s );
+	sessions[client - level.clients] = client->sess;
 }
 
 /*
@@ -68,32 +192,7 @@ Called on a reconnect
 ================
 */
 void G_ReadSessionData( gclient_t *client ) {
-	char	s[MAX_STRING_CHARS];
-	const char	*var;
-
-	// bk001205 - format
-	int teamLeader;
-	int spectatorState;
-	int sessionTeam;
-
-	var = va( "session%i", (int)(client - level.clients) );
-	trap_Cvar_VariableStringBuffer( var, s, sizeof(s) );
-
-	sscanf( s, "%i %i %i %i %i %i %i %i",
-		&sessionTeam,                 // bk010221 - format
-		&client->sess.spectatorTime,
-		&spectatorState,              // bk010221 - format
-		&client->sess.spectatorClient,
-		&client->sess.wins,
-		&client->sess.losses,
-		&teamLeader,                   // bk010221 - format
-		&client->sess.specOnly
-		);
-
-	// bk001205 - format issues
-	client->sess.sessionTeam = (team_t)sessionTeam;
-	client->sess.spectatorState = (spectatorState_t)spectatorState;
-	client->sess.teamLeader = (qboolean)teamLeader;
+	client->sess = sessions[client - level.clients];
 }
 
 /*
@@ -104,32 +203,16 @@ Called on a reconnect
 ================
 */
 void G_ReadSessionDataRestart( gclient_t *client ) {
-	char	s[MAX_STRING_CHARS];
-	const char	*var;
-
-	// bk001205 - format
-	int teamLeader;
-	int spectatorState;
-	int sessionTeam;
-
-	var = va( "session%i", (int)(client - level.clients) );
-	trap_Cvar_VariableStringBuffer( var, s, sizeof(s) );
-
-	sscanf( s, "%i %i %i %i %i %i %i %i",
-		&sessionTeam,                 // bk010221 - format
-		&client->sess.spectatorTime,
-		&spectatorState,              // bk010221 - format
-		&client->sess.spectatorClient,
-		&client->sess.wins,
-		&client->sess.losses,
-		&teamLeader,                   // bk010221 - format
-		&client->sess.specOnly
-		);
-
-	// bk001205 - format issues
-	//client->sess.sessionTeam = (team_t)sessionTeam;
-	client->sess.spectatorState = (spectatorState_t)spectatorState;
-	//client->sess.teamLeader = (qboolean)teamLeader;
+	team_t		sessionTeam;
+	qboolean	teamLeader;
+
+	sessionTeam = client->sess.sessionTeam;
+	teamLeader = client->sess.teamLeader;
+
+	client->sess = sessions[client - level.clients];
+
+	client->sess.sessionTeam = sessionTeam;
+	client->sess.teamLeader = teamLeader;
 }
 
 
@@ -200,16 +283,32 @@ G_InitWorldSession
 */
 void G_InitWorldSession( void ) {
 	char	s[MAX_STRING_CHARS];
-	int			gt;
+	int			gt, stamp;
+
+	// the player store only comes back with the session file
+	PlayerStoreInit();
 
 	trap_Cvar_VariableStringBuffer( "session", s, sizeof(s) );
-	gt = atoi( s );
+	gt = stamp = 0;
+	sscanf( s, "%i %i", &gt, &stamp );
 	
 	// if the gametype changed since the last session, don't use any
 	// client sessions
 	if ( g_gametype.integer != gt ) {
 		level.newSession = qtrue;
                 G_Printf( "Gametype changed, clearing session data.\n" );
+		return;
+	}
+
+	// no file could be written last time
+	if ( s[0] && !stamp ) {
+		G_ReadSessionCvars();
+		return;
+	}
+
+	if ( s[0] && !G_ReadSessionFile( stamp ) ) {
+		level.newSession = qtrue;
+		G_Printf( "Session file is missing or out of date, clearing session data.\n" );
 	}
 }
 
@@ -217,18 +316,46 @@ void G_InitWorldSession( void ) {
 ==================
 G_WriteSessionData
 
+The player store is only kept across a map_restart in the middle of a
+match, not into a new map or from the warmup into the match
 ==================
 */
-void G_WriteSessionData( void ) {
+void G_WriteSessionData( qboolean restart ) {
+	sessionHeader_t	header;
+	fileHandle_t	f;
+	qtime_t			now;
 	int		i;
 
-	trap_Cvar_Set( "session", va("%i", g_gametype.integer) );
-
 	for ( i = 0 ; i < level.maxclients ; i++ ) {
 		if ( level.clients[i].pers.connected == CON_CONNECTED ) {
 			G_WriteClientSessionData( &level.clients[i] );
 		}
 	}
+
+	header.ident = SESSION_IDENT;
+	header.version = SESSION_VERSION;
+	header.stamp = trap_RealTime( &now ) ^ ( trap_Milliseconds() << 8 );
+	if ( !header.stamp ) {
+		header.stamp = 1;
+	}
+	header.gametype = g_gametype.integer;
+	header.restart = restart;
+	header.keepStore = restart && !level.warmupTime && !level.intermissiontime;
+	header.sessionSize = sizeof( clientSession_t );
+
+	trap_FS_FOpenFile( G_SessionFile(), &f, FS_WRITE );
+	if ( !f ) {
+		G_Printf( "WARNING: Couldn't write session file %s, using cvars\n", G_SessionFile() );
+		G_WriteSessionCvars( restart );
+		trap_Cvar_Set( "session", va("%i 0", g_gametype.integer) );
+		return;
+	}
+	trap_FS_Write( &header, sizeof( header ), f );
+	trap_FS_Write( sessions, sizeof( sessions ), f );
+	PlayerStore_write( f );
+	trap_FS_FCloseFile( f );
+
+	trap_Cvar_Set( "session", va("%i %i", g_gametype.integer, header.stamp) );
 	
 	// write values for sv_maxclients and sv_democlients because they invalidate session data
 	/*trap_Cvar_Set( "session", va( "%i %i", 
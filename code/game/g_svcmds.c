@@ -30,17 +30,25 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ==============================================================================
 
 PACKET FILTERING
- 
+
 
 You can add or remove addresses from the filter list with:
 
 addip <ip>
 removeip <ip>
 
-The ip address is specified in dot format, and you can use '*' to match any value
-so you can specify an entire class C network with "addip 192.246.40.*"
+An address is either IPv4 in dot format or IPv6 in colon format, optionally
+followed by a CIDR prefix length: "addip 10.0.0.0/8", "addip 2001:db8::/32".
+For IPv4 you can also use '*' to match any value in the trailing octets, so you
+can specify an entire class C network with "addip 192.246.40.*"
+
+Removeip will only remove a range specified with the same prefix.  You cannot addip a subnet, then removeip a single host.
 
-Removeip will only remove an address specified exactly the same way.  You cannot addip a subnet, then removeip a single host.
+addipfile <file>
+Adds every address in a file, one per line.  Anything after the address on a
+line, and lines starting with '#', ';' or "//", are ignored, so most published
+blocklists can be imported as they are.  The file is read from the game
+directory.
 
 listip
 Prints the current list of filters.
@@ -51,154 +59,759 @@ If 1 (the default), then ip addresses matching the current list will be prohibit
 
 If 0, then only addresses matching the list will be allowed.  This lets you easily set up a private game, or a game that only allows players from your local network.
 
-TTimo NOTE: for persistence, bans are stored in g_banIPs cvar MAX_CVAR_VALUE_STRING
-The size of the cvar string buffer is limiting the banning to around 20 masks
-this could be improved by putting some g_banIPs2 g_banIps3 etc. maybe
-still, you should rely on PB for banning instead
+The filters are kept in a binary trie per address family, one bit per level,
+so checking an address costs at most one step per bit of the longest prefix
+whatever the number of filters.  They are stored in the file named by
+g_banIPFile and read back in G_ProcessIPBans.  Filters left in the old g_banIPs
+cvar are moved into that file the next time it is loaded.
 
 ==============================================================================
 */
 
+#define	IPF_INET		0
+#define	IPF_INET6		1
+
 typedef struct ipFilter_s
 {
-	unsigned	mask;
-	unsigned	compare;
+	int		family;
+	int		bits;		// prefix length
+	byte	addr[16];	// network byte order, IPv4 in the first 4 bytes
 } ipFilter_t;
 
-#define	MAX_IPFILTERS	1024
-
-static ipFilter_t	ipFilters[MAX_IPFILTERS];
+typedef struct ipFilterNode_s
+{
+	byte	addr[16];
+	byte	bits;		// length of the prefix held in addr
+	byte	match;		// a filter, not just a branch point
+	int		child[2];	// 0 if none
+} ipFilterNode_t;
+
+#define	MAX_IPFILTER_NODES	131072
+
+// Path compressed: a node is only kept where a filter ends or where two
+// filters part ways, so n filters never need more than 2n nodes.  Node 0 is
+// unused so that 0 can mean "no child", 1 and 2 are the /0 roots.
+static ipFilterNode_t	ipFilterNodes[MAX_IPFILTER_NODES];
+static int			numIPFilterNodes;
+static int			ipFilterFreeList;	// linked through child[0]
+static int			numFreeIPFilterNodes;
 static int			numIPFilters;
 
+static const int	ipFilterRoot[2] = { 1, 2 };
+static const int	ipFilterMaxBits[2] = { 32, 128 };
+
+#define	IPF_BIT(a,i)	(((a)[(i)>>3] >> (7 - ((i)&7))) & 1)
+
+typedef enum {
+	IPF_ADDED,
+	IPF_EXISTS,
+	IPF_FULL
+} ipFilterResult_t;
+
 /*
 =================
-StringToFilter
+ClearIPFilters
 =================
 */
-static qboolean StringToFilter (char *s, ipFilter_t *f)
+static void ClearIPFilters( void )
 {
-	char	num[128];
-	int		i, j;
-	byte	b[4];
-	byte	m[4];
-	
-	for (i=0 ; i<4 ; i++)
-	{
+	memset( ipFilterNodes, 0, sizeof( ipFilterNodes[0] ) * 3 );
+	numIPFilterNodes = 3;
+	ipFilterFreeList = 0;
+	numFreeIPFilterNodes = 0;
+	numIPFilters = 0;
+}
+
+/*
+=================
+AllocIPFilterNode
+
+Returns a node holding the first bits of addr
+=================
+*/
+static int AllocIPFilterNode( const byte *addr, int bits )
+{
+	ipFilterNode_t	*node;
+	int				n;
+
+	if ( ipFilterFreeList ) {
+		n = ipFilterFreeList;
+		ipFilterFreeList = ipFilterNodes[n].child[0];
+		numFreeIPFilterNodes--;
+	} else {
+		n = numIPFilterNodes++;
+	}
+
+	node = &ipFilterNodes[n];
+	memset( node, 0, sizeof( *node ) );
+	memcpy( node->addr, addr, ( bits + 7 ) >> 3 );
+	if ( bits & 7 )
+		node->addr[bits >> 3] &= 0xff00 >> ( bits & 7 );
+	node->bits = bits;
+	return n;
+}
+
+/*
+=================
+FreeIPFilterNode
+=================
+*/
+static void FreeIPFilterNode( int n )
+{
+	ipFilterNodes[n].child[0] = ipFilterFreeList;
+	ipFilterFreeList = n;
+	numFreeIPFilterNodes++;
+}
+
+/*
+=================
+CommonIPBits
+
+Returns the first bit in [from, to) where a and b differ, or to
+=================
+*/
+static int CommonIPBits( const byte *a, const byte *b, int from, int to )
+{
+	int		i, x;
+
+	for ( i = from ; i < to ; i = ( i & ~7 ) + 8 ) {
+		x = ( a[i >> 3] ^ b[i >> 3] ) & ( 0xff >> ( i & 7 ) );
+		if ( !x )
+			continue;
+		for ( i &= ~7 ; !( x & 0x80 ) ; x <<= 1 )
+			i++;
+		return i < to ? i : to;
+	}
+	return to;
+}
+
+/*
+=================
+InsertIPFilter
+=================
+*/
+static ipFilterResult_t InsertIPFilter( const ipFilter_t *f )
+{
+	ipFilterNode_t	*node, *c;
+	int				n, m, next, b, common;
+
+	c = NULL;
+	common = 0;
+	node = &ipFilterNodes[ipFilterRoot[f->family]];
+	while ( 1 ) {
+		// node holds a prefix of f
+		if ( node->bits == f->bits ) {
+			if ( node->match )
+				return IPF_EXISTS;
+			node->match = 1;
+			numIPFilters++;
+			return IPF_ADDED;
+		}
+
+		b = IPF_BIT( f->addr, node->bits );
+		next = node->child[b];
+		if ( !next )
+			break;
+		c = &ipFilterNodes[next];
+		common = CommonIPBits( c->addr, f->addr, node->bits + 1, c->bits < f->bits ? c->bits : f->bits );
+		if ( common < c->bits )
+			break;
+		node = c;
+	}
+
+	if ( MAX_IPFILTER_NODES - numIPFilterNodes + numFreeIPFilterNodes < 2 )
+		return IPF_FULL;
+
+	n = AllocIPFilterNode( f->addr, f->bits );
+	ipFilterNodes[n].match = 1;
+	numIPFilters++;
+
+	if ( !next ) {
+		node->child[b] = n;
+	} else if ( common == f->bits ) {
+		// f is a prefix of the child, so goes in between
+		ipFilterNodes[n].child[IPF_BIT( c->addr, f->bits )] = next;
+		node->child[b] = n;
+	} else {
+		// they part ways below both, so add a branch point there
+		m = AllocIPFilterNode( f->addr, common );
+		ipFilterNodes[m].child[IPF_BIT( f->addr, common )] = n;
+		ipFilterNodes[m].child[IPF_BIT( c->addr, common )] = next;
+		node->child[b] = m;
+	}
+
+	return IPF_ADDED;
+}
+
+/*
+=================
+RemoveIPFilter
+
+Also drops the nodes that are no longer needed as branch points
+=================
+*/
+static qboolean RemoveIPFilter( const ipFilter_t *f )
+{
+	ipFilterNode_t	*node;
+	int				n, parent, grand, pb, gb, next, b;
+
+	grand = gb = 0;
+	parent = pb = 0;
+	n = ipFilterRoot[f->family];
+	while ( ipFilterNodes[n].bits < f->bits ) {
+		b = IPF_BIT( f->addr, ipFilterNodes[n].bits );
+		next = ipFilterNodes[n].child[b];
+		if ( !next || ipFilterNodes[next].bits > f->bits ||
+			CommonIPBits( ipFilterNodes[next].addr, f->addr, ipFilterNodes[n].bits + 1, ipFilterNodes[next].bits ) < ipFilterNodes[next].bits )
+			return qfalse;
+		grand = parent;
+		gb = pb;
+		parent = n;
+		pb = b;
+		n = next;
+	}
+
+	node = &ipFilterNodes[n];
+	if ( !node->match )
+		return qfalse;
+
+	node->match = 0;
+	numIPFilters--;
+
+	if ( !parent )
+		return qtrue;	// a root
+
+	if ( node->child[0] && node->child[1] )
+		return qtrue;	// still a branch point
+
+	// hand the remaining child, if any, to the parent
+	ipFilterNodes[parent].child[pb] = node->child[0] | node->child[1];
+	FreeIPFilterNode( n );
+
+	// the parent may now be a branch point with only one branch
+	node = &ipFilterNodes[parent];
+	if ( grand && !node->match && !( node->child[0] && node->child[1] ) ) {
+		ipFilterNodes[grand].child[gb] = node->child[0] | node->child[1];
+		FreeIPFilterNode( parent );
+	}
+
+	return qtrue;
+}
+
+/*
+=================
+MatchIPFilter
+
+Returns qtrue if any filter covers the address
+=================
+*/
+static qboolean MatchIPFilter( int family, const byte *addr )
+{
+	ipFilterNode_t	*node, *c;
+	int				next;
+
+	node = &ipFilterNodes[ipFilterRoot[family]];
+	while ( !node->match ) {
+		if ( node->bits == ipFilterMaxBits[family] )
+			return qfalse;
+		next = node->child[IPF_BIT( addr, node->bits )];
+		if ( !next )
+			return qfalse;
+		c = &ipFilterNodes[next];
+		if ( CommonIPBits( c->addr, addr, node->bits + 1, c->bits ) < c->bits )
+			return qfalse;
+		node = c;
+	}
+	return qtrue;
+}
+
+/*
+=================
+WalkIPFilters
+
+Calls func for every filter below node, in address order
+=================
+*/
+static void WalkIPFilters( int family, int n, void (*func)( const ipFilter_t *f, void *data ), void *data )
+{
+	ipFilterNode_t	*node;
+	ipFilter_t		f;
+	int				i;
+
+	node = &ipFilterNodes[n];
+	if ( node->match ) {
+		f.family = family;
+		f.bits = node->bits;
+		memcpy( f.addr, node->addr, sizeof( f.addr ) );
+		func( &f, data );
+	}
+
+	for ( i = 0 ; i < 2 ; i++ ) {
+		if ( node->child[i] )
+			WalkIPFilters( family, node->child[i], func, data );
+	}
+}
+
+/*
+=================
+ForEachIPFilter
+=================
+*/
+static void ForEachIPFilter( void (*func)( const ipFilter_t *f, void *data ), void *data )
+{
+	WalkIPFilters( IPF_INET, ipFilterRoot[IPF_INET], func, data );
+	WalkIPFilters( IPF_INET6, ipFilterRoot[IPF_INET6], func, data );
+}
+
+/*
+=================
+ParseIPv4
+
+Reads up to four dot separated octets.  Trailing octets may be '*', and
+*octets is set to the number of octets before the first one that isn't given.
+=================
+*/
+static qboolean ParseIPv4( char **s, byte *b, int *octets )
+{
+	char	*p;
+	int		i, v, digits;
+
+	p = *s;
+	*octets = 0;
+	for ( i = 0 ; i < 4 ; i++ ) {
 		b[i] = 0;
-		m[i] = 0;
 	}
-	
-	for (i=0 ; i<4 ; i++)
-	{
-		if (*s < '0' || *s > '9')
-		{
-			if (*s == '*') // 'match any'
-			{
-				// b[i] and m[i] to 0
-				s++;
-				if (!*s)
-					break;
-				s++;
-				continue;
+
+	for ( i = 0 ; i < 4 ; i++ ) {
+		if ( *p == '*' ) {
+			p++;
+		} else {
+			if ( *octets != i )
+				return qfalse;	// a number after a wildcard
+			v = 0;
+			for ( digits = 0 ; *p >= '0' && *p <= '9' ; digits++, p++ ) {
+				v = v * 10 + *p - '0';
+				if ( v > 255 )
+					return qfalse;
 			}
-                        G_Printf( "Bad filter address: %s\n", s );
+			if ( !digits )
+				return qfalse;
+			b[i] = v;
+			(*octets)++;
+		}
+		if ( *p != '.' || i == 3 )
+			break;
+		p++;
+	}
+
+	*s = p;
+	return qtrue;
+}
+
+/*
+=================
+HexDigit
+=================
+*/
+static int HexDigit( int c )
+{
+	if ( c >= '0' && c <= '9' )
+		return c - '0';
+	if ( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	if ( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+=================
+ParseIPv6
+
+Reads a colon separated address, with at most one "::" and an optional
+dotted IPv4 tail
+=================
+*/
+static qboolean ParseIPv6( char **s, byte *addr )
+{
+	unsigned	groups[8];
+	char		*p, *start;
+	byte		b[4];
+	int			n, gap, digits, octets, i, j;
+	unsigned	v;
+
+	p = *s;
+	n = 0;
+	gap = -1;
+
+	if ( p[0] == ':' ) {
+		if ( p[1] != ':' )
 			return qfalse;
+		gap = 0;
+		p += 2;
+	}
+
+	while ( n < 8 ) {
+		start = p;
+		v = 0;
+		for ( digits = 0 ; HexDigit( *p ) >= 0 ; digits++, p++ ) {
+			v = v * 16 + HexDigit( *p );
 		}
-		
-		j = 0;
-		while (*s >= '0' && *s <= '9')
-		{
-			num[j++] = *s++;
+		if ( !digits )
+			break;
+		if ( *p == '.' ) {
+			p = start;
+			if ( n > 6 || !ParseIPv4( &p, b, &octets ) || octets != 4 )
+				return qfalse;
+			groups[n++] = ( b[0] << 8 ) | b[1];
+			groups[n++] = ( b[2] << 8 ) | b[3];
+			break;
 		}
-		num[j] = 0;
-		b[i] = atoi(num);
-		m[i] = 255;
-
-		if (!*s)
+		if ( digits > 4 )
+			return qfalse;
+		groups[n++] = v;
+		if ( *p != ':' )
 			break;
-		s++;
+		if ( p[1] == ':' ) {
+			if ( gap >= 0 )
+				return qfalse;
+			gap = n;
+			p += 2;
+			continue;
+		}
+		p++;
+		if ( HexDigit( *p ) < 0 )
+			return qfalse;
 	}
-	
-	f->mask = *(unsigned *)m;
-	f->compare = *(unsigned *)b;
-	
+
+	if ( gap < 0 ? n != 8 : n > 7 )
+		return qfalse;
+
+	// the groups after a "::" go to the end
+	memset( addr, 0, 16 );
+	for ( i = 0 ; i < n ; i++ ) {
+		j = ( gap >= 0 && i >= gap ) ? 8 - n + i : i;
+		addr[j * 2] = groups[i] >> 8;
+		addr[j * 2 + 1] = groups[i] & 255;
+	}
+
+	*s = p;
 	return qtrue;
 }
 
 /*
 =================
-UpdateIPBans
+UnmapIPv4
+
+Turns an IPv4-mapped IPv6 filter (::ffff:a.b.c.d) into a plain IPv4 one,
+so that both spellings land in the same trie
 =================
 */
-static void UpdateIPBans (void)
+static void UnmapIPv4( ipFilter_t *f )
 {
-	byte	b[4];
-	byte	m[4];
-	int		i,j;
-	char	iplist_final[MAX_CVAR_VALUE_STRING];
-	char	ip[64];
+	static const byte	mapped[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
 
-	*iplist_final = 0;
-	for (i = 0 ; i < numIPFilters ; i++)
-	{
-		if (ipFilters[i].compare == 0xffffffff)
-			continue;
+	if ( f->family != IPF_INET6 || f->bits < 96 || CommonIPBits( f->addr, mapped, 0, 96 ) < 96 )
+		return;
 
-		*(unsigned *)b = ipFilters[i].compare;
-		*(unsigned *)m = ipFilters[i].mask;
-		*ip = 0;
-		for (j = 0 ; j < 4 ; j++)
-		{
-			if (m[j]!=255)
-				Q_strcat(ip, sizeof(ip), "*");
-			else
-				Q_strcat(ip, sizeof(ip), va("%i", b[j]));
-			Q_strcat(ip, sizeof(ip), (j<3) ? "." : " ");
-		}		
-		if (strlen(iplist_final)+strlen(ip) < MAX_CVAR_VALUE_STRING)
-		{
-			Q_strcat( iplist_final, sizeof(iplist_final), ip);
+	memmove( f->addr, f->addr + 12, 4 );
+	memset( f->addr + 4, 0, 12 );
+	f->family = IPF_INET;
+	f->bits -= 96;
+}
+
+/*
+=================
+StringToFilter
+=================
+*/
+static qboolean StringToFilter (char *s, ipFilter_t *f)
+{
+	int		octets, bits, i;
+	qboolean	bracket;
+
+	memset( f, 0, sizeof( *f ) );
+
+	if ( strchr( s, ':' ) ) {
+		bracket = ( *s == '[' );
+		if ( bracket )
+			s++;
+		if ( !ParseIPv6( &s, f->addr ) )
+			return qfalse;
+		if ( bracket && *s++ != ']' )
+			return qfalse;
+		f->family = IPF_INET6;
+		f->bits = 128;
+	} else {
+		if ( !ParseIPv4( &s, f->addr, &octets ) )
+			return qfalse;
+		f->family = IPF_INET;
+		f->bits = octets * 8;
+		if ( *s == '/' && octets != 4 )
+			return qfalse;	// either a wildcard or a prefix length, not both
+	}
+
+	if ( *s == '/' ) {
+		s++;
+		if ( *s < '0' || *s > '9' )
+			return qfalse;
+		for ( bits = 0 ; *s >= '0' && *s <= '9' ; s++ ) {
+			bits = bits * 10 + *s - '0';
+			if ( bits > ipFilterMaxBits[f->family] )
+				return qfalse;
 		}
-		else
-		{
-			Com_Printf("g_banIPs overflowed at MAX_CVAR_VALUE_STRING\n");
-			break;
+		f->bits = bits;
+	}
+
+	if ( *s )
+		return qfalse;
+
+	// clear the host part so that "10.1.2.3/8" and "10.0.0.0/8" are the same filter
+	for ( i = f->bits ; i < 128 ; i++ ) {
+		f->addr[i >> 3] &= ~(0x80 >> (i & 7));
+	}
+
+	UnmapIPv4( f );
+	return qtrue;
+}
+
+/*
+=================
+FilterToString
+=================
+*/
+static void FilterToString( const ipFilter_t *f, char *out, int size )
+{
+	int		i, best, bestLen, run, group;
+	char	*sep;
+
+	if ( f->family == IPF_INET ) {
+		Com_sprintf( out, size, "%i.%i.%i.%i", f->addr[0], f->addr[1], f->addr[2], f->addr[3] );
+	} else {
+		// collapse the longest run of zero groups into "::"
+		best = -1;
+		bestLen = 1;
+		for ( i = 0 ; i < 8 ; i += run ? run : 1 ) {
+			for ( run = 0 ; i + run < 8 && !f->addr[( i + run ) * 2] && !f->addr[( i + run ) * 2 + 1] ; run++ )
+				;
+			if ( run > bestLen ) {
+				best = i;
+				bestLen = run;
+			}
+		}
+
+		*out = 0;
+		sep = "";
+		for ( i = 0 ; i < 8 ; i++ ) {
+			if ( i == best ) {
+				Q_strcat( out, size, "::" );
+				sep = "";
+				i += bestLen - 1;
+				continue;
+			}
+			group = ( f->addr[i * 2] << 8 ) | f->addr[i * 2 + 1];
+			Q_strcat( out, size, va( "%s%x", sep, group ) );
+			sep = ":";
 		}
 	}
 
-	trap_Cvar_Set( "g_banIPs", iplist_final );
+	if ( f->bits != ipFilterMaxBits[f->family] )
+		Q_strcat( out, size, va( "/%i", f->bits ) );
+}
+
+/*
+=================
+WriteIPFilter
+=================
+*/
+typedef struct {
+	fileHandle_t	file;
+	char			buffer[4096];
+	int				length;
+} ipFilterWriter_t;
+
+static void WriteIPFilter( const ipFilter_t *f, void *data )
+{
+	ipFilterWriter_t	*w = data;
+	char				str[64];
+	int					len;
+
+	FilterToString( f, str, sizeof( str ) );
+	Q_strcat( str, sizeof( str ), "\n" );
+	len = strlen( str );
+	if ( w->length + len > sizeof( w->buffer ) ) {
+		trap_FS_Write( w->buffer, w->length, w->file );
+		w->length = 0;
+	}
+	memcpy( w->buffer + w->length, str, len );
+	w->length += len;
+}
+
+/*
+=================
+SaveIPBans
+=================
+*/
+static void SaveIPBans (void)
+{
+	ipFilterWriter_t	w;
+
+	if ( !g_banIPFile.string[0] )
+		return;
+
+	if ( trap_FS_FOpenFile( g_banIPFile.string, &w.file, FS_WRITE ) < 0 ) {
+		G_Printf( "Couldn't write IP filters to %s\n", g_banIPFile.string );
+		return;
+	}
+
+	Q_strncpyz( w.buffer, "// written by addip/removeip, one address or range per line\n", sizeof( w.buffer ) );
+	w.length = strlen( w.buffer );
+	ForEachIPFilter( WriteIPFilter, &w );
+	trap_FS_Write( w.buffer, w.length, w.file );
+	trap_FS_FCloseFile( w.file );
+}
+
+typedef struct {
+	const char	*filename;
+	int			line;
+	int			added;
+	int			full;
+	int			bad;
+} ipFilterLoad_t;
+
+/*
+=================
+LoadIPFilterLine
+=================
+*/
+static void LoadIPFilterLine( ipFilterLoad_t *l, char *line )
+{
+	ipFilter_t	f;
+	char		*s, *end;
+
+	l->line++;
+
+	s = line;
+	while ( *s == ' ' || *s == '\t' )
+		s++;
+	if ( !*s || *s == '#' || *s == ';' || ( s[0] == '/' && s[1] == '/' ) )
+		return;
+
+	for ( end = s ; *end && *end != ' ' && *end != '\t' && *end != ';' && *end != '#' && *end != ',' ; end++ )
+		;
+	*end = 0;
+
+	if ( !StringToFilter( s, &f ) ) {
+		if ( ++l->bad <= 10 )
+			G_Printf( "%s:%i: bad filter address: %s\n", l->filename, l->line, s );
+		return;
+	}
+
+	switch ( InsertIPFilter( &f ) ) {
+	case IPF_ADDED:
+		l->added++;
+		break;
+	case IPF_FULL:
+		l->full++;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+=================
+LoadIPFilterFile
+
+Adds every address in a file, reading it a piece at a time so that
+blocklists of any size fit.  Returns the number of filters added, or -1 if
+the file couldn't be opened.
+=================
+*/
+static int LoadIPFilterFile( const char *filename )
+{
+	ipFilterLoad_t	l;
+	fileHandle_t	f;
+	char			buffer[4096];
+	char			line[128];
+	int				len, pos, chunk, i, lineLen;
+
+	len = trap_FS_FOpenFile( filename, &f, FS_READ );
+	if ( len < 0 || !f )
+		return -1;
+
+	memset( &l, 0, sizeof( l ) );
+	l.filename = filename;
+	lineLen = 0;
+	for ( pos = 0 ; pos < len ; pos += chunk ) {
+		chunk = len - pos;
+		if ( chunk > sizeof( buffer ) )
+			chunk = sizeof( buffer );
+		trap_FS_Read( buffer, chunk, f );
+
+		for ( i = 0 ; i < chunk ; i++ ) {
+			if ( buffer[i] == '\n' ) {
+				line[lineLen] = 0;
+				LoadIPFilterLine( &l, line );
+				lineLen = 0;
+			} else if ( buffer[i] != '\r' && lineLen < sizeof( line ) - 1 ) {
+				line[lineLen++] = buffer[i];
+			}
+		}
+	}
+	trap_FS_FCloseFile( f );
+
+	// the last line may not end in a newline
+	line[lineLen] = 0;
+	LoadIPFilterLine( &l, line );
+
+	if ( l.bad > 10 )
+		G_Printf( "%s: %i more bad lines\n", filename, l.bad - 10 );
+	if ( l.full )
+		G_Printf( "IP filter list is full, %i ranges from %s were dropped\n", l.full, filename );
+
+	return l.added;
 }
 
 /*
 =================
 G_FilterPacket
+
+from is the "ip" userinfo value: "a.b.c.d:port" or "[ipv6]:port"
 =================
 */
 qboolean G_FilterPacket (char *from)
 {
-	int		i;
-	unsigned	in;
-	byte m[4];
-	char *p;
+	ipFilter_t	f;
+	char		*p;
+	int			octets;
 
-	i = 0;
 	p = from;
-	while (*p && i < 4) {
-		m[i] = 0;
-		while (*p >= '0' && *p <= '9') {
-			m[i] = m[i]*10 + (*p - '0');
-			p++;
-		}
-		if (!*p || *p == ':')
-			break;
-		i++, p++;
+	memset( &f, 0, sizeof( f ) );
+
+	if ( *p == '[' ) {
+		p++;
+		if ( !ParseIPv6( &p, f.addr ) || *p != ']' )
+			return qfalse;
+		f.family = IPF_INET6;
+		f.bits = 128;
+		UnmapIPv4( &f );
+	} else if ( strchr( p, ':' ) != Q_strrchr( p, ':' ) ) {
+		// a bare IPv6 address without a port
+		if ( !ParseIPv6( &p, f.addr ) || *p )
+			return qfalse;
+		f.family = IPF_INET6;
+		f.bits = 128;
+		UnmapIPv4( &f );
+	} else {
+		// "localhost", "bot" and the like never match
+		if ( !ParseIPv4( &p, f.addr, &octets ) || octets != 4 || ( *p && *p != ':' ) )
+			return qfalse;
+		f.family = IPF_INET;
 	}
-	
-	in = *(unsigned *)m;
 
-	for (i=0 ; i<numIPFilters ; i++)
-		if ( (in & ipFilters[i].mask) == ipFilters[i].compare)
-			return g_filterBan.integer != 0;
+	if ( MatchIPFilter( f.family, f.addr ) )
+		return g_filterBan.integer != 0;
 
 	return g_filterBan.integer == 0;
 }
@@ -210,25 +823,25 @@ AddIP
 */
 static void AddIP( char *str )
 {
-	int		i;
+	ipFilter_t	f;
 
-	for (i = 0 ; i < numIPFilters ; i++)
-		if (ipFilters[i].compare == 0xffffffff)
-			break;		// free spot
-	if (i == numIPFilters)
-	{
-		if (numIPFilters == MAX_IPFILTERS)
-		{
-                        G_Printf ("IP filter list is full\n");
-			return;
-		}
-		numIPFilters++;
+	if ( !StringToFilter( str, &f ) ) {
+		G_Printf( "Bad filter address: %s\n", str );
+		return;
 	}
-	
-	if (!StringToFilter (str, &ipFilters[i]))
-		ipFilters[i].compare = 0xffffffffu;
 
-	UpdateIPBans();
+	switch ( InsertIPFilter( &f ) ) {
+	case IPF_FULL:
+		G_Printf( "IP filter list is full\n" );
+		return;
+	case IPF_EXISTS:
+		G_Printf( "%s is already filtered\n", str );
+		return;
+	default:
+		break;
+	}
+
+	SaveIPBans();
 }
 
 /*
@@ -236,23 +849,39 @@ static void AddIP( char *str )
 G_ProcessIPBans
 =================
 */
-void G_ProcessIPBans(void) 
+void G_ProcessIPBans(void)
 {
-	char *s, *t;
+	char		*s, *t;
 	char		str[MAX_CVAR_VALUE_STRING];
+	ipFilter_t	f;
+	int			added;
 
-	Q_strncpyz( str, g_banIPs.string, sizeof(str) );
+	ClearIPFilters();
+
+	if ( g_banIPFile.string[0] )
+		LoadIPFilterFile( g_banIPFile.string );
 
-	for (t = s = g_banIPs.string; *t; /* */ ) {
+	// move filters saved by older versions into the file
+	Q_strncpyz( str, g_banIPs.string, sizeof(str) );
+	added = 0;
+	for ( t = s = str; *t; /* */ ) {
 		s = strchr(s, ' ');
-		if (!s)
+		if ( s ) {
+			while (*s == ' ')
+				*s++ = 0;
+		}
+		if ( *t && StringToFilter( t, &f ) && InsertIPFilter( &f ) == IPF_ADDED )
+			added++;
+		if ( !s )
 			break;
-		while (*s == ' ')
-			*s++ = 0;
-		if (*t)
-			AddIP( t );
 		t = s;
 	}
+
+	if ( g_banIPs.string[0] && g_banIPFile.string[0] ) {
+		if ( added )
+			SaveIPBans();
+		trap_Cvar_Set( "g_banIPs", "" );
+	}
 }
 
 
@@ -276,6 +905,34 @@ void Svcmd_AddIP_f (void)
 
 }
 
+/*
+=================
+Svcmd_AddIPFile_f
+=================
+*/
+void Svcmd_AddIPFile_f (void)
+{
+	char		str[MAX_TOKEN_CHARS];
+	int			added;
+
+	if ( trap_Argc() < 2 ) {
+                G_Printf("Usage:  addipfile <file>\n");
+		return;
+	}
+
+	trap_Argv( 1, str, sizeof( str ) );
+
+	added = LoadIPFilterFile( str );
+	if ( added < 0 ) {
+                G_Printf( "Couldn't open %s\n", str );
+		return;
+	}
+
+        G_Printf( "Added %i filters from %s, %i in total\n", added, str, numIPFilters );
+	if ( added )
+		SaveIPBans();
+}
+
 /*
 =================
 Svcmd_RemoveIP_f
@@ -284,7 +941,6 @@ Svcmd_RemoveIP_f
 void Svcmd_RemoveIP_f (void)
 {
 	ipFilter_t	f;
-	int			i;
 	char		str[MAX_TOKEN_CHARS];
 
 	if ( trap_Argc() < 2 ) {
@@ -294,22 +950,44 @@ void Svcmd_RemoveIP_f (void)
 
 	trap_Argv( 1, str, sizeof( str ) );
 
-	if (!StringToFilter (str, &f))
+	if (!StringToFilter (str, &f)) {
+                G_Printf( "Bad filter address: %s\n", str );
 		return;
+	}
 
-	for (i=0 ; i<numIPFilters ; i++) {
-		if (ipFilters[i].mask == f.mask	&&
-			ipFilters[i].compare == f.compare) {
-			ipFilters[i].compare = 0xffffffffu;
-                        G_Printf ("Removed.\n");
-
-			UpdateIPBans();
-			return;
-		}
+	if ( RemoveIPFilter( &f ) ) {
+                G_Printf ("Removed.\n");
+		SaveIPBans();
+		return;
 	}
         G_Printf ( "Didn't find %s.\n", str );
 }
 
+/*
+=================
+PrintIPFilter
+=================
+*/
+static void PrintIPFilter( const ipFilter_t *f, void *data )
+{
+	char	str[64];
+
+	FilterToString( f, str, sizeof( str ) );
+	G_Printf( "%s\n", str );
+}
+
+/*
+=================
+Svcmd_ListIP_f
+=================
+*/
+void Svcmd_ListIP_f (void)
+{
+	ForEachIPFilter( PrintIPFilter, NULL );
+        G_Printf( "%i filters, %i of %i trie nodes in use\n", numIPFilters,
+		numIPFilterNodes - numFreeIPFilterNodes, MAX_IPFILTER_NODES );
+}
+
 /*
 ===================
 Svcmd_EntityList_f
@@ -586,9 +1264,10 @@ struct
   { "abort_podium", qfalse, Svcmd_AbortPodium_f },
   { "addip", qfalse, Svcmd_AddIP_f },
   { "removeip", qfalse, Svcmd_RemoveIP_f },
-  
-  //KK-OAX Uses wrapper in g_svccmds_ext.c
+  { "addipfile", qfalse, Svcmd_AddIPFile_f },
   { "listip", qfalse, Svcmd_ListIP_f }, 
+  { "logstats", qfalse, Svcmd_LogStats_f },
+  { "cmdstats", qfalse, Svcmd_CommandStats_f },
   //KK-OAX New
   { "status", qfalse, Svcmd_Status_f },
   { "eject", qfalse, Svcmd_EjectClient_f },
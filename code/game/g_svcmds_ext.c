@@ -216,17 +216,6 @@ void Svcmd_Chat_f( void )
     G_LogPrintf("chat: %s\n", ConcatArgs( 1 ) );
 }
 
-/*
-=============
-Svcmd_ListIP_f
-Dumb Wrapper for the trap_Send command
-=============
-*/
-void Svcmd_ListIP_f( void )
-{
-    trap_SendConsoleCommand( EXEC_NOW, "g_banIPs\n" );
-}
-
 /*
 =============
 Svcmd_MessageWrapper
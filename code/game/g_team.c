@@ -424,10 +424,12 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
                  attacker->client->pers.netname, TeamName(team));
         if (g_gametype.integer == GT_CTF) {
             G_LogPrintf( "CTF: %i %i %i: %s fragged %s's flag carrier!\n", attacker->client->ps.clientNum, team, 3, attacker->client->pers.netname, TeamName(team) );
+            G_LogEvent( "ctf", "iii", "client", attacker->client->ps.clientNum, "team", team, "action", 3 );
         } else if (g_gametype.integer == GT_CTF_ELIMINATION) {
             G_LogPrintf( "CTF_ELIMINATION: %i %i %i %i: %s fragged %s's flag carrier!\n", level.roundNumber, attacker->client->ps.clientNum, team, 3, attacker->client->pers.netname, TeamName(team) );
         } else if (g_gametype.integer == GT_1FCTF) {
             G_LogPrintf( "1fCTF: %i %i %i: %s fragged %s's flag carrier!\n", attacker->client->ps.clientNum, team, 3, attacker->client->pers.netname, TeamName(team) );
+            G_LogEvent( "1fctf", "iii", "client", attacker->client->ps.clientNum, "team", team, "action", 3 );
         }
 
 
@@ -471,6 +473,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
 
         attacker->client->ps.persistant[PERS_DEFEND_COUNT]++;
         G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+        G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
         if (!level.hadBots)
             ChallengeMessage(attacker,AWARD_DEFENCE);
         team = attacker->client->sess.sessionTeam;
@@ -494,6 +497,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
         if (!level.hadBots)
             ChallengeMessage(attacker,AWARD_DEFENCE);
         G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+        G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
         team = attacker->client->sess.sessionTeam;
         // add the sprite over the player's head
         attacker->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
@@ -525,6 +529,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
 
                 attacker->client->ps.persistant[PERS_DEFEND_COUNT]++;
                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+                G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
                 if (!level.hadBots)
                     ChallengeMessage(attacker,AWARD_DEFENCE);
                 // add the sprite over the player's head
@@ -563,6 +568,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
                 if (!level.hadBots)
                     ChallengeMessage(attacker,AWARD_DEFENCE);
                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+                G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
                 // add the sprite over the player's head
                 attacker->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
                 attacker->client->ps.eFlags |= EF_AWARD_DEFEND;
@@ -650,6 +656,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
         if (!level.hadBots)
             ChallengeMessage(attacker,AWARD_DEFENCE);
         G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+        G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
         // add the sprite over the player's head
         attacker->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
         attacker->client->ps.eFlags |= EF_AWARD_DEFEND;
@@ -674,6 +681,7 @@ void Team_FragBonuses(gentity_t *targ, gentity_t *inflictor, gentity_t *attacker
             if (!level.hadBots)
                 ChallengeMessage(attacker,AWARD_DEFENCE);
             G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 3, attacker->client->pers.netname, "DEFENCE" );
+            G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "DEFENCE" );
             // add the sprite over the player's head
             attacker->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
             attacker->client->ps.eFlags |= EF_AWARD_DEFEND;
@@ -1011,12 +1019,14 @@ void Team_ReturnFlag( int team ) {
         PrintMsg(NULL, "The flag has returned!\n" );
         if (g_gametype.integer == GT_1FCTF) {
             G_LogPrintf( "1FCTF: %i %i %i: The flag was returned!\n", -1, -1, 2 );
+            G_LogEvent( "1fctf", "iii", "client", -1, "team", -1, "action", 2 );
         }
     }
     else {
         PrintMsg(NULL, "The %s flag has returned!\n", TeamName(team));
         if (g_gametype.integer == GT_CTF) {
             G_LogPrintf( "CTF: %i %i %i: The %s flag was returned!\n", -1, team, 2, TeamName(team) );
+            G_LogEvent( "ctf", "iii", "client", -1, "team", team, "action", 2 );
         } else
             if (g_gametype.integer == GT_CTF_ELIMINATION) {
                 G_LogPrintf( "CTF_ELIMINATION: %i %i %i %i: The %s flag was returned!\n", level.roundNumber, -1, team, 2, TeamName(team) );
@@ -1235,6 +1245,7 @@ int Team_TouchOurFlag( gentity_t *ent, gentity_t *other, int team ) {
             AddScore(other, ent->r.currentOrigin, CTF_RECOVERY_BONUS);
             if (g_gametype.integer == GT_CTF) {
                 G_LogPrintf( "CTF: %i %i %i: %s returned the %s flag!\n", cl->ps.clientNum, team, 2, cl->pers.netname, TeamName(team) );
+                G_LogEvent( "ctf", "iii", "client", cl->ps.clientNum, "team", team, "action", 2 );
             } else if (g_gametype.integer == GT_CTF_ELIMINATION) {
                 G_LogPrintf( "CTF_ELIMINATION: %i %i %i %i: %s returned the %s flag!\n", level.roundNumber, cl->ps.clientNum, team, 2, cl->pers.netname, TeamName(team) );
             }
@@ -1261,11 +1272,14 @@ int Team_TouchOurFlag( gentity_t *ent, gentity_t *other, int team ) {
     if ( g_gametype.integer == GT_1FCTF ) {
         PrintMsg( NULL, "%s" S_COLOR_WHITE " captured the flag!\n", cl->pers.netname );
         G_LogPrintf( "1FCTF: %i %i %i: %s captured the flag!\n", cl->ps.clientNum, -1, 1, cl->pers.netname );
+        G_LogEvent( "1fctf", "iii", "client", cl->ps.clientNum, "team", -1, "action", 1 );
     }
     else {
         PrintMsg( NULL, "%s" S_COLOR_WHITE " captured the %s flag!\n", cl->pers.netname, TeamName(OtherTeam(team)));
-        if (g_gametype.integer == GT_CTF)
+        if (g_gametype.integer == GT_CTF) {
             G_LogPrintf( "CTF: %i %i %i: %s captured the %s flag!\n", cl->ps.clientNum, OtherTeam(team), 1, cl->pers.netname, TeamName(OtherTeam(team)) );
+            G_LogEvent( "ctf", "iii", "client", cl->ps.clientNum, "team", OtherTeam(team), "action", 1 );
+        }
         if (g_gametype.integer == GT_CTF_ELIMINATION)
             G_LogPrintf( "CTF_ELIMINATION: %i %i %i %i: %s captured the %s flag!\n", level.roundNumber, cl->ps.clientNum, OtherTeam(team), 1, cl->pers.netname, TeamName(OtherTeam(team)) );
 
@@ -1359,6 +1373,7 @@ int Team_TouchOurFlag( gentity_t *ent, gentity_t *other, int team ) {
     other->client->rewardTime = level.time + REWARD_SPRITE_TIME;
     other->client->ps.persistant[PERS_CAPTURES]++;
     G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", other->client->ps.clientNum, 4, other->client->pers.netname, "CAPTURE" );
+    G_LogEvent( "award", "is", "client", other->client->ps.clientNum, "award", "CAPTURE" );
     if (TeamCount(-1,TEAM_RED) && TeamCount(-1,TEAM_BLUE) && !level.hadBots)
         ChallengeMessage(other,AWARD_CAPTURE);
     // other gets another 10 frag bonus
@@ -1389,6 +1404,7 @@ int Team_TouchOurFlag( gentity_t *ent, gentity_t *other, int team ) {
                 if (!level.hadBots)
                     ChallengeMessage(player,AWARD_ASSIST);
                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", player->client->ps.clientNum, 5, player->client->pers.netname, "ASSIST" );
+                G_LogEvent( "award", "is", "client", player->client->ps.clientNum, "award", "ASSIST" );
                 // add the sprite over the player's head
                 player->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
                 player->client->ps.eFlags |= EF_AWARD_ASSIST;
@@ -1402,6 +1418,7 @@ int Team_TouchOurFlag( gentity_t *ent, gentity_t *other, int team ) {
                 if (!level.hadBots)
                     ChallengeMessage(player,AWARD_ASSIST);
                 G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", player->client->ps.clientNum, 5, player->client->pers.netname, "ASSIST" );
+                G_LogEvent( "award", "is", "client", player->client->ps.clientNum, "award", "ASSIST" );
                 // add the sprite over the player's head
                 player->client->ps.eFlags &= ~(EF_AWARD_IMPRESSIVE | EF_AWARD_EXCELLENT | EF_AWARD_GAUNTLET | EF_AWARD_ASSIST | EF_AWARD_DEFEND | EF_AWARD_CAP | EF_AWARD_AIRROCKET | EF_AWARD_AIRGRENADE );
                 player->client->ps.eFlags |= EF_AWARD_ASSIST;
@@ -1430,6 +1447,7 @@ int Team_TouchEnemyFlag( gentity_t *ent, gentity_t *other, int team ) {
         PrintMsg (NULL, "%s" S_COLOR_WHITE " got the flag!\n", other->client->pers.netname );
 
         G_LogPrintf( "1FCTF: %i %i %i: %s got the flag!\n", cl->ps.clientNum, team, 0, cl->pers.netname);
+        G_LogEvent( "1fctf", "iii", "client", cl->ps.clientNum, "team", team, "action", 0 );
 
         cl->ps.powerups[PW_NEUTRALFLAG] = INT_MAX; // flags never expire
 
@@ -1446,6 +1464,7 @@ int Team_TouchEnemyFlag( gentity_t *ent, gentity_t *other, int team ) {
 
         if (g_gametype.integer == GT_CTF) {
             G_LogPrintf( "CTF: %i %i %i: %s got the %s flag!\n", cl->ps.clientNum, team, 0, cl->pers.netname, TeamName(team));
+            G_LogEvent( "ctf", "iii", "client", cl->ps.clientNum, "team", team, "action", 0 );
         } else if (g_gametype.integer == GT_CTF_ELIMINATION) {
             G_LogPrintf( "CTF_ELIMINATION: %i %i %i %i: %s got the %s flag!\n", level.roundNumber, cl->ps.clientNum, team, 0, cl->pers.netname, TeamName(team));
         }
@@ -1556,26 +1575,214 @@ int Pickup_Team( gentity_t *ent, gentity_t *other ) {
 
 /*
 ===========
-Team_GetLocation
+Location grid
+
+Finding a location means the nearest target_location in the PVS, and a
+PVS test is the expensive part.  The space around the locations is cut
+into a grid, and the first time a point in a cell is looked up the cell
+gets the locations that could be nearest to any point in it, nearest
+first.  A lookup then walks only those, skipping any that cannot beat what
+it already has, so it usually takes a single PVS test.  Points
+outside the grid, or cells where none of the candidates were visible and
+close enough, fall back to testing every location.
+============
+*/
 
-Report a location for the player. Uses placed nearby target_location entities
+#define LOCATION_GRID_CELLS		8192
+#define LOCATION_GRID_MARGIN	512
+#define LOCATION_CANDIDATES		8
+#define LOCATION_FAR			(3*8192.0*8192.0)
+
+typedef struct {
+    qboolean	built;
+    int			count;
+    byte		candidates[LOCATION_CANDIDATES];
+    float		cutoff;		// no location left out of the cell is closer than this
+} locationCell_t;
+
+static struct {
+    gentity_t		*locations[256];
+    int				numLocations;
+    vec3_t			mins;
+    int				cellSize;
+    int				size[3];
+    locationCell_t	cells[LOCATION_GRID_CELLS];
+} locationGrid;
+
+/*
+===========
+Team_InitLocations
+
+Called once the target_locations are linked
 ============
 */
-gentity_t *Team_GetLocation(gentity_t *ent)
-{
+void Team_InitLocations( void ) {
+    gentity_t	*eloc;
+    vec3_t		mins, maxs;
+    int			i;
+
+    memset( &locationGrid, 0, sizeof( locationGrid ) );
+    ClearBounds( mins, maxs );
+
+    for (eloc = level.locationHead; eloc; eloc = eloc->nextTrain) {
+        if ( locationGrid.numLocations == sizeof( locationGrid.locations ) / sizeof( locationGrid.locations[0] ) ) {
+            // too many to index with a byte, always search them all
+            locationGrid.numLocations = 0;
+            return;
+        }
+        locationGrid.locations[locationGrid.numLocations++] = eloc;
+        AddPointToBounds( eloc->r.currentOrigin, mins, maxs );
+    }
+
+    if ( !locationGrid.numLocations ) {
+        return;
+    }
+
+    for ( i = 0 ; i < 3 ; i++ ) {
+        mins[i] -= LOCATION_GRID_MARGIN;
+        maxs[i] += LOCATION_GRID_MARGIN;
+    }
+    VectorCopy( mins, locationGrid.mins );
+
+    for ( locationGrid.cellSize = 128 ; ; locationGrid.cellSize *= 2 ) {
+        for ( i = 0 ; i < 3 ; i++ ) {
+            locationGrid.size[i] = (int)( maxs[i] - mins[i] ) / locationGrid.cellSize + 1;
+        }
+        if ( locationGrid.size[0] * locationGrid.size[1] * locationGrid.size[2] <= LOCATION_GRID_CELLS ) {
+            break;
+        }
+    }
+}
+
+/*
+===========
+Team_BuildLocationCell
+
+Sorts the locations by how close they can get to the cell and keeps the
+nearest few
+============
+*/
+static void Team_BuildLocationCell( locationCell_t *cell, const vec3_t cellMins, const vec3_t cellMaxs ) {
+    float		dist[LOCATION_CANDIDATES + 1];
+    int			index[LOCATION_CANDIDATES + 1];
+    float		len, d;
+    int			i, j, k, n;
+    gentity_t	*eloc;
+
+    n = 0;
+    for ( i = 0 ; i < locationGrid.numLocations ; i++ ) {
+        eloc = locationGrid.locations[i];
+
+        len = 0;
+        for ( j = 0 ; j < 3 ; j++ ) {
+            if ( eloc->r.currentOrigin[j] < cellMins[j] ) {
+                d = cellMins[j] - eloc->r.currentOrigin[j];
+            } else if ( eloc->r.currentOrigin[j] > cellMaxs[j] ) {
+                d = eloc->r.currentOrigin[j] - cellMaxs[j];
+            } else {
+                continue;
+            }
+            len += d * d;
+        }
+
+        // keep the nearest LOCATION_CANDIDATES, plus the next for the cutoff
+        for ( k = n ; k > 0 && dist[k - 1] > len ; k-- ) {
+            if ( k < LOCATION_CANDIDATES + 1 ) {
+                dist[k] = dist[k - 1];
+                index[k] = index[k - 1];
+            }
+        }
+        if ( k < LOCATION_CANDIDATES + 1 ) {
+            dist[k] = len;
+            index[k] = i;
+            if ( n < LOCATION_CANDIDATES + 1 ) {
+                n++;
+            }
+        }
+    }
+
+    for ( i = 0 ; i < n && i < LOCATION_CANDIDATES ; i++ ) {
+        cell->candidates[i] = index[i];
+    }
+    cell->count = i;
+    cell->cutoff = n > LOCATION_CANDIDATES ? dist[LOCATION_CANDIDATES] : LOCATION_FAR;
+    cell->built = qtrue;
+}
+
+/*
+===========
+Team_LocationDistance
+============
+*/
+static float Team_LocationDistance( const vec3_t origin, const gentity_t *eloc ) {
+    return ( origin[0] - eloc->r.currentOrigin[0] ) * ( origin[0] - eloc->r.currentOrigin[0] )
+           + ( origin[1] - eloc->r.currentOrigin[1] ) * ( origin[1] - eloc->r.currentOrigin[1] )
+           + ( origin[2] - eloc->r.currentOrigin[2] ) * ( origin[2] - eloc->r.currentOrigin[2] );
+}
+
+/*
+===========
+Team_GetLocationAt
+
+Returns the nearest target_location in the PVS of origin
+============
+*/
+static gentity_t *Team_GetLocationAt( const vec3_t origin ) {
     gentity_t		*eloc, *best;
     float			bestlen, len;
-    vec3_t			origin;
+    locationCell_t	*cell;
+    vec3_t			cellMins, cellMaxs;
+    int				c[3];
+    int				i;
 
     best = NULL;
-    bestlen = 3*8192.0*8192.0;
+    bestlen = LOCATION_FAR;
 
-    VectorCopy( ent->r.currentOrigin, origin );
+    cell = NULL;
+    if ( locationGrid.numLocations ) {
+        for ( i = 0 ; i < 3 ; i++ ) {
+            if ( origin[i] < locationGrid.mins[i] ) {
+                break;
+            }
+            c[i] = (int)( origin[i] - locationGrid.mins[i] ) / locationGrid.cellSize;
+            if ( c[i] >= locationGrid.size[i] ) {
+                break;
+            }
+        }
+        if ( i == 3 ) {
+            cell = &locationGrid.cells[( c[2] * locationGrid.size[1] + c[1] ) * locationGrid.size[0] + c[0]];
+            if ( !cell->built ) {
+                for ( i = 0 ; i < 3 ; i++ ) {
+                    cellMins[i] = locationGrid.mins[i] + c[i] * locationGrid.cellSize;
+                    cellMaxs[i] = cellMins[i] + locationGrid.cellSize;
+                }
+                Team_BuildLocationCell( cell, cellMins, cellMaxs );
+            }
+        }
+    }
+
+    if ( cell ) {
+        for ( i = 0 ; i < cell->count ; i++ ) {
+            eloc = locationGrid.locations[cell->candidates[i]];
+            len = Team_LocationDistance( origin, eloc );
+            if ( len > bestlen ) {
+                continue;
+            }
+            if ( !trap_InPVS( origin, eloc->r.currentOrigin ) ) {
+                continue;
+            }
+            bestlen = len;
+            best = eloc;
+        }
+
+        // nothing left out of the cell can be closer
+        if ( bestlen <= cell->cutoff ) {
+            return best;
+        }
+    }
 
     for (eloc = level.locationHead; eloc; eloc = eloc->nextTrain) {
-        len = ( origin[0] - eloc->r.currentOrigin[0] ) * ( origin[0] - eloc->r.currentOrigin[0] )
-              + ( origin[1] - eloc->r.currentOrigin[1] ) * ( origin[1] - eloc->r.currentOrigin[1] )
-              + ( origin[2] - eloc->r.currentOrigin[2] ) * ( origin[2] - eloc->r.currentOrigin[2] );
+        len = Team_LocationDistance( origin, eloc );
 
         if ( len > bestlen ) {
             continue;
@@ -1592,6 +1799,17 @@ gentity_t *Team_GetLocation(gentity_t *ent)
     return best;
 }
 
+/*
+===========
+Team_GetLocation
+
+Report a location for the player. Uses placed nearby target_location entities
+============
+*/
+gentity_t *Team_GetLocation(gentity_t *ent)
+{
+    return Team_GetLocationAt( ent->r.currentOrigin );
+}
 
 /*
 ===========
@@ -1630,36 +1848,9 @@ Report a location for the player. Uses placed nearby target_location entities
 */
 gentity_t *Team_GetDeathLocation(gentity_t *ent)
 {
-    gentity_t		*eloc, *best;
-    float			bestlen, len;
-    vec3_t			origin;
-
-    best = NULL;
-    bestlen = 3*8192.0*8192.0;
-
-    VectorCopy( ent->client->lastDeathOrigin, origin );
-
-    for (eloc = level.locationHead; eloc; eloc = eloc->nextTrain) {
-        len = ( origin[0] - eloc->r.currentOrigin[0] ) * ( origin[0] - eloc->r.currentOrigin[0] )
-              + ( origin[1] - eloc->r.currentOrigin[1] ) * ( origin[1] - eloc->r.currentOrigin[1] )
-              + ( origin[2] - eloc->r.currentOrigin[2] ) * ( origin[2] - eloc->r.currentOrigin[2] );
-
-        if ( len > bestlen ) {
-            continue;
-        }
-
-        if ( !trap_InPVS( origin, eloc->r.currentOrigin ) ) {
-            continue;
-        }
-
-        bestlen = len;
-        best = eloc;
-    }
-
-    return best;
+    return Team_GetLocationAt( ent->client->lastDeathOrigin );
 }
 
-
 /*
 ===========
 Team_GetDeathLocationMsg
@@ -1938,173 +2129,198 @@ gentity_t *SelectDoubleDominationSpawnPoint ( team_t team, vec3_t origin, vec3_t
 
 /*---------------------------------------------------------------------------*/
 
-static int QDECL SortClients( const void *a, const void *b ) {
-    return *(int *)a - *(int *)b;
-}
-
 /*
 ==================
-TeamplaySpectatorMessage
+Team overlay
+
+The overlay is the same for everyone on a team, so it is built once per
+team each update and handed to every player on it.  Spectators with
+multiview get one overlay of all the players.  Each client remembers which
+overlay it was last sent and is skipped while that has not changed, with a
+full resend every TEAM_OVERLAY_REFRESH in case its cgame was restarted.
 
 Format:
-	clientNum location health armor weapon powerups
+	tinfo count [clientNum location health armor weapon powerups]...
+==================
+*/
+
+#define TEAM_OVERLAY_REFRESH	5000
+
+typedef struct {
+    char	command[MAX_STRING_CHARS];
+    int		version;
+} teamOverlay_t;
 
+// indexed by team, with the TEAM_SPECTATOR slot holding all the players
+static teamOverlay_t	teamOverlays[TEAM_NUM_TEAMS];
+static int				teamOverlayVersion;
+
+/*
+==================
+TeamplayBuildOverlay
+
+Rebuilds the overlay for a team, giving it a new version if it changed.
+Versions are unique over all teams, so a client that changes team always
+gets the new team's overlay.
 ==================
 */
-void TeamplaySpectatorMessage( void ) {
-    gentity_t *ent;
-    char		entry[1024];
-    char		string[8192];
+static teamOverlay_t *TeamplayBuildOverlay( team_t team ) {
+    teamOverlay_t	*overlay;
+    char		entry[64];
+    char		string[MAX_STRING_CHARS];
+    char		command[MAX_STRING_CHARS];
     int			stringlength;
     int			i, j;
     gentity_t	*player;
     int			cnt;
     int			h, a, w;
-    int			clients[TEAM_MAXOVERLAY];
 
-    if ( level.time - level.lastSpecInfoTime > 500 ) {
+    overlay = &teamOverlays[team];
 
-        level.lastSpecInfoTime = level.time;
-
-        // figure out what client should be on the display
-        // we are limited to 8, but we want to use the top eight players
-        // but in client order (so they don't keep changing position on the overlay)
-        for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY; i++) {
-            player = g_entities + level.sortedClients[i];
-            if (player->inuse && player->client->sess.sessionTeam !=
-                    TEAM_SPECTATOR ) {
-                clients[cnt++] = level.sortedClients[i];
-            }
-        }
-
-        // We have the top eight players, sort them by clientNum
-        qsort( clients, cnt, sizeof( clients[0] ), SortClients );
+    string[0] = 0;
+    stringlength = 0;
 
-        // send the latest information on all clients
-        string[0] = 0;
-        stringlength = 0;
+    for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY; i++) {
+        player = g_entities + i;
+        if (!player->inuse)
+            continue;
+        if (team == TEAM_SPECTATOR ? player->client->sess.sessionTeam == TEAM_SPECTATOR
+                : player->client->sess.sessionTeam != team)
+            continue;
 
-        for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY; i++) {
-            player = g_entities + i;
-            if (player->inuse && player->client->sess.sessionTeam != TEAM_SPECTATOR ) {
+        h = player->client->ps.stats[STAT_HEALTH];
+        a = player->client->ps.stats[STAT_ARMOR];
+        w = player->client->ps.weapon;
+        if (player->client->isEliminated)
+        {
+            h = 0;
+            a = 0;
+            w = 0;
+        }
+        if (h < 0) h = 0;
+        if (a < 0) a = 0;
+
+        Com_sprintf (entry, sizeof(entry),
+                     " %i %i %i %i %i %i",
+                     i, player->client->pers.teamState.location, h, a,
+                     w, player->s.powerups);
+        j = strlen(entry);
+        // leave room for "tinfo count "
+        if (stringlength + j > sizeof(string) - 16)
+            break;
+        strcpy (string + stringlength, entry);
+        stringlength += j;
+        cnt++;
+    }
 
-                h = player->client->ps.stats[STAT_HEALTH];
-                a = player->client->ps.stats[STAT_ARMOR];
-                w = player->client->ps.weapon;
-                if (player->client->isEliminated)
-                {
-                    h = 0;
-                    a = 0;
-                    w = 0;
-                }
-                if (h < 0) h = 0;
-                if (a < 0) a = 0;
-
-                Com_sprintf (entry, sizeof(entry),
-                             " %i %i %i %i %i %i",
-                             i, player->client->pers.teamState.location, h, a,
-                             w, player->s.powerups);
-                j = strlen(entry);
-                if (stringlength + j > sizeof(string))
-                    break;
-                strcpy (string + stringlength, entry);
-                stringlength += j;
-                cnt++;
-            }
-        }
-    
-	for (i = 0; i < MAX_CLIENTS; i++) {
-		ent = &g_entities[i];
-		if ( ( ent->inuse ) && ( ent->client->sess.sessionTeam == TEAM_SPECTATOR ) && g_allowMultiview.integer && ( ent->client->pers.multiview > 0 ) ) {
-		      trap_SendServerCommand( ent-g_entities, va("tinfo %i %s", cnt, string) );
-		}
-	}
+    Com_sprintf( command, sizeof( command ), "tinfo %i %s", cnt, string );
+    if ( !overlay->version || strcmp( command, overlay->command ) ) {
+        Q_strncpyz( overlay->command, command, sizeof( overlay->command ) );
+        overlay->version = ++teamOverlayVersion;
     }
-}
 
+    return overlay;
+}
 
 /*
 ==================
-TeamplayLocationsMessage
+TeamplaySendOverlay
 
-Format:
-	clientNum location health armor weapon powerups
+Returns qfalse if the client already has this overlay
+==================
+*/
+static qboolean TeamplaySendOverlay( gentity_t *ent, const teamOverlay_t *overlay ) {
+    gclient_t	*client = ent->client;
 
+    if ( client->teamInfoVersion == overlay->version &&
+            level.time - client->teamInfoTime < TEAM_OVERLAY_REFRESH ) {
+        return qfalse;
+    }
+
+    client->teamInfoVersion = overlay->version;
+    client->teamInfoTime = level.time;
+    G_QueueServerCommand( ent-g_entities, SCMD_INFO, "tinfo", overlay->command );
+    return qtrue;
+}
+
+/*
+==================
+TeamplaySpectatorMessage
 ==================
 */
-void TeamplayInfoMessage( gentity_t *ent ) {
-    char		entry[1024];
-    char		string[8192];
-    int			stringlength;
-    int			i, j;
-    gentity_t	*player;
-    int			cnt;
-    int			h, a, w;
-    int			clients[TEAM_MAXOVERLAY];
+void TeamplaySpectatorMessage( void ) {
+    teamOverlay_t	*overlay;
+    gentity_t	*ent;
+    int			i;
 
-    if ( ! ent->client->pers.teamInfo )
+    if ( level.time - level.lastSpecInfoTime <= 500 ) {
         return;
+    }
+    level.lastSpecInfoTime = level.time;
 
-    // figure out what client should be on the display
-    // we are limited to 8, but we want to use the top eight players
-    // but in client order (so they don't keep changing position on the overlay)
-    for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY; i++) {
-        player = g_entities + level.sortedClients[i];
-        if (player->inuse && player->client->sess.sessionTeam ==
-                ent->client->sess.sessionTeam ) {
-            clients[cnt++] = level.sortedClients[i];
+    overlay = NULL;
+    for (i = 0; i < level.maxclients; i++) {
+        ent = &g_entities[i];
+        if ( !ent->inuse || ent->client->sess.sessionTeam != TEAM_SPECTATOR ) {
+            continue;
+        }
+        if ( !g_allowMultiview.integer || ent->client->pers.multiview <= 0 ) {
+            // send it again as soon as it is wanted
+            ent->client->teamInfoVersion = 0;
+            continue;
+        }
+        if ( !overlay ) {
+            overlay = TeamplayBuildOverlay( TEAM_SPECTATOR );
         }
+        TeamplaySendOverlay( ent, overlay );
     }
+}
 
-    // We have the top eight players, sort them by clientNum
-    qsort( clients, cnt, sizeof( clients[0] ), SortClients );
+/*
+==================
+TeamplayInfoMessage
 
-    // send the latest information on all clients
-    string[0] = 0;
-    stringlength = 0;
+Sends a player their team's overlay, if it has changed
+==================
+*/
+void TeamplayInfoMessage( gentity_t *ent ) {
+    team_t		team;
 
-    for (i = 0, cnt = 0; i < g_maxclients.integer && cnt < TEAM_MAXOVERLAY; i++) {
-        player = g_entities + i;
-        if (player->inuse && player->client->sess.sessionTeam ==
-                ent->client->sess.sessionTeam ) {
-
-            h = player->client->ps.stats[STAT_HEALTH];
-            a = player->client->ps.stats[STAT_ARMOR];
-            w = player->client->ps.weapon;
-            if (player->client->isEliminated)
-            {
-                h = 0;
-                a = 0;
-                w = 0;
-            }
-            if (h < 0) h = 0;
-            if (a < 0) a = 0;
-
-            Com_sprintf (entry, sizeof(entry),
-                         " %i %i %i %i %i %i",
-//				level.sortedClients[i], player->client->pers.teamState.location, h, a,
-                         i, player->client->pers.teamState.location, h, a,
-                         w, player->s.powerups);
-            j = strlen(entry);
-            if (stringlength + j > sizeof(string))
-                break;
-            strcpy (string + stringlength, entry);
-            stringlength += j;
-            cnt++;
-        }
+    team = ent->client->sess.sessionTeam;
+    if ( ! ent->client->pers.teamInfo ) {
+        ent->client->teamInfoVersion = 0;
+        return;
+    }
+    if ( team != TEAM_RED && team != TEAM_BLUE ) {
+        return;
     }
 
-    trap_SendServerCommand( ent-g_entities, va("tinfo %i %s", cnt, string) );
+    // built by CheckTeamStatus this update
+    if ( !teamOverlays[team].version ) {
+        TeamplayBuildOverlay( team );
+    }
+    TeamplaySendOverlay( ent, &teamOverlays[team] );
 }
 
+/*
+==================
+CheckTeamStatus
+
+Updates every player's location in one pass, then builds the red and
+blue overlays once and sends them to whoever needs them
+==================
+*/
 void CheckTeamStatus(void) {
     int i;
     gentity_t *loc, *ent;
+    team_t team;
+    qboolean active[TEAM_NUM_TEAMS];
 
     if (level.time - level.lastTeamLocationTime > TEAM_LOCATION_UPDATE_TIME) {
 
         level.lastTeamLocationTime = level.time;
 
+        memset( active, 0, sizeof( active ) );
         for (i = 0; i < g_maxclients.integer; i++) {
             ent = g_entities + i;
 
@@ -2112,15 +2328,24 @@ void CheckTeamStatus(void) {
                 continue;
             }
 
-            if (ent->inuse && (ent->client->sess.sessionTeam == TEAM_RED ||	ent->client->sess.sessionTeam == TEAM_BLUE)) {
+            team = ent->client->sess.sessionTeam;
+            if (ent->inuse && (team == TEAM_RED || team == TEAM_BLUE)) {
                 loc = Team_GetLocation( ent );
                 if (loc)
                     ent->client->pers.teamState.location = loc->health;
                 else
                     ent->client->pers.teamState.location = 0;
+                active[team] = qtrue;
             }
         }
 
+        if ( active[TEAM_RED] ) {
+            TeamplayBuildOverlay( TEAM_RED );
+        }
+        if ( active[TEAM_BLUE] ) {
+            TeamplayBuildOverlay( TEAM_BLUE );
+        }
+
         for (i = 0; i < g_maxclients.integer; i++) {
             ent = g_entities + i;
 
@@ -2225,6 +2450,7 @@ static void ObeliskDie( gentity_t *self, gentity_t *inflictor, gentity_t *attack
     attacker->client->rewardTime = level.time + REWARD_SPRITE_TIME;
     attacker->client->ps.persistant[PERS_CAPTURES]++;
     G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", attacker->client->ps.clientNum, 4, attacker->client->pers.netname, "CAPTURE" );
+    G_LogEvent( "award", "is", "client", attacker->client->ps.clientNum, "award", "CAPTURE" );
     if (TeamCount(-1,TEAM_RED) && TeamCount(-1,TEAM_BLUE) && !level.hadBots)
         ChallengeMessage(attacker,AWARD_CAPTURE);
 
@@ -2265,6 +2491,7 @@ static void ObeliskTouch( gentity_t *self, gentity_t *other, trace_t *trace ) {
     for (i = 0;i<tokens;i++)
     {
         G_LogPrintf( "Award: %i %i: %s gained the %s award!\n", other->client->ps.clientNum, 4, other->client->pers.netname, "CAPTURE" );
+        G_LogEvent( "award", "is", "client", other->client->ps.clientNum, "award", "CAPTURE" );
         if (TeamCount(-1,TEAM_RED) && TeamCount(-1,TEAM_BLUE) && !level.hadBots)
             ChallengeMessage(other,AWARD_CAPTURE);
     }
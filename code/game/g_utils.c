@@ -690,3 +690,390 @@ int DebugLine(vec3_t start, vec3_t end, int color) {
 
 	return trap_DebugPolygonCreate(color, 4, points);
 }
+
+/*
+==============================================================================
+
+SERVER COMMAND QUEUE
+
+Commands that only carry the latest state, like scores, the team overlay
+or respawn timers, are queued per client instead of being sent at once.
+A newer command with the same key replaces any that are still waiting;
+a command split over several parts queues the later parts with
+G_AppendServerCommand so that the whole set is replaced together.
+Each client's queue is drained at the end of the frame, most important
+class first, up to g_commandBudget bytes.  This keeps bursts such as a
+round start from overflowing a client's reliable command slots.
+
+==============================================================================
+*/
+
+#define	MAX_QUEUED_COMMANDS		256
+#define	MAX_CLIENT_COMMANDS		24		// waiting for one client
+#define	MAX_COMMAND_KEY			24
+
+typedef struct {
+	char	text[MAX_STRING_CHARS];
+	char	key[MAX_COMMAND_KEY];
+	int		length;
+	int		next;		// 0 at the end of a list
+} queuedCommand_t;
+
+typedef struct {
+	int		head[SCMD_NUM_CLASSES];
+	int		tail[SCMD_NUM_CLASSES];
+	int		count;
+} commandQueue_t;
+
+// entry 0 is unused so that 0 can end a list
+static queuedCommand_t	queuedCommands[MAX_QUEUED_COMMANDS];
+static int				numQueuedCommands = 1;
+static int				freeQueuedCommand;		// linked through next
+static commandQueue_t	commandQueues[MAX_CLIENTS];
+
+// counters for cmdstats
+static struct {
+	int		queued;
+	int		sent;
+	int		bytes;
+	int		superseded;
+	int		dropped;		// overlays that didn't fit
+	int		direct;			// queue flushed early because it was full
+	int		deferred;		// frames a client's budget ran out
+	int		peak;			// most commands waiting for one client
+} commandStats;
+
+/*
+=================
+AllocQueuedCommand
+=================
+*/
+static int AllocQueuedCommand( void ) {
+	int		n;
+
+	if ( freeQueuedCommand ) {
+		n = freeQueuedCommand;
+		freeQueuedCommand = queuedCommands[n].next;
+	} else if ( numQueuedCommands < MAX_QUEUED_COMMANDS ) {
+		n = numQueuedCommands++;
+	} else {
+		return 0;
+	}
+	queuedCommands[n].next = 0;
+	return n;
+}
+
+/*
+=================
+FreeQueuedCommand
+=================
+*/
+static void FreeQueuedCommand( int n ) {
+	queuedCommands[n].next = freeQueuedCommand;
+	freeQueuedCommand = n;
+}
+
+/*
+=================
+G_SupersedeCommands
+
+Drops the commands waiting for a client that have the given key
+=================
+*/
+static void G_SupersedeCommands( int clientNum, const char *key ) {
+	commandQueue_t	*q;
+	int				c, n, prev, next;
+
+	q = &commandQueues[clientNum];
+	for ( c = 0; c < SCMD_NUM_CLASSES; c++ ) {
+		prev = 0;
+		for ( n = q->head[c]; n; n = next ) {
+			next = queuedCommands[n].next;
+			if ( strcmp( queuedCommands[n].key, key ) ) {
+				prev = n;
+				continue;
+			}
+
+			if ( prev ) {
+				queuedCommands[prev].next = next;
+			} else {
+				q->head[c] = next;
+			}
+			if ( q->tail[c] == n ) {
+				q->tail[c] = prev;
+			}
+			FreeQueuedCommand( n );
+			q->count--;
+			commandStats.superseded++;
+		}
+	}
+}
+
+/*
+=================
+G_DropCommand
+
+Counts an overlay that didn't fit
+=================
+*/
+static void G_DropCommand( int clientNum, const char *key ) {
+	commandStats.dropped++;
+
+	// the overlay is only sent again when it changes, unless this is reset
+	if ( !strcmp( key, "tinfo" ) ) {
+		level.clients[clientNum].teamInfoVersion = 0;
+	}
+}
+
+/*
+=================
+G_DropInfoCommand
+
+Makes room in a client's queue by dropping its oldest SCMD_INFO command
+=================
+*/
+static qboolean G_DropInfoCommand( int clientNum ) {
+	commandQueue_t	*q;
+	int				n;
+
+	q = &commandQueues[clientNum];
+	n = q->head[SCMD_INFO];
+	if ( !n ) {
+		return qfalse;
+	}
+
+	q->head[SCMD_INFO] = queuedCommands[n].next;
+	if ( !q->head[SCMD_INFO] ) {
+		q->tail[SCMD_INFO] = 0;
+	}
+	G_DropCommand( clientNum, queuedCommands[n].key );
+	FreeQueuedCommand( n );
+	q->count--;
+	return qtrue;
+}
+
+/*
+=================
+G_FlushClientCommands
+
+Sends what is waiting for a client, up to budget bytes.  At least one
+command goes out, so a large one can't get stuck.
+=================
+*/
+static void G_FlushClientCommands( int clientNum, int budget ) {
+	commandQueue_t	*q;
+	queuedCommand_t	*cmd;
+	int				c, n, bytes, sent;
+
+	q = &commandQueues[clientNum];
+	bytes = 0;
+	sent = 0;
+	for ( c = 0; c < SCMD_NUM_CLASSES; c++ ) {
+		while ( q->head[c] ) {
+			n = q->head[c];
+			cmd = &queuedCommands[n];
+			if ( sent && bytes + cmd->length > budget ) {
+				break;
+			}
+
+			trap_SendServerCommand( clientNum, cmd->text );
+			bytes += cmd->length;
+			sent++;
+
+			q->head[c] = cmd->next;
+			if ( !q->head[c] ) {
+				q->tail[c] = 0;
+			}
+			FreeQueuedCommand( n );
+			q->count--;
+		}
+		if ( q->head[c] ) {
+			break;
+		}
+	}
+
+	commandStats.sent += sent;
+	commandStats.bytes += bytes;
+}
+
+/*
+=================
+G_QueueClientCommand
+=================
+*/
+static void G_QueueClientCommand( int clientNum, scmdClass_t cls, const char *key, qboolean supersede, const char *cmd, int length ) {
+	commandQueue_t	*q;
+	int				n;
+
+	q = &commandQueues[clientNum];
+	if ( key && supersede ) {
+		G_SupersedeCommands( clientNum, key );
+	}
+
+	if ( length >= MAX_STRING_CHARS ) {
+		// too long to queue, so everything waiting has to go out first
+		G_FlushClientCommands( clientNum, 0x7fffffff );
+		commandStats.direct++;
+		trap_SendServerCommand( clientNum, cmd );
+		return;
+	}
+
+	n = 0;
+	if ( q->count < MAX_CLIENT_COMMANDS ) {
+		n = AllocQueuedCommand();
+	}
+	if ( !n && cls == SCMD_INFO ) {
+		// only the team overlay is queued here, and it is sent again
+		// once teamInfoVersion is reset
+		G_DropCommand( clientNum, key ? key : "" );
+		return;
+	}
+	if ( !n && G_DropInfoCommand( clientNum ) ) {
+		n = AllocQueuedCommand();
+	}
+	if ( !n ) {
+		// anything else can't be lost, and mustn't overtake what is
+		// already waiting either
+		G_FlushClientCommands( clientNum, 0x7fffffff );
+		commandStats.direct++;
+		n = AllocQueuedCommand();
+		if ( !n ) {
+			trap_SendServerCommand( clientNum, cmd );
+			return;
+		}
+	}
+
+	memcpy( queuedCommands[n].text, cmd, length + 1 );
+	Q_strncpyz( queuedCommands[n].key, key ? key : "", sizeof( queuedCommands[n].key ) );
+	queuedCommands[n].length = length;
+
+	if ( q->tail[cls] ) {
+		queuedCommands[q->tail[cls]].next = n;
+	} else {
+		q->head[cls] = n;
+	}
+	q->tail[cls] = n;
+	q->count++;
+
+	commandStats.queued++;
+	if ( q->count > commandStats.peak ) {
+		commandStats.peak = q->count;
+	}
+}
+
+/*
+=================
+G_QueueCommand
+=================
+*/
+static void G_QueueCommand( int clientNum, scmdClass_t cls, const char *key, qboolean supersede, const char *cmd ) {
+	int		i, length;
+
+	length = strlen( cmd );
+	if ( clientNum >= 0 ) {
+		G_QueueClientCommand( clientNum, cls, key, supersede, cmd, length );
+		return;
+	}
+
+	for ( i = 0; i < level.maxclients; i++ ) {
+		if ( level.clients[i].pers.connected == CON_CONNECTED ) {
+			G_QueueClientCommand( i, cls, key, supersede, cmd, length );
+		}
+	}
+}
+
+/*
+=================
+G_QueueServerCommand
+
+Queues a command for a client, or for every connected client if clientNum
+is -1.  Commands that are still waiting with the same key are dropped, so
+give a key to commands where only the latest one matters.
+=================
+*/
+void G_QueueServerCommand( int clientNum, scmdClass_t cls, const char *key, const char *cmd ) {
+	G_QueueCommand( clientNum, cls, key, qtrue, cmd );
+}
+
+/*
+=================
+G_AppendServerCommand
+
+Queues a later part of a command started with G_QueueServerCommand.  It
+gets the same key but doesn't replace the earlier parts.
+=================
+*/
+void G_AppendServerCommand( int clientNum, scmdClass_t cls, const char *key, const char *cmd ) {
+	G_QueueCommand( clientNum, cls, key, qfalse, cmd );
+}
+
+/*
+=================
+G_ClearServerCommands
+
+Drops everything waiting for a client, when it disconnects
+=================
+*/
+void G_ClearServerCommands( int clientNum ) {
+	commandQueue_t	*q;
+	int				c, n, next;
+
+	q = &commandQueues[clientNum];
+	for ( c = 0; c < SCMD_NUM_CLASSES; c++ ) {
+		for ( n = q->head[c]; n; n = next ) {
+			next = queuedCommands[n].next;
+			FreeQueuedCommand( n );
+		}
+		q->head[c] = q->tail[c] = 0;
+	}
+	q->count = 0;
+}
+
+/*
+=================
+G_FlushServerCommands
+
+Sends what is waiting for each client, within its budget for the frame
+=================
+*/
+void G_FlushServerCommands( void ) {
+	commandQueue_t	*q;
+	int				i;
+
+	for ( i = 0; i < level.maxclients; i++ ) {
+		q = &commandQueues[i];
+		if ( !q->count ) {
+			continue;
+		}
+		if ( level.clients[i].pers.connected == CON_DISCONNECTED ) {
+			G_ClearServerCommands( i );
+			continue;
+		}
+
+		G_FlushClientCommands( i, g_commandBudget.integer );
+		if ( q->count ) {
+			commandStats.deferred++;
+		}
+	}
+}
+
+/*
+=================
+Svcmd_CommandStats_f
+=================
+*/
+void Svcmd_CommandStats_f( void ) {
+	int		i, waiting;
+
+	waiting = 0;
+	for ( i = 0; i < level.maxclients; i++ ) {
+		waiting += commandQueues[i].count;
+	}
+
+	G_Printf( "%i commands queued, %i sent in %i bytes, %i waiting\n",
+		commandStats.queued, commandStats.sent, commandStats.bytes, waiting );
+	G_Printf( "  %i superseded, %i dropped, %i early flushes\n",
+		commandStats.superseded, commandStats.dropped, commandStats.direct );
+	G_Printf( "  %i client frames over budget, at most %i waiting for one client\n",
+		commandStats.deferred, commandStats.peak );
+}
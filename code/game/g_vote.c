@@ -77,6 +77,274 @@ int allowedRef(char *commandStr) {
         return qfalse;
 }
 
+/*
+==============================================================================
+
+MAP CATALOG
+
+Everything the votes, the mapcycle and the map pages need to know about a
+map is looked up here instead of in the file system.  The catalog is built
+once per level load from the maps folder and votemaps.cfg, kept sorted
+by name for paging and prefix search, and hashed for lookups.  The mapcycle
+and the arena files add their part when they are loaded.
+
+==============================================================================
+*/
+
+#define	MAX_CATALOG_MAPS	2048
+#define	MAP_HASH_SIZE		1024
+#define	MAP_LIST_SIZE		65536
+
+typedef struct {
+	mapInfo_t	maps[MAX_CATALOG_MAPS];
+	int			numMaps;
+	int			hash[MAP_HASH_SIZE];	// first map + 1, 0 if none
+	int			pages[MAX_CATALOG_MAPS];	// what the map pages show, in order
+	int			numPages;
+	qboolean	votemaps;		// there is a votemaps.cfg
+	qboolean	overflow;		// not every map fit
+} mapCatalog_t;
+
+static mapCatalog_t	mapCatalog;
+static char			mapList[MAP_LIST_SIZE];
+
+/*
+=================
+MapNameHash
+=================
+*/
+static int MapNameHash( const char *name ) {
+	int		i, hash;
+
+	hash = 0;
+	for ( i = 0 ; name[i] ; i++ ) {
+		hash += tolower( name[i] ) * ( i + 119 );
+	}
+	return hash & ( MAP_HASH_SIZE - 1 );
+}
+
+/*
+=================
+CatalogAddMap
+
+Only used while building, before the catalog is sorted and hashed
+=================
+*/
+static void CatalogAddMap( const char *name, int len, int flags ) {
+	mapInfo_t	*m;
+
+	if ( !len || len >= MAX_QPATH ) {
+		return;
+	}
+	if ( mapCatalog.numMaps == MAX_CATALOG_MAPS ) {
+		mapCatalog.overflow = qtrue;
+		return;
+	}
+
+	m = &mapCatalog.maps[mapCatalog.numMaps++];
+	memcpy( m->name, name, len );
+	m->name[len] = 0;
+	m->flags = flags;
+	m->minplayers = 0;
+	m->maxplayers = MAX_CLIENTS;
+	m->arena = -1;
+	m->hashNext = 0;
+}
+
+/*
+=================
+CatalogCompare
+=================
+*/
+static int QDECL CatalogCompare( const void *a, const void *b ) {
+	return Q_stricmp( ( (const mapInfo_t *)a )->name, ( (const mapInfo_t *)b )->name );
+}
+
+/*
+=================
+G_BuildMapCatalog
+=================
+*/
+void G_BuildMapCatalog( void ) {
+	fileHandle_t	file;
+	mapInfo_t		*m;
+	char			*token, *pointer;
+	int				i, n, len, nummaps, maplen;
+
+	memset( &mapCatalog, 0, sizeof( mapCatalog ) );
+
+	// every map on the server
+	nummaps = trap_FS_GetFileList( "maps", ".bsp", mapList, sizeof( mapList ) );
+	pointer = mapList;
+	len = 0;
+	for ( i = 0 ; i < nummaps ; i++, pointer += maplen + 1 ) {
+		maplen = strlen( pointer );
+		len += maplen + 1;
+		if ( maplen > 4 && !Q_stricmp( pointer + maplen - 4, ".bsp" ) ) {
+			CatalogAddMap( pointer, maplen - 4, MAPF_BSP );
+		}
+	}
+	// the engine stops when the list is full, without saying so
+	if ( len > sizeof( mapList ) - MAX_QPATH ) {
+		mapCatalog.overflow = qtrue;
+	}
+
+	// the maps that may be voted for, if the server limits them
+	len = trap_FS_FOpenFile( "votemaps.cfg", &file, FS_READ );
+	if ( file ) {
+		mapCatalog.votemaps = qtrue;
+		if ( len > sizeof( mapList ) - 1 ) {
+			len = sizeof( mapList ) - 1;
+		}
+		trap_FS_Read( mapList, len, file );
+		mapList[len] = 0;
+		trap_FS_FCloseFile( file );
+
+		pointer = mapList;
+		for ( token = COM_Parse( &pointer ) ; token[0] ; token = COM_Parse( &pointer ) ) {
+			CatalogAddMap( token, strlen( token ), MAPF_VOTEMAPS );
+		}
+	} else {
+		mapList[0] = 0;
+	}
+
+	// sort, then fold the votemaps.cfg entries into the maps they name
+	qsort( mapCatalog.maps, mapCatalog.numMaps, sizeof( mapCatalog.maps[0] ), CatalogCompare );
+	n = 0;
+	for ( i = 0 ; i < mapCatalog.numMaps ; i++ ) {
+		if ( n && !Q_stricmp( mapCatalog.maps[n - 1].name, mapCatalog.maps[i].name ) ) {
+			mapCatalog.maps[n - 1].flags |= mapCatalog.maps[i].flags;
+			continue;
+		}
+		mapCatalog.maps[n++] = mapCatalog.maps[i];
+	}
+	mapCatalog.numMaps = n;
+
+	for ( i = mapCatalog.numMaps - 1 ; i >= 0 ; i-- ) {
+		m = &mapCatalog.maps[i];
+		n = MapNameHash( m->name );
+		m->hashNext = mapCatalog.hash[n];
+		mapCatalog.hash[n] = i + 1;
+	}
+
+	// the pages follow votemaps.cfg if there is one, otherwise they are
+	// every map in name order
+	if ( mapCatalog.votemaps ) {
+		pointer = mapList;
+		for ( token = COM_Parse( &pointer ) ; token[0] ; token = COM_Parse( &pointer ) ) {
+			m = G_FindMap( token );
+			if ( m && mapCatalog.numPages < MAX_CATALOG_MAPS ) {
+				mapCatalog.pages[mapCatalog.numPages++] = m - mapCatalog.maps;
+			}
+		}
+	} else {
+		for ( i = 0 ; i < mapCatalog.numMaps ; i++ ) {
+			mapCatalog.pages[mapCatalog.numPages++] = i;
+		}
+	}
+
+	if ( mapCatalog.overflow ) {
+		G_Printf( "WARNING: map catalog is full, only %i maps are indexed\n", mapCatalog.numMaps );
+	}
+}
+
+/*
+=================
+G_FindMap
+
+Returns the catalog entry for a map, or NULL if it has none
+=================
+*/
+mapInfo_t *G_FindMap( const char *name ) {
+	int		i;
+
+	for ( i = mapCatalog.hash[MapNameHash( name )] ; i ; i = mapCatalog.maps[i - 1].hashNext ) {
+		if ( !Q_stricmp( mapCatalog.maps[i - 1].name, name ) ) {
+			return &mapCatalog.maps[i - 1];
+		}
+	}
+	return NULL;
+}
+
+/*
+=================
+G_MapExists
+
+Returns qtrue if maps/<name>.bsp is on the server
+=================
+*/
+qboolean G_MapExists( const char *name ) {
+	mapInfo_t	*m;
+
+	m = G_FindMap( name );
+	if ( m ) {
+		return ( m->flags & MAPF_BSP ) != 0;
+	}
+	if ( !mapCatalog.overflow ) {
+		return qfalse;
+	}
+
+	// only the maps that didn't fit have to be looked for
+	return trap_FS_FOpenFile( va( "maps/%s.bsp", name ), NULL, FS_READ ) > 0;
+}
+
+/*
+=================
+G_ClearMapFlags
+
+Drops flags from every map, so that the mapcycle can set them again
+=================
+*/
+void G_ClearMapFlags( int flags ) {
+	int		i;
+
+	for ( i = 0 ; i < mapCatalog.numMaps ; i++ ) {
+		mapCatalog.maps[i].flags &= ~flags;
+		if ( flags & MAPF_CYCLE ) {
+			mapCatalog.maps[i].minplayers = 0;
+			mapCatalog.maps[i].maxplayers = MAX_CLIENTS;
+		}
+	}
+}
+
+/*
+=================
+G_FindMapsByPrefix
+
+Fills list with up to max maps that have all of flags and whose names
+start with prefix, in name order.  Returns how many there are in all.
+=================
+*/
+int G_FindMapsByPrefix( const char *prefix, int flags, mapInfo_t **list, int max ) {
+	int		lo, hi, mid, len, count;
+
+	len = strlen( prefix );
+
+	// the first map not sorting before the prefix
+	lo = 0;
+	hi = mapCatalog.numMaps;
+	while ( lo < hi ) {
+		mid = ( lo + hi ) / 2;
+		if ( Q_stricmpn( mapCatalog.maps[mid].name, prefix, len ) < 0 ) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	count = 0;
+	for ( ; lo < mapCatalog.numMaps && !Q_stricmpn( mapCatalog.maps[lo].name, prefix, len ) ; lo++ ) {
+		if ( ( mapCatalog.maps[lo].flags & flags ) != flags ) {
+			continue;
+		}
+		if ( count < max ) {
+			list[count] = &mapCatalog.maps[lo];
+		}
+		count++;
+	}
+	return count;
+}
+
 /*
 ==================
 getMappage
@@ -85,63 +353,28 @@ getMappage
 
 t_mappage getMappage(int page) {
 	t_mappage result;
-	fileHandle_t	file;
-	char *token,*pointer;
-	char buffer[MAX_MAPNAME_BUFFER];
-	int i, nummaps,maplen;
+	int i, first;
 
 	memset(&result,0,sizeof(result));
-        memset(&buffer,0,sizeof(buffer));
-
-	//Check if there is a votemaps.cfg
-	trap_FS_FOpenFile("votemaps.cfg",&file,FS_READ);
-	if(file)
-	{
-		//there is a votemaps.cfg file, take allowed maps from there
-		trap_FS_Read(&buffer,sizeof(buffer),file);
-		pointer = buffer;
-		token = COM_Parse(&pointer);
-		if(token[0]==0 && page == 0) {
-			//First page empty
-			result.pagenumber = -1;
-                        trap_FS_FCloseFile(file);
-			return result;
-		}
-		//Skip the first pages
-		for(i=0;i<MAPS_PER_PAGE*page;i++) {
-			token = COM_Parse(&pointer);
-		}
-		if(!token || token[0]==0) {
-			//Page empty, return to first page
-                        trap_FS_FCloseFile(file);
-			return getMappage(0);
-		}
-		//There is an actual page:
-                result.pagenumber = page;
-		for(i=0;i<MAPS_PER_PAGE && token;i++) {
-			Q_strncpyz(result.mapname[i],token,MAX_MAPNAME);
-			token = COM_Parse(&pointer);
-		}
-                trap_FS_FCloseFile(file);
+
+	if(mapCatalog.votemaps && !mapCatalog.numPages) {
+		//votemaps.cfg is empty
+		result.pagenumber = -1;
 		return result;
 	}
-        //There is no votemaps.cfg file, find filelist of maps
-        nummaps = trap_FS_GetFileList("maps",".bsp",buffer,sizeof(buffer));
-
-        if(nummaps && nummaps<=MAPS_PER_PAGE*page)
-            return getMappage(0);
 
-        pointer = buffer;
-        result.pagenumber = page;
-
-        for (i = 0; i < nummaps; i++, pointer += maplen+1) {
-		maplen = strlen(pointer);
-                if(i>=MAPS_PER_PAGE*page && i<MAPS_PER_PAGE*(page+1)) {
-                    Q_strncpyz(result.mapname[i-MAPS_PER_PAGE*page],pointer,maplen-3);
-                }
+	first = MAPS_PER_PAGE*page;
+	if(page < 0 || (mapCatalog.numPages && first >= mapCatalog.numPages)) {
+		//Page empty, return to first page
+		page = 0;
+		first = 0;
 	}
-        return result;
 
+	result.pagenumber = page;
+	for(i=0;i<MAPS_PER_PAGE && first+i<mapCatalog.numPages;i++) {
+		Q_strncpyz(result.mapname[i],mapCatalog.maps[mapCatalog.pages[first+i]].name,MAX_MAPNAME);
+	}
+	return result;
 }
 
 /*
@@ -151,44 +384,54 @@ allowedMap
  */
 
 int allowedMap(char *mapname) {
-    int length;
-    fileHandle_t	file;           //To check that the map actually exists.
-    char                buffer[MAX_MAPS_TEXT];
-    char                *token,*pointer;
-    qboolean            found;
+    mapInfo_t *m;
 
-    trap_FS_FOpenFile(va("maps/%s.bsp",mapname),&file,FS_READ);
-    if(!file)
+    if(!G_MapExists(mapname))
         return qfalse; //maps/MAPNAME.bsp does not exist
-    trap_FS_FCloseFile(file);
-
-    //Now read the file votemaps.cfg to see what maps are allowed
-    trap_FS_FOpenFile("votemaps.cfg",&file,FS_READ);
 
-    if(!file)
+    if(!mapCatalog.votemaps)
         return qtrue; //if no file, everything is allowed
-    length = strlen(mapname);
-    if(length>MAX_MAPNAME_LENGTH-3)
-    {
-        //Error: too long
-        trap_FS_FCloseFile(file);
-        return qfalse;
-    }
 
-    //Add file checking here
-    trap_FS_Read(&buffer,MAX_MAPS_TEXT,file);
-    found = qfalse;
-    pointer = buffer;
-    token = COM_Parse(&pointer);
-    while(token[0]!=0 && !found) {
-        if(!Q_stricmp(token,mapname))
-            found = qtrue;
-        token = COM_Parse(&pointer);
-    }
+    if(strlen(mapname)>MAX_MAPNAME_LENGTH-3)
+        return qfalse; //Error: too long
 
-    trap_FS_FCloseFile(file);
-    //The map was not found
-    return found;
+    m = G_FindMap(mapname);
+    return m && (m->flags & MAPF_VOTEMAPS);
+}
+
+/*
+==================
+G_SuggestMaps
+
+Tells a player who asked for a map that isn't there which maps start
+the same way
+==================
+ */
+void G_SuggestMaps( gentity_t *ent, const char *prefix ) {
+	mapInfo_t	*list[8];
+	char		string[MAX_STRING_CHARS];
+	int			i, count, shown;
+
+	if ( !prefix[0] ) {
+		return;
+	}
+
+	count = G_FindMapsByPrefix( prefix, mapCatalog.votemaps ? MAPF_BSP | MAPF_VOTEMAPS : MAPF_BSP,
+		list, sizeof( list ) / sizeof( list[0] ) );
+	if ( !count ) {
+		return;
+	}
+
+	shown = count < sizeof( list ) / sizeof( list[0] ) ? count : sizeof( list ) / sizeof( list[0] );
+	Q_strncpyz( string, "print \"Did you mean:", sizeof( string ) );
+	for ( i = 0 ; i < shown ; i++ ) {
+		Q_strcat( string, sizeof( string ), va( " %s", list[i]->name ) );
+	}
+	if ( count > shown ) {
+		Q_strcat( string, sizeof( string ), va( " (%i more)", count - shown ) );
+	}
+	Q_strcat( string, sizeof( string ), "\n\"" );
+	trap_SendServerCommand( ent - g_entities, string );
 }
 
 /*
@@ -32,12 +32,13 @@ MULTIPLAYER MENU (SERVER BROWSER)
 #include "ui_local.h"
 
 
-#define MAX_GLOBALSERVERS		256
-#define MAX_PINGREQUESTS		32
+#define MAX_GLOBALSERVERS		MAX_GLOBAL_SERVERS
+#define MIN_PINGWINDOW			4
+#define SERVER_HASH_SIZE		1024
 #define MAX_ADDRESSLENGTH		64
 #define MAX_HOSTNAMELENGTH		31
 #define MAX_MAPNAMELENGTH		20
-#define MAX_LISTBOXITEMS		256
+#define MAX_LISTBOXITEMS		MAX_GLOBALSERVERS
 #define MAX_LOCALSERVERS		124
 #define MAX_STATUSLENGTH		64
 #define MAX_LEAGUELENGTH		28
@@ -184,6 +185,7 @@ static char quake3worldMessage[] = "Visit www.openarena.ws - News, Community, Ev
 
 typedef struct {
 	char	adrstr[MAX_ADDRESSLENGTH];
+	int		adrhash;
 	int		start;
 } pinglist_t;
 
@@ -203,6 +205,9 @@ typedef struct servernode_s {
 	int		maxPing;
 	//qboolean bPB;
 
+	char	sortname[MAX_HOSTNAMELENGTH+3];	// hostname without colors, lowercase
+	int		adrhash;
+	int		hashnext;						// 1 + index of the next node in the bucket
 } servernode_t; 
 
 typedef struct {
@@ -245,6 +250,11 @@ typedef struct {
 	int					numqueriedservers;
 	int					*numservers;
 	servernode_t		*serverlist;	
+	servernode_t		*sorted[MAX_GLOBALSERVERS];	// serverlist in g_sortkey order
+	int					numsorted;
+	qboolean			indexdirty;					// sorted and serverhash need a rebuild
+	int					serverhash[SERVER_HASH_SIZE];
+	int					pingwindow;
 	int					currentping;
 	qboolean			refreshservers;
 	int					nextpingtime;
@@ -315,24 +325,36 @@ static int ArenaServers_MaxPing( void ) {
 
 /*
 =================
-ArenaServers_Compare
+ArenaServers_HashAddress
 =================
 */
-static int QDECL ArenaServers_Compare( const void *arg1, const void *arg2 ) {
+static int ArenaServers_HashAddress( const char *adrstr ) {
+	int		hash;
+
+	hash = 0;
+	while ( *adrstr ) {
+		hash = hash * 31 + tolower( *adrstr );
+		adrstr++;
+	}
+	return hash & 0x7fffffff;
+}
+
+
+/*
+=================
+ArenaServers_CompareNodes
+=================
+*/
+static int ArenaServers_CompareNodes( const servernode_t *t1, const servernode_t *t2 ) {
 	float			f1;
 	float			f2;
-	servernode_t*	t1;
-	servernode_t*	t2;
-
-	t1 = (servernode_t *)arg1;
-	t2 = (servernode_t *)arg2;
 
 	switch( g_sortkey ) {
 	case SORT_HOST:
-		return Q_stricmp( t1->hostname, t2->hostname );
+		return strcmp( t1->sortname, t2->sortname );
 
 	case SORT_MAP:
-		return Q_stricmp( t1->mapname, t2->mapname );
+		return strcmp( t1->mapname, t2->mapname );
 
 	case SORT_CLIENTS:
 		f1 = t1->maxclients - t1->numclients;
@@ -381,13 +403,123 @@ static int QDECL ArenaServers_Compare( const void *arg1, const void *arg2 ) {
 		if( t1->pingtime > t2->pingtime ) {
 			return 1;
 		}
-		return Q_stricmp( t1->hostname, t2->hostname );
+		return strcmp( t1->sortname, t2->sortname );
 	}
 
 	return 0;
 }
 
 
+/*
+=================
+ArenaServers_Compare
+=================
+*/
+static int QDECL ArenaServers_Compare( const void *arg1, const void *arg2 ) {
+	return ArenaServers_CompareNodes( *(servernode_t **)arg1, *(servernode_t **)arg2 );
+}
+
+
+/*
+=================
+ArenaServers_BuildIndex
+
+Rebuilds the sorted index and address hash of the current list
+after it was switched, resorted or edited in place
+=================
+*/
+static void ArenaServers_BuildIndex( void ) {
+	int				i;
+	int				bucket;
+	servernode_t*	servernodeptr;
+
+	memset( g_arenaservers.serverhash, 0, sizeof( g_arenaservers.serverhash ) );
+
+	servernodeptr = g_arenaservers.serverlist;
+	for( i = 0; i < *g_arenaservers.numservers; i++, servernodeptr++ ) {
+		servernodeptr->adrhash  = ArenaServers_HashAddress( servernodeptr->adrstr );
+		bucket = servernodeptr->adrhash & ( SERVER_HASH_SIZE - 1 );
+		servernodeptr->hashnext = g_arenaservers.serverhash[bucket];
+		g_arenaservers.serverhash[bucket] = i + 1;
+
+		g_arenaservers.sorted[i] = servernodeptr;
+	}
+	g_arenaservers.numsorted = *g_arenaservers.numservers;
+
+	qsort( g_arenaservers.sorted, g_arenaservers.numsorted, sizeof( servernode_t * ), ArenaServers_Compare );
+	g_arenaservers.indexdirty = qfalse;
+}
+
+
+/*
+=================
+ArenaServers_FindServer
+=================
+*/
+static servernode_t *ArenaServers_FindServer( const char *adrstr, int adrhash ) {
+	int				i;
+	servernode_t*	servernodeptr;
+
+	for( i = g_arenaservers.serverhash[adrhash & ( SERVER_HASH_SIZE - 1 )]; i; i = servernodeptr->hashnext ) {
+		servernodeptr = &g_arenaservers.serverlist[i - 1];
+		if( servernodeptr->adrhash == adrhash && !Q_stricmp( servernodeptr->adrstr, adrstr ) ) {
+			return servernodeptr;
+		}
+	}
+	return NULL;
+}
+
+
+/*
+=================
+ArenaServers_IndexRemove
+=================
+*/
+static void ArenaServers_IndexRemove( servernode_t *servernodeptr ) {
+	int		i;
+
+	for( i = 0; i < g_arenaservers.numsorted; i++ ) {
+		if( g_arenaservers.sorted[i] == servernodeptr ) {
+			g_arenaservers.numsorted--;
+			memmove( &g_arenaservers.sorted[i], &g_arenaservers.sorted[i + 1],
+				( g_arenaservers.numsorted - i ) * sizeof( servernode_t * ) );
+			return;
+		}
+	}
+}
+
+
+/*
+=================
+ArenaServers_IndexInsert
+
+Binary insertion after any equal keys, so servers keep arrival order
+=================
+*/
+static void ArenaServers_IndexInsert( servernode_t *servernodeptr ) {
+	int		lo;
+	int		hi;
+	int		mid;
+
+	lo = 0;
+	hi = g_arenaservers.numsorted;
+	while( lo < hi ) {
+		mid = ( lo + hi ) >> 1;
+		if( ArenaServers_CompareNodes( g_arenaservers.sorted[mid], servernodeptr ) <= 0 ) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	memmove( &g_arenaservers.sorted[lo + 1], &g_arenaservers.sorted[lo],
+		( g_arenaservers.numsorted - lo ) * sizeof( servernode_t * ) );
+	g_arenaservers.sorted[lo] = servernodeptr;
+	g_arenaservers.numsorted++;
+}
+
+
 /*
 =================
 ArenaServers_Go
@@ -502,7 +634,6 @@ static void ArenaServers_UpdateMenu( void ) {
 			// show progress
 			Com_sprintf( g_arenaservers.status.string, MAX_STATUSLENGTH, "%d of %d Arena Servers.", g_arenaservers.currentping, g_arenaservers.numqueriedservers);
 			g_arenaservers.statusbar.string  = "Press SPACE to stop";
-			qsort( g_arenaservers.serverlist, *g_arenaservers.numservers, sizeof( servernode_t ), ArenaServers_Compare);
 		}
 		else {
 			// all servers pinged - enable controls
@@ -584,10 +715,14 @@ static void ArenaServers_UpdateMenu( void ) {
 		return;
 	}
 
+	if( g_arenaservers.indexdirty ) {
+		ArenaServers_BuildIndex();
+	}
+
 	// build list box strings - apply culling filters
-	servernodeptr = g_arenaservers.serverlist;
-	count         = *g_arenaservers.numservers;
-	for( i = 0, j = 0; i < count; i++, servernodeptr++ ) {
+	count         = g_arenaservers.numsorted;
+	for( i = 0, j = 0; i < count; i++ ) {
+		servernodeptr = g_arenaservers.sorted[i];
 		tableptr = &g_arenaservers.table[j];
 		tableptr->servernode = servernodeptr;
 		buff = tableptr->buff;
@@ -805,6 +940,7 @@ static void ArenaServers_Remove( void )
 
 	g_arenaservers.numqueriedservers = g_arenaservers.numfavoriteaddresses;
 	g_arenaservers.currentping       = g_arenaservers.numfavoriteaddresses;
+	g_arenaservers.indexdirty        = qtrue;
 }
 
 
@@ -818,6 +954,8 @@ static void ArenaServers_Insert( char* adrstr, char* info, int pingtime )
 	servernode_t*	servernodeptr;
 	char*			s;
 	int				i;
+	int				adrhash;
+	int				bucket;
 
 
 	if ((pingtime >= ArenaServers_MaxPing()) && (g_servertype != UIAS_FAVORITES))
@@ -826,21 +964,40 @@ static void ArenaServers_Insert( char* adrstr, char* info, int pingtime )
 		return;
 	}
 
-	if (*g_arenaservers.numservers >= g_arenaservers.maxservers) {
-		// list full;
-		servernodeptr = g_arenaservers.serverlist+(*g_arenaservers.numservers)-1;
+	if (g_arenaservers.indexdirty) {
+		ArenaServers_BuildIndex();
+	}
+
+	adrhash = ArenaServers_HashAddress( adrstr );
+	servernodeptr = ArenaServers_FindServer( adrstr, adrhash );
+	if (servernodeptr) {
+		// repeated answer, resort it with the new values
+		ArenaServers_IndexRemove( servernodeptr );
 	} else {
+		if (*g_arenaservers.numservers >= g_arenaservers.maxservers) {
+			// list full
+			return;
+		}
+
 		// next slot
 		servernodeptr = g_arenaservers.serverlist+(*g_arenaservers.numservers);
 		(*g_arenaservers.numservers)++;
-	}
 
-	Q_strncpyz( servernodeptr->adrstr, adrstr, MAX_ADDRESSLENGTH );
+		Q_strncpyz( servernodeptr->adrstr, adrstr, MAX_ADDRESSLENGTH );
+		servernodeptr->adrhash  = adrhash;
+		bucket = adrhash & ( SERVER_HASH_SIZE - 1 );
+		servernodeptr->hashnext = g_arenaservers.serverhash[bucket];
+		g_arenaservers.serverhash[bucket] = *g_arenaservers.numservers;
+	}
 
 	Q_strncpyz( servernodeptr->hostname, Info_ValueForKey( info, "hostname"), MAX_HOSTNAMELENGTH );
 	Q_CleanStrWithColor( servernodeptr->hostname );
 	Q_strupr( servernodeptr->hostname );
 
+	Q_strncpyz( servernodeptr->sortname, servernodeptr->hostname, sizeof(servernodeptr->sortname) );
+	Q_CleanStr( servernodeptr->sortname );
+	Q_strlwr( servernodeptr->sortname );
+
 	Q_strncpyz( servernodeptr->mapname, Info_ValueForKey( info, "mapname"), MAX_MAPNAMELENGTH );
 	Q_CleanStr( servernodeptr->mapname );
 	Q_strupr( servernodeptr->mapname );
@@ -887,6 +1044,8 @@ static void ArenaServers_Insert( char* adrstr, char* info, int pingtime )
 		servernodeptr->gametype = i;
 		Q_strncpyz( servernodeptr->gamename, gamenames[i], sizeof(servernodeptr->gamename) );
 	}
+
+	ArenaServers_IndexInsert( servernodeptr );
 }
 
 
@@ -987,6 +1146,7 @@ void ArenaServers_LoadFavorites( void )
 	}
 
 	g_arenaservers.numfavoriteaddresses = g_numfavoriteservers;
+	g_arenaservers.indexdirty = qtrue;
 
 	if (!found)
 	{
@@ -1022,9 +1182,6 @@ static void ArenaServers_StopRefresh( void )
 		g_arenaservers.currentping       = *g_arenaservers.numservers;
 		g_arenaservers.numqueriedservers = *g_arenaservers.numservers; 
 	}
-	
-	// sort
-	qsort( g_arenaservers.serverlist, *g_arenaservers.numservers, sizeof( servernode_t ), ArenaServers_Compare);
 
 	ArenaServers_UpdateMenu();
 }
@@ -1041,6 +1198,11 @@ static void ArenaServers_DoRefresh( void )
 	int		j;
 	int		time;
 	int		maxPing;
+	int		adrhash;
+	int		answered;
+	int		staled;
+	int		oldping;
+	int		oldqueried;
 	char	adrstr[MAX_ADDRESSLENGTH];
 	char	info[MAX_INFO_STRING];
 
@@ -1068,6 +1230,11 @@ static void ArenaServers_DoRefresh( void )
 	// trigger at 10Hz intervals
 	g_arenaservers.nextpingtime = uis.realtime + 10;
 
+	oldping    = g_arenaservers.currentping;
+	oldqueried = g_arenaservers.numqueriedservers;
+	answered   = 0;
+	staled     = 0;
+
 	// process ping results
 	maxPing = ArenaServers_MaxPing();
 	for (i=0; i<MAX_PINGREQUESTS; i++)
@@ -1080,8 +1247,9 @@ static void ArenaServers_DoRefresh( void )
 		}
 
 		// find ping result in our local list
+		adrhash = ArenaServers_HashAddress( adrstr );
 		for (j=0; j<MAX_PINGREQUESTS; j++)
-			if (!Q_stricmp( adrstr, g_arenaservers.pinglist[j].adrstr ))
+			if (g_arenaservers.pinglist[j].adrhash == adrhash && !Q_stricmp( adrstr, g_arenaservers.pinglist[j].adrstr ))
 				break;
 
 		if (j < MAX_PINGREQUESTS)
@@ -1102,10 +1270,12 @@ static void ArenaServers_DoRefresh( void )
 				// stale it out
 				info[0] = '\0';
 				time    = maxPing;
+				staled++;
 			}
 			else
 			{
 				trap_LAN_GetPingInfo( i, info, MAX_INFO_STRING );
+				answered++;
 			}
 
 			// insert ping results
@@ -1130,11 +1300,26 @@ static void ArenaServers_DoRefresh( void )
 //	if (g_arenaservers.numqueriedservers > g_arenaservers.maxservers)
 //		g_arenaservers.numqueriedservers = g_arenaservers.maxservers;
 
+	// the engine has MAX_PINGREQUESTS slots, keep them all busy unless
+	// pings are being lost, and back off by one for each that was
+	if (staled) {
+		g_arenaservers.pingwindow -= staled;
+		if (g_arenaservers.pingwindow < MIN_PINGWINDOW) {
+			g_arenaservers.pingwindow = MIN_PINGWINDOW;
+		}
+	}
+	else if (answered) {
+		g_arenaservers.pingwindow += answered;
+		if (g_arenaservers.pingwindow > MAX_PINGREQUESTS) {
+			g_arenaservers.pingwindow = MAX_PINGREQUESTS;
+		}
+	}
+
 	// send ping requests in reasonable bursts
 	// iterate ping through all found servers
-	for (i=0; i<MAX_PINGREQUESTS && g_arenaservers.currentping < g_arenaservers.numqueriedservers; i++)
+	for (i=0; i<g_arenaservers.pingwindow && g_arenaservers.currentping < g_arenaservers.numqueriedservers; i++)
 	{
-		if (trap_LAN_GetPingQueueCount() >= MAX_PINGREQUESTS)
+		if (trap_LAN_GetPingQueueCount() >= g_arenaservers.pingwindow)
 		{
 			// ping queue is full
 			break;
@@ -1158,6 +1343,7 @@ static void ArenaServers_DoRefresh( void )
 		}
 
 		strcpy( g_arenaservers.pinglist[j].adrstr, adrstr );
+		g_arenaservers.pinglist[j].adrhash = ArenaServers_HashAddress( adrstr );
 		g_arenaservers.pinglist[j].start = uis.realtime;
 
 		trap_Cmd_ExecuteText( EXEC_NOW, va( "ping %s\n", adrstr )  );
@@ -1174,7 +1360,8 @@ static void ArenaServers_DoRefresh( void )
 	}
 
 	// update the user interface with ping status
-	ArenaServers_UpdateMenu();
+	if (answered || staled || g_arenaservers.currentping != oldping || g_arenaservers.numqueriedservers != oldqueried)
+		ArenaServers_UpdateMenu();
 }
 
 
@@ -1188,7 +1375,11 @@ static void ArenaServers_StartRefresh( void )
 	int		i;
 	char	myargs[32], protocol[32];
 
-	memset( g_arenaservers.serverlist, 0, g_arenaservers.maxservers*sizeof(table_t) );
+	memset( g_arenaservers.serverlist, 0, g_arenaservers.maxservers*sizeof(servernode_t) );
+	memset( g_arenaservers.serverhash, 0, sizeof(g_arenaservers.serverhash) );
+	g_arenaservers.numsorted  = 0;
+	g_arenaservers.indexdirty = qfalse;
+	g_arenaservers.pingwindow = MAX_PINGREQUESTS;
 
 	for (i=0; i<MAX_PINGREQUESTS; i++)
 	{
@@ -1306,7 +1497,7 @@ void ArenaServers_Sort( int type ) {
 	}
 
 	g_sortkey = type;
-	qsort( g_arenaservers.serverlist, *g_arenaservers.numservers, sizeof( servernode_t ), ArenaServers_Compare);
+	g_arenaservers.indexdirty = qtrue;
 }
 
 
@@ -1333,6 +1524,7 @@ int ArenaServers_SetType( int type )
 	}
 
 	g_servertype = type;
+	g_arenaservers.indexdirty = qtrue;
 
 	switch( type ) {
 	default:
@@ -151,14 +151,16 @@ typedef struct symbol_s {
 	int		value;
 } symbol_t;
 
-typedef struct hashchain_s {
+typedef struct hashslot_s {
+  unsigned int hash;
+  const char *key;          /* NULL marks an empty slot */
   void *data;
-  struct hashchain_s *next;
-} hashchain_t;
+} hashslot_t;
 
 typedef struct hashtable_s {
-  int buckets;
-  hashchain_t **table;
+  int size;                 /* always a power of two */
+  int used;
+  hashslot_t *slots;
 } hashtable_t;
 
 int symtablelen = DEFAULT_HASHTABLE_SIZE;
@@ -177,6 +179,8 @@ typedef struct options_s {
 	qboolean verbose;
 	qboolean writeMapFile;
 	qboolean vanillaQ3Compatibility;
+	qboolean optimize;
+	qboolean cacheLayout;
 } options_t;
 
 options_t options = { 0 };
@@ -189,6 +193,7 @@ symbol_t	*lastSymbol = 0;  /* Most recent symbol defined. */
 int		numAsmFiles;
 char	*asmFiles[MAX_ASM_FILES];
 char	*asmFileNames[MAX_ASM_FILES];
+int		asmFileLengths[MAX_ASM_FILES];
 
 int		currentFileIndex;
 char	*currentFileName;
@@ -211,6 +216,10 @@ char	token[MAX_LINE_LENGTH];
 
 int		instructionCount;
 
+// set by ParseExpression when the value did not come from a symbol, so
+// it is the same on both passes
+qboolean	expressionLiteral;
+
 typedef struct {
 	char	*name;
 	int		opcode;
@@ -244,123 +253,114 @@ static int report (const char *fmt, ...)
   return retval;
 }
 
-/* The chain-and-bucket hash table.  -PH */
+/*
+  Open addressing with linear probing.  The table doubles once it is
+  70% full, so -b is only a starting size.  Entries are never removed.
+*/
 
-static void hashtable_init (hashtable_t *H, int buckets)
+static void hashtable_init (hashtable_t *H, int size)
 {
-  H->buckets = buckets;
-  H->table = calloc(H->buckets, sizeof(*(H->table)));
+  int slots;
+
+  for (slots = 16; slots < size; slots <<= 1) /* nop */ ;
+  H->size = slots;
+  H->used = 0;
+  H->slots = calloc(H->size, sizeof(*(H->slots)));
   return;
 }
 
-static hashtable_t *hashtable_new (int buckets)
+static hashtable_t *hashtable_new (int size)
 {
   hashtable_t *H;
 
   H = malloc(sizeof(hashtable_t));
-  hashtable_init(H, buckets);
+  hashtable_init(H, size);
   return H;
 }
 
 /* No destroy/destructor.  No need. */
 
-static void hashtable_add (hashtable_t *H, int hashvalue, void *datum)
+static void hashtable_grow (hashtable_t *H)
 {
-  hashchain_t *hc, **hb;
+  hashslot_t *old, *slot;
+  int oldSize, i;
+
+  old = H->slots;
+  oldSize = H->size;
+  H->size <<= 1;
+  H->slots = calloc(H->size, sizeof(*(H->slots)));
 
-  hashvalue = (abs(hashvalue) % H->buckets);
-  hb = &(H->table[hashvalue]);
-  if (*hb == 0)
+  for (i = 0; i < oldSize; i++)
     {
-      /* Empty bucket.  Create new one. */
-      *hb = calloc(1, sizeof(**hb));
-      hc = *hb;
+      if (!old[i].key)
+        continue;
+      for (slot = &H->slots[old[i].hash & (H->size - 1)]; slot->key; )
+        {
+          if (++slot == H->slots + H->size)
+            slot = H->slots;
+        }
+      *slot = old[i];
     }
-  else
+  free(old);
+}
+
+static void hashtable_add (hashtable_t *H, unsigned int hash, const char *key, void *datum)
+{
+  hashslot_t *slot;
+
+  if ((H->used + 1) * 10 > H->size * 7)
+    hashtable_grow(H);
+
+  for (slot = &H->slots[hash & (H->size - 1)]; slot->key; )
     {
-      /* Get hc to point to last node in chain. */
-      for (hc = *hb; hc && hc->next; hc = hc->next);
-      hc->next = calloc(1, sizeof(*hc));
-      hc = hc->next;
+      if (++slot == H->slots + H->size)
+        slot = H->slots;
     }
-  hc->data = datum;
-  hc->next = 0;
+  slot->hash = hash;
+  slot->key = key;
+  slot->data = datum;
+  H->used++;
   return;
 }
 
-static hashchain_t *hashtable_get (hashtable_t *H, int hashvalue)
+static void *hashtable_find (hashtable_t *H, unsigned int hash, const char *key)
 {
-  hashvalue = (abs(hashvalue) % H->buckets);
-  return (H->table[hashvalue]);
+  hashslot_t *slot;
+
+  for (slot = &H->slots[hash & (H->size - 1)]; slot->key; )
+    {
+      if (slot->hash == hash && !strcmp(slot->key, key))
+        return slot->data;
+      if (++slot == H->slots + H->size)
+        slot = H->slots;
+    }
+  return NULL;
 }
 
 static void hashtable_stats (hashtable_t *H)
 {
-  int len, empties, longest, nodes;
-  int i;
-  float meanlen;
-  hashchain_t *hc;
+  int i, probes, longest, home;
 
   report("Stats for hashtable %08X", H);
-  empties = 0;
+  probes = 0;
   longest = 0;
-  nodes = 0;
-  for (i = 0; i < H->buckets; i++)
+  for (i = 0; i < H->size; i++)
     {
-      if (H->table[i] == 0)
-        { empties++; continue; }
-      for (hc = H->table[i], len = 0; hc; hc = hc->next, len++);
-      if (len > longest) { longest = len; }
-      nodes += len;
+      if (!H->slots[i].key)
+        continue;
+      home = H->slots[i].hash & (H->size - 1);
+      home = (i - home + H->size) & (H->size - 1);
+      probes += home;
+      if (home > longest)
+        longest = home;
     }
-  meanlen = (float)(nodes) / (H->buckets - empties);
-#if 0
-/* Long stats display */
-  report(" Total buckets: %d\n", H->buckets);
-  report(" Total stored nodes: %d\n", nodes);
-  report(" Longest chain: %d\n", longest);
-  report(" Empty chains: %d\n", empties);
-  report(" Mean non-empty chain length: %f\n", meanlen);
-#else //0
-/* Short stats display */
-  report(", %d buckets, %d nodes", H->buckets, nodes);
+  report(", %d slots, %d nodes", H->size, H->used);
   report("\n");
-  report(" Longest chain: %d, empty chains: %d, mean non-empty: %f", longest, empties, meanlen);
-#endif //0
+  report(" Longest probe: %d, mean probe: %f", longest, H->used ? (float)probes / H->used : 0.0f);
   report("\n");
 }
 
 
-/* Kludge. */
-/* Check if symbol already exists. */
-/* Returns 0 if symbol does NOT already exist, non-zero otherwise. */
-static int hashtable_symbol_exists (hashtable_t *H, int hash, char *sym)
-{
-  hashchain_t *hc;
-  symbol_t *s;
-
-  hash = (abs(hash) % H->buckets);
-  hc = H->table[hash];
-  if (hc == 0)
-    {
-      /* Empty chain means this symbol has not yet been defined. */
-      return 0;
-    }
-  for (; hc; hc = hc->next)
-    {
-      s = (symbol_t*)hc->data;
-//      if ((hash == s->hash) && (strcmp(sym, s->name) == 0))
-/* We _already_ know the hash is the same.  That's why we're probing! */
-      if (strcmp(sym, s->name) == 0)
-        {
-          /* Symbol collisions -- symbol already exists. */
-          return 1;
-        }
-    }
-  return 0;  /* Can't find collision. */
-}
-
-
 
 
 /* Comparator function for quicksorting. */
@@ -496,6 +496,390 @@ static void CodeError( char *fmt, ... ) {
 	va_end( argptr );
 }
 
+/*
+==============================================================================
+
+PASS 0 LAYOUT CACHE
+
+Pass 0 only has to work out where every symbol lands.  With -c, what
+each file does to the layout is recorded as a short list of events and
+kept in <output>.q3asmcache, keyed by the file's contents.  The next run
+replays the events for any file that hasn't changed instead of parsing
+it again.  Pass 1 still assembles every file.
+
+==============================================================================
+*/
+
+#define	LAYOUT_CACHE_MAGIC		( 'Q' | ( '3' << 8 ) | ( 'A' << 16 ) | ( 'C' << 24 ) )
+#define	LAYOUT_CACHE_VERSION	1
+
+typedef enum {
+	LE_SEGMENT,			// currentSegment = &segment[arg]
+	LE_HACK,			// HackToSegment( arg )
+	LE_ADVANCE,			// segment[seg].imageUsed += arg
+	LE_SKIP,			// currentSegment->imageUsed += arg
+	LE_ALIGN,			// align currentSegment to arg
+	LE_CODE,			// arg bytes of code holding count instructions
+	LE_LABEL,			// label at the current position
+	LE_PROC,			// procedure at the current instruction
+	LE_EQU				// name = arg
+} layoutEventType_t;
+
+typedef struct {
+	int		type;
+	int		seg;
+	int		arg;
+	int		count;
+	char	*name;
+} layoutEvent_t;
+
+typedef struct {
+	unsigned INT64	hash;
+	int				length;
+	int				startSegment;	// currentSegment when the file was reached
+	qboolean		optimized;		// -O changes instruction counts
+	qboolean		used;			// still one of our inputs
+	int				numEvents;
+	layoutEvent_t	*events;
+} fileLayout_t;
+
+static fileLayout_t	*fileLayouts;
+static int			numFileLayouts;
+static int			maxFileLayouts;
+static qboolean		layoutCacheChanged;
+
+static fileLayout_t	*recordingLayout;	// pass 0 parse being recorded, if any
+static int			maxRecordEvents;
+
+static int			filesReplayed;
+
+static void DefineSymbol( char *sym, int value );
+static void HackToSegment( segmentName_t seg );
+
+/*
+============
+HashFileContents
+
+64 bit FNV-1a
+============
+*/
+static unsigned INT64 HashFileContents( const char *data, int length ) {
+	unsigned INT64	hash;
+	int				i;
+
+	hash = 14695981039346656037ULL;
+	for ( i = 0 ; i < length ; i++ ) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/*
+============
+RecordLayout
+============
+*/
+static void RecordLayout( int type, int seg, int arg, int count, const char *name ) {
+	fileLayout_t	*layout;
+	layoutEvent_t	*ev;
+
+	layout = recordingLayout;
+	if ( !layout ) {
+		return;
+	}
+
+	// runs of emitted bytes and instructions collapse into one event
+	if ( ( type == LE_ADVANCE || type == LE_CODE ) && layout->numEvents ) {
+		ev = &layout->events[layout->numEvents - 1];
+		if ( ev->type == type && ev->seg == seg ) {
+			ev->arg += arg;
+			ev->count += count;
+			return;
+		}
+	}
+
+	if ( layout->numEvents == maxRecordEvents ) {
+		maxRecordEvents = maxRecordEvents ? maxRecordEvents * 2 : 1024;
+		layout->events = realloc( layout->events, maxRecordEvents * sizeof( *layout->events ) );
+	}
+	ev = &layout->events[layout->numEvents++];
+	ev->type = type;
+	ev->seg = seg;
+	ev->arg = arg;
+	ev->count = count;
+	ev->name = name ? copystring( (char *)name ) : NULL;
+}
+
+static fileLayout_t *AllocFileLayout( void ) {
+	if ( numFileLayouts == maxFileLayouts ) {
+		maxFileLayouts = maxFileLayouts ? maxFileLayouts * 2 : 64;
+		fileLayouts = realloc( fileLayouts, maxFileLayouts * sizeof( *fileLayouts ) );
+	}
+	memset( &fileLayouts[numFileLayouts], 0, sizeof( fileLayouts[0] ) );
+	return &fileLayouts[numFileLayouts++];
+}
+
+static fileLayout_t *FindFileLayout( unsigned INT64 hash, int length, int startSegment ) {
+	int		i;
+
+	for ( i = 0 ; i < numFileLayouts ; i++ ) {
+		if ( fileLayouts[i].hash == hash && fileLayouts[i].length == length
+			&& fileLayouts[i].startSegment == startSegment
+			&& fileLayouts[i].optimized == options.optimize && fileLayouts[i].events ) {
+			return &fileLayouts[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+============
+BeginFileLayout
+============
+*/
+static void BeginFileLayout( unsigned INT64 hash, int length, int startSegment ) {
+	recordingLayout = AllocFileLayout();
+	recordingLayout->hash = hash;
+	recordingLayout->length = length;
+	recordingLayout->startSegment = startSegment;
+	recordingLayout->optimized = options.optimize;
+	recordingLayout->used = qtrue;
+	maxRecordEvents = 0;
+}
+
+/*
+============
+EndFileLayout
+
+A file that had errors is parsed again next time so they are reported
+============
+*/
+static void EndFileLayout( qboolean keep ) {
+	fileLayout_t	*layout;
+	int				i;
+
+	layout = recordingLayout;
+	recordingLayout = NULL;
+	if ( !layout ) {
+		return;
+	}
+	if ( keep ) {
+		layoutCacheChanged = qtrue;
+		return;
+	}
+	for ( i = 0 ; i < layout->numEvents ; i++ ) {
+		free( layout->events[i].name );
+	}
+	free( layout->events );
+	numFileLayouts--;
+}
+
+/*
+============
+ReplayFileLayout
+============
+*/
+static void ReplayFileLayout( fileLayout_t *layout ) {
+	layoutEvent_t	*ev;
+	int				i;
+
+	layout->used = qtrue;
+	for ( i = 0, ev = layout->events ; i < layout->numEvents ; i++, ev++ ) {
+		switch ( ev->type ) {
+		case LE_SEGMENT:
+			currentSegment = &segment[ev->arg];
+			break;
+		case LE_HACK:
+			HackToSegment( ev->arg );
+			break;
+		case LE_ADVANCE:
+			segment[ev->seg].imageUsed += ev->arg;
+			if ( segment[ev->seg].imageUsed > MAX_IMAGE ) {
+				Error( "MAX_IMAGE" );
+			}
+			break;
+		case LE_SKIP:
+			currentSegment->imageUsed += ev->arg;
+			break;
+		case LE_ALIGN:
+			currentSegment->imageUsed = ( currentSegment->imageUsed + ev->arg - 1 ) & ~( ev->arg - 1 );
+			break;
+		case LE_CODE:
+			segment[CODESEG].imageUsed += ev->arg;
+			if ( segment[CODESEG].imageUsed > MAX_IMAGE ) {
+				Error( "MAX_IMAGE" );
+			}
+			instructionCount += ev->count;
+			break;
+		case LE_LABEL:
+			if ( currentSegment == &segment[CODESEG] ) {
+				DefineSymbol( ev->name, instructionCount );
+			} else {
+				DefineSymbol( ev->name, currentSegment->imageUsed );
+			}
+			break;
+		case LE_PROC:
+			DefineSymbol( ev->name, instructionCount );
+			break;
+		case LE_EQU:
+			DefineSymbol( ev->name, ev->arg );
+			break;
+		}
+	}
+	filesReplayed++;
+}
+
+static char *LayoutCacheName( char *name ) {
+	strcpy( name, outputFilename );
+	StripExtension( name );
+	strcat( name, ".q3asmcache" );
+	return name;
+}
+
+/*
+============
+ReadLayoutCache
+
+Anything that doesn't look right just means an empty cache
+============
+*/
+static void ReadLayoutCache( void ) {
+	char			name[MAX_OS_PATH];
+	fileLayout_t	*layout;
+	layoutEvent_t	*ev;
+	byte			*buf, *p, *end;
+	int				length, count, i, j, nameLength;
+
+	LayoutCacheName( name );
+	if ( !FileExists( name ) ) {
+		return;
+	}
+	length = TryLoadFile( name, (void **)&buf );
+	if ( length < 12 ) {
+		return;
+	}
+	p = buf;
+	end = buf + length;
+
+#define	READ_INT(v)	{ if ( p + 4 > end ) goto bad; memcpy( &(v), p, 4 ); p += 4; }
+
+	READ_INT( i );
+	READ_INT( j );
+	if ( i != LAYOUT_CACHE_MAGIC || j != LAYOUT_CACHE_VERSION ) {
+		goto bad;
+	}
+	READ_INT( count );
+	for ( i = 0 ; i < count ; i++ ) {
+		layout = AllocFileLayout();
+		if ( p + 8 > end ) {
+			goto bad;
+		}
+		memcpy( &layout->hash, p, 8 );
+		p += 8;
+		READ_INT( layout->length );
+		READ_INT( layout->startSegment );
+		READ_INT( layout->optimized );
+		READ_INT( layout->numEvents );
+		if ( layout->numEvents < 0 || layout->numEvents > ( end - p ) / 20 ) {
+			goto bad;
+		}
+		layout->events = calloc( layout->numEvents + 1, sizeof( *layout->events ) );
+		for ( j = 0, ev = layout->events ; j < layout->numEvents ; j++, ev++ ) {
+			READ_INT( ev->type );
+			READ_INT( ev->seg );
+			READ_INT( ev->arg );
+			READ_INT( ev->count );
+			READ_INT( nameLength );
+			if ( ev->seg < 0 || ev->seg >= NUM_SEGMENTS
+				|| ( ( ev->type == LE_SEGMENT || ev->type == LE_HACK ) && ( ev->arg < 0 || ev->arg >= NUM_SEGMENTS ) ) ) {
+				goto bad;
+			}
+			if ( nameLength ) {
+				if ( nameLength < 0 || nameLength >= MAX_LINE_LENGTH || p + nameLength > end ) {
+					goto bad;
+				}
+				ev->name = malloc( nameLength + 1 );
+				memcpy( ev->name, p, nameLength );
+				ev->name[nameLength] = 0;
+				p += nameLength;
+			} else if ( ev->type >= LE_LABEL ) {
+				goto bad;
+			}
+		}
+	}
+
+#undef READ_INT
+
+	free( buf );
+	report( "%i file layouts read from %s\n", numFileLayouts, name );
+	return;
+
+bad:
+	report( "ignoring bad layout cache %s\n", name );
+	free( buf );
+	numFileLayouts = 0;		// leaked, we're a short lived tool
+}
+
+/*
+============
+WriteLayoutCache
+
+Only layouts of the current inputs are kept
+============
+*/
+static void WriteLayoutCache( void ) {
+	char			name[MAX_OS_PATH];
+	FILE			*f;
+	fileLayout_t	*layout;
+	layoutEvent_t	*ev;
+	int				i, j, count, v;
+
+	count = 0;
+	for ( i = 0 ; i < numFileLayouts ; i++ ) {
+		if ( fileLayouts[i].used ) {
+			count++;
+		}
+	}
+	if ( !layoutCacheChanged && count == numFileLayouts ) {
+		return;
+	}
+
+	LayoutCacheName( name );
+	report( "Writing %s...\n", name );
+	f = SafeOpenWrite( name );
+
+	v = LAYOUT_CACHE_MAGIC;
+	SafeWrite( f, &v, 4 );
+	v = LAYOUT_CACHE_VERSION;
+	SafeWrite( f, &v, 4 );
+	SafeWrite( f, &count, 4 );
+	for ( i = 0, layout = fileLayouts ; i < numFileLayouts ; i++, layout++ ) {
+		if ( !layout->used ) {
+			continue;
+		}
+		SafeWrite( f, &layout->hash, 8 );
+		SafeWrite( f, &layout->length, 4 );
+		SafeWrite( f, &layout->startSegment, 4 );
+		v = layout->optimized;
+		SafeWrite( f, &v, 4 );
+		SafeWrite( f, &layout->numEvents, 4 );
+		for ( j = 0, ev = layout->events ; j < layout->numEvents ; j++, ev++ ) {
+			SafeWrite( f, &ev->type, 4 );
+			SafeWrite( f, &ev->seg, 4 );
+			SafeWrite( f, &ev->arg, 4 );
+			SafeWrite( f, &ev->count, 4 );
+			v = ev->name ? strlen( ev->name ) : 0;
+			SafeWrite( f, &v, 4 );
+			if ( v ) {
+				SafeWrite( f, ev->name, v );
+			}
+		}
+	}
+	fclose( f );
+}
+
+
 /*
 ============
 EmitByte
@@ -507,6 +891,7 @@ static void EmitByte( segment_t *seg, int v ) {
 	}
 	seg->image[ seg->imageUsed ] = v;
 	seg->imageUsed++;
+	RecordLayout( LE_ADVANCE, seg - segment, 1, 0, NULL );
 }
 
 /*
@@ -523,6 +908,7 @@ static void EmitInt( segment_t *seg, int v ) {
 	seg->image[ seg->imageUsed + 2 ] = ( v >> 16 ) & 255;
 	seg->image[ seg->imageUsed + 3 ] = ( v >> 24 ) & 255;
 	seg->imageUsed += 4;
+	RecordLayout( LE_ADVANCE, seg - segment, 4, 0, NULL );
 }
 
 /*
@@ -550,7 +936,7 @@ static void DefineSymbol( char *sym, int value ) {
 
 	hash = HashString( sym );
 
-	if (hashtable_symbol_exists(symtable, hash, sym)) {
+	if (hashtable_find(symtable, hash, sym)) {
 		CodeError( "Multiple definitions for %s\n", sym );
 		return;
 	}
@@ -562,7 +948,7 @@ static void DefineSymbol( char *sym, int value ) {
 	s->value = value;
 	s->segment = currentSegment;
 
-	hashtable_add(symtable, hash, s);
+	hashtable_add(symtable, hash, s->name, s);
 
 /*
   Hash table lookup already speeds up symbol lookup enormously.
@@ -592,7 +978,6 @@ static int LookupSymbol( char *sym ) {
 	symbol_t	*s;
 	char		expanded[MAX_LINE_LENGTH];
 	int			hash;
-	hashchain_t *hc;
 
 	if ( passNumber == 0 ) {
 		return 0;
@@ -612,11 +997,9 @@ static int LookupSymbol( char *sym ) {
   Using a hash table with chain/bucket for lookups alone sped up q3asm by almost 3x for me.
  -PH
 */
-	for (hc = hashtable_get(symtable, hash); hc; hc = hc->next) {
-		s = (symbol_t*)hc->data;  /* ugly typecasting, but it's fast! */
-		if ( (hash == s->hash) && !strcmp(sym, s->name) ) {
-			return s->segment->segmentBase + s->value;
-		}
+	s = (symbol_t*)hashtable_find(symtable, hash, sym);
+	if ( s ) {
+		return s->segment->segmentBase + s->value;
 	}
 
 	CodeError( "error: symbol %s undefined\n", sym );
@@ -741,6 +1124,7 @@ static int ParseExpression(void) {
 	memcpy( sym, token, i );
 	sym[i] = 0;
 
+	expressionLiteral = qtrue;
 	switch (*sym) {  /* Resolve depending on first character. */
 /* Optimizing compilers can convert cases into "calculated jumps".  I think these are faster.  -PH */
 		case '-':
@@ -750,6 +1134,7 @@ static int ParseExpression(void) {
 			break;
 		default:
 			v = LookupSymbol(sym);
+			expressionLiteral = qfalse;
 			break;
 	}
 
@@ -803,6 +1188,7 @@ static void HackToSegment( segmentName_t seg ) {
 
 	currentSegment = &segment[seg];
 	if ( passNumber == 0 ) {
+		RecordLayout( LE_HACK, 0, seg, 0, NULL );
 		lastSymbol->segment = currentSegment;
 		lastSymbol->value = currentSegment->imageUsed;
 	}
@@ -814,6 +1200,351 @@ static void HackToSegment( segmentName_t seg ) {
 
 
 
+/*
+==============================================================================
+
+PEEPHOLE OPTIMIZER
+
+With -O, code is held back in a small window instead of being emitted
+as it is parsed, and sequences at the end of the window are rewritten
+before they reach the code segment.  The window is flushed at every
+label and procedure boundary, so rewrites never span a basic block and
+every label is defined against the optimized instruction count.
+
+Both passes must produce the same number of instructions, and symbols
+all read as 0 on the first pass.  Rewrites that depend on an operand's
+value are therefore only applied to literal operands.
+
+==============================================================================
+*/
+
+typedef struct {
+	int			opcode;
+	int			value;
+	int			operandSize;	// 0, 1 or 4 bytes
+	qboolean	literal;		// value does not come from a symbol
+} instruction_t;
+
+#define	MAX_PENDING_INSTRUCTIONS	8
+#define	MAX_JUMP_THREAD				16
+
+static instruction_t	pendingCode[MAX_PENDING_INSTRUCTIONS];
+static int				numPendingCode;
+
+static int		parsedOpcodes[OP_CVFI + 1];		// opcodes as lcc wrote them
+static int		emittedOpcodes[OP_CVFI + 1];	// opcodes written to the image
+static int		threadedJumps;
+
+static const char *opcodeNames[OP_CVFI + 1] = {
+	"UNDEF", "IGNORE", "BREAK", "ENTER", "LEAVE", "CALL", "PUSH", "POP",
+	"CONST", "LOCAL", "JUMP",
+	"EQ", "NE", "LTI", "LEI", "GTI", "GEI", "LTU", "LEU", "GTU", "GEU",
+	"EQF", "NEF", "LTF", "LEF", "GTF", "GEF",
+	"LOAD1", "LOAD2", "LOAD4", "STORE1", "STORE2", "STORE4", "ARG", "BLOCK_COPY",
+	"SEX8", "SEX16", "NEGI", "ADD", "SUB", "DIVI", "DIVU", "MODI", "MODU", "MULI", "MULU",
+	"BAND", "BOR", "BXOR", "BCOM", "LSH", "RSHI", "RSHU",
+	"NEGF", "ADDF", "SUBF", "DIVF", "MULF", "CVIF", "CVFI"
+};
+
+/*
+============
+WriteInstruction
+============
+*/
+static void WriteInstruction( const instruction_t *ins ) {
+	fileLayout_t	*layout;
+
+	// recorded as a whole instruction rather than as bytes
+	layout = recordingLayout;
+	recordingLayout = NULL;
+	EmitByte( &segment[CODESEG], ins->opcode );
+	if ( ins->operandSize == 4 ) {
+		EmitInt( &segment[CODESEG], ins->value );
+	} else if ( ins->operandSize == 1 ) {
+		EmitByte( &segment[CODESEG], ins->value );
+	}
+	instructionCount++;
+	recordingLayout = layout;
+	RecordLayout( LE_CODE, CODESEG, 1 + ins->operandSize, 1, NULL );
+	if ( passNumber == 1 ) {
+		emittedOpcodes[ins->opcode]++;
+	}
+}
+
+/*
+============
+FlushInstructions
+
+Called at every point a label could be defined
+============
+*/
+static void FlushInstructions( void ) {
+	int		i;
+
+	for ( i = 0 ; i < numPendingCode ; i++ ) {
+		WriteInstruction( &pendingCode[i] );
+	}
+	numPendingCode = 0;
+}
+
+/*
+============
+FoldConstants
+
+Folds an integer operation on two constants, the way the VM would
+============
+*/
+static qboolean FoldConstants( int opcode, int a, int b, int *out ) {
+	unsigned int	ua, ub;
+
+	ua = (unsigned int)a;
+	ub = (unsigned int)b;
+	switch ( opcode ) {
+	case OP_ADD:	*out = (int)( ua + ub ); return qtrue;
+	case OP_SUB:	*out = (int)( ua - ub ); return qtrue;
+	case OP_MULI:
+	case OP_MULU:	*out = (int)( ua * ub ); return qtrue;
+	case OP_BAND:	*out = a & b; return qtrue;
+	case OP_BOR:	*out = a | b; return qtrue;
+	case OP_BXOR:	*out = a ^ b; return qtrue;
+	default:
+		// division and shifts can trap or depend on the host, leave them
+		return qfalse;
+	}
+}
+
+/*
+============
+PeepholeOptimize
+
+Rewrites the end of the pending window until nothing more matches
+============
+*/
+static void PeepholeOptimize( void ) {
+	instruction_t	*a, *b, *c, *d;
+	int				v;
+
+	while ( numPendingCode >= 2 ) {
+		a = &pendingCode[numPendingCode - 2];
+		b = &pendingCode[numPendingCode - 1];
+
+		// CONST a, CONST b, op  ->  CONST (a op b)
+		if ( numPendingCode >= 3 ) {
+			c = &pendingCode[numPendingCode - 3];
+			if ( c->opcode == OP_CONST && a->opcode == OP_CONST
+				&& FoldConstants( b->opcode, c->value, a->value, &v ) ) {
+				c->value = v;
+				c->literal = c->literal && a->literal;
+				numPendingCode -= 2;
+				continue;
+			}
+		}
+
+		// CONST a, NEGI / BCOM  ->  CONST -a / ~a
+		if ( a->opcode == OP_CONST && ( b->opcode == OP_NEGI || b->opcode == OP_BCOM ) ) {
+			a->value = ( b->opcode == OP_NEGI ) ? (int)( 0u - (unsigned int)a->value ) : ~a->value;
+			numPendingCode--;
+			continue;
+		}
+
+		// x + 0, x - 0, x | 0, x ^ 0, x << 0, x >> 0, x * 1, x / 1  ->  x
+		if ( a->opcode == OP_CONST && a->literal ) {
+			if ( ( a->value == 0 && ( b->opcode == OP_ADD || b->opcode == OP_SUB
+					|| b->opcode == OP_BOR || b->opcode == OP_BXOR
+					|| b->opcode == OP_LSH || b->opcode == OP_RSHI || b->opcode == OP_RSHU ) )
+				|| ( a->value == 1 && ( b->opcode == OP_MULI || b->opcode == OP_MULU
+					|| b->opcode == OP_DIVI || b->opcode == OP_DIVU ) ) ) {
+				numPendingCode -= 2;
+				continue;
+			}
+		}
+
+		// a value that is only discarded is never computed
+		if ( b->opcode == OP_POP ) {
+			if ( a->opcode == OP_CONST || a->opcode == OP_LOCAL ) {
+				numPendingCode -= 2;
+				continue;
+			}
+			if ( numPendingCode >= 3 ) {
+				c = &pendingCode[numPendingCode - 3];
+				if ( ( a->opcode == OP_LOAD1 || a->opcode == OP_LOAD2 || a->opcode == OP_LOAD4 )
+					&& ( c->opcode == OP_CONST || c->opcode == OP_LOCAL ) ) {
+					numPendingCode -= 3;
+					continue;
+				}
+			}
+		}
+
+		// LOCAL x, LOCAL x, LOAD4, STORE4  ->  nothing
+		// only with literal offsets, a symbol is still 0 on the first pass
+		// and the rule has to fire the same way on both
+		if ( numPendingCode >= 4 && b->opcode == OP_STORE4 && a->opcode == OP_LOAD4 ) {
+			c = &pendingCode[numPendingCode - 3];
+			d = &pendingCode[numPendingCode - 4];
+			if ( c->opcode == OP_LOCAL && d->opcode == OP_LOCAL && c->literal && d->literal
+				&& c->value == d->value ) {
+				numPendingCode -= 4;
+				continue;
+			}
+		}
+
+		break;
+	}
+}
+
+/*
+============
+EmitInstruction
+
+All code goes through here.  value is ignored when operandSize is 0.
+============
+*/
+static void EmitInstruction( int opcode, int value, int operandSize, qboolean literal ) {
+	instruction_t	*ins;
+
+	if ( passNumber == 1 ) {
+		parsedOpcodes[opcode]++;
+	}
+
+	if ( !options.optimize ) {
+		instruction_t	direct;
+
+		direct.opcode = opcode;
+		direct.value = value;
+		direct.operandSize = operandSize;
+		direct.literal = literal;
+		WriteInstruction( &direct );
+		return;
+	}
+
+	if ( numPendingCode == MAX_PENDING_INSTRUCTIONS ) {
+		WriteInstruction( &pendingCode[0] );
+		memmove( pendingCode, pendingCode + 1, ( numPendingCode - 1 ) * sizeof( pendingCode[0] ) );
+		numPendingCode--;
+	}
+
+	ins = &pendingCode[numPendingCode++];
+	ins->opcode = opcode;
+	ins->value = value;
+	ins->operandSize = operandSize;
+	ins->literal = literal;
+
+	PeepholeOptimize();
+}
+
+/*
+============
+OperandSize
+
+Operand bytes that follow each opcode in a finished image
+============
+*/
+static int OperandSize( int opcode ) {
+	switch ( opcode ) {
+	case OP_ENTER:
+	case OP_LEAVE:
+	case OP_CONST:
+	case OP_LOCAL:
+	case OP_EQ: case OP_NE:
+	case OP_LTI: case OP_LEI: case OP_GTI: case OP_GEI:
+	case OP_LTU: case OP_LEU: case OP_GTU: case OP_GEU:
+	case OP_EQF: case OP_NEF:
+	case OP_LTF: case OP_LEF: case OP_GTF: case OP_GEF:
+	case OP_BLOCK_COPY:
+		return 4;
+	case OP_ARG:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static int ReadCodeInt( int offset ) {
+	byte	*p = &segment[CODESEG].image[offset];
+	return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( p[3] << 24 );
+}
+
+static void WriteCodeInt( int offset, int v ) {
+	byte	*p = &segment[CODESEG].image[offset];
+	p[0] = v & 255;
+	p[1] = ( v >> 8 ) & 255;
+	p[2] = ( v >> 16 ) & 255;
+	p[3] = ( v >> 24 ) & 255;
+}
+
+/*
+============
+ThreadJumps
+
+Once the image is complete, points every branch and direct jump whose
+target is itself a direct jump (CONST target, JUMP) at the final
+destination.  Instruction counts don't change, so labels stay valid.
+============
+*/
+static void ThreadJumps( void ) {
+	int		*offsets;
+	int		i, offset, target, hops;
+	byte	*code;
+
+	code = segment[CODESEG].image;
+	offsets = malloc( ( instructionCount + 1 ) * sizeof( *offsets ) );
+	offset = 0;
+	for ( i = 0 ; i < instructionCount ; i++ ) {
+		offsets[i] = offset;
+		offset += 1 + OperandSize( code[offset] );
+	}
+	offsets[instructionCount] = offset;
+
+	for ( i = 0 ; i < instructionCount ; i++ ) {
+		offset = offsets[i];
+		if ( ( code[offset] >= OP_EQ && code[offset] <= OP_GEF )
+			|| ( code[offset] == OP_CONST && i + 1 < instructionCount
+				&& code[offsets[i + 1]] == OP_JUMP ) ) {
+			target = ReadCodeInt( offset + 1 );
+			for ( hops = 0 ; hops < MAX_JUMP_THREAD ; hops++ ) {
+				if ( target < 0 || target + 1 >= instructionCount
+					|| code[offsets[target]] != OP_CONST
+					|| code[offsets[target + 1]] != OP_JUMP
+					|| target == i ) {
+					break;
+				}
+				target = ReadCodeInt( offsets[target] + 1 );
+			}
+			if ( hops && target != ReadCodeInt( offset + 1 ) ) {
+				WriteCodeInt( offset + 1, target );
+				threadedJumps++;
+			}
+		}
+	}
+
+	free( offsets );
+}
+
+/*
+============
+ReportOptimization
+============
+*/
+static void ReportOptimization( void ) {
+	int		i, before, after;
+
+	before = after = 0;
+	report( "opcode       before    after\n" );
+	for ( i = 0 ; i <= OP_CVFI ; i++ ) {
+		if ( !parsedOpcodes[i] && !emittedOpcodes[i] ) {
+			continue;
+		}
+		report( "%-10s %8i %8i\n", opcodeNames[i], parsedOpcodes[i], emittedOpcodes[i] );
+		before += parsedOpcodes[i];
+		after += emittedOpcodes[i];
+	}
+	report( "total      %8i %8i\n", before, after );
+	report( "%i jumps threaded\n", threadedJumps );
+}
+
+
+
+
 //#define STAT(L) report("STAT " L "\n");
 #define STAT(L)
 #define ASM(O) int TryAssemble##O ()
@@ -830,8 +1561,7 @@ ASM(CALL)
 {
 	if ( !strncmp( token, "CALL", 4 ) ) {
 STAT("CALL");
-		EmitByte( &segment[CODESEG], OP_CALL );
-		instructionCount++;
+		EmitInstruction( OP_CALL, 0, 0, qtrue );
 		currentArgOffset = 0;
 		return 1;
 	}
@@ -843,13 +1573,12 @@ ASM(ARG)
 {
 	if ( !strncmp( token, "ARG", 3 ) ) {
 STAT("ARG");
-		EmitByte( &segment[CODESEG], OP_ARG );
-		instructionCount++;
 		if ( 8 + currentArgOffset >= 256 ) {
 			CodeError( "currentArgOffset >= 256" );
+			EmitInstruction( OP_ARG, 0, 0, qtrue );
 			return 1;
 		}
-		EmitByte( &segment[CODESEG], 8 + currentArgOffset );
+		EmitInstruction( OP_ARG, 8 + currentArgOffset, 1, qtrue );
 		currentArgOffset += 4;
 		return 1;
 	}
@@ -861,9 +1590,7 @@ ASM(RET)
 {
 	if ( !strncmp( token, "RET", 3 ) ) {
 STAT("RET");
-		EmitByte( &segment[CODESEG], OP_LEAVE );
-		instructionCount++;
-		EmitInt( &segment[CODESEG], 8 + currentLocals + currentArgs );
+		EmitInstruction( OP_LEAVE, 8 + currentLocals + currentArgs, 4, qtrue );
 		return 1;
 	}
 	return 0;
@@ -875,8 +1602,7 @@ ASM(POP)
 {
 	if ( !strncmp( token, "pop", 3 ) ) {
 STAT("POP");
-		EmitByte( &segment[CODESEG], OP_POP );
-		instructionCount++;
+		EmitInstruction( OP_POP, 0, 0, qtrue );
 		return 1;
 	}
 	return 0;
@@ -888,12 +1614,10 @@ ASM(ADDRF)
 	int		v;
 	if ( !strncmp( token, "ADDRF", 5 ) ) {
 STAT("ADDRF");
-		instructionCount++;
 		Parse();
 		v = ParseExpression();
 		v = 16 + currentArgs + currentLocals + v;
-		EmitByte( &segment[CODESEG], OP_LOCAL );
-		EmitInt( &segment[CODESEG], v );
+		EmitInstruction( OP_LOCAL, v, 4, expressionLiteral );
 		return 1;
 	}
 	return 0;
@@ -905,12 +1629,10 @@ ASM(ADDRL)
 	int		v;
 	if ( !strncmp( token, "ADDRL", 5 ) ) {
 STAT("ADDRL");
-		instructionCount++;
 		Parse();
 		v = ParseExpression();
 		v = 8 + currentArgs + v;
-		EmitByte( &segment[CODESEG], OP_LOCAL );
-		EmitInt( &segment[CODESEG], v );
+		EmitInstruction( OP_LOCAL, v, 4, expressionLiteral );
 		return 1;
 	}
 	return 0;
@@ -924,7 +1646,9 @@ STAT("PROC");
 		Parse();					// function name
 		strcpy( name, token );
 
+		FlushInstructions();
 		DefineSymbol( token, instructionCount ); // segment[CODESEG].imageUsed );
+		RecordLayout( LE_PROC, 0, 0, 0, token );
 
 		currentLocals = ParseValue();	// locals
 		currentLocals = ( currentLocals + 3 ) & ~3;
@@ -935,9 +1659,7 @@ STAT("PROC");
 			CodeError( "Locals > 32k in %s\n", name );
 		}
 
-		instructionCount++;
-		EmitByte( &segment[CODESEG], OP_ENTER );
-		EmitInt( &segment[CODESEG], 8 + currentLocals + currentArgs );
+		EmitInstruction( OP_ENTER, 8 + currentLocals + currentArgs, 4, qtrue );
 		return 1;
 	}
 	return 0;
@@ -954,12 +1676,9 @@ STAT("ENDPROC");
 		v2 = ParseValue();		// arg marshalling
 
 		// all functions must leave something on the opstack
-		instructionCount++;
-		EmitByte( &segment[CODESEG], OP_PUSH );
-
-		instructionCount++;
-		EmitByte( &segment[CODESEG], OP_LEAVE );
-		EmitInt( &segment[CODESEG], 8 + currentLocals + currentArgs );
+		EmitInstruction( OP_PUSH, 0, 0, qtrue );
+		EmitInstruction( OP_LEAVE, 8 + currentLocals + currentArgs, 4, qtrue );
+		FlushInstructions();
 
 		return 1;
 	}
@@ -1008,6 +1727,7 @@ ASM(CODE)
 	if ( !strcmp( token, "code" ) ) {
 STAT("CODE");
 		currentSegment = &segment[CODESEG];
+		RecordLayout( LE_SEGMENT, 0, CODESEG, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1018,6 +1738,7 @@ ASM(BSS)
 	if ( !strcmp( token, "bss" ) ) {
 STAT("BSS");
 		currentSegment = &segment[BSSSEG];
+		RecordLayout( LE_SEGMENT, 0, BSSSEG, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1028,6 +1749,7 @@ ASM(DATA)
 	if ( !strcmp( token, "data" ) ) {
 STAT("DATA");
 		currentSegment = &segment[DATASEG];
+		RecordLayout( LE_SEGMENT, 0, DATASEG, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1038,6 +1760,7 @@ ASM(LIT)
 	if ( !strcmp( token, "lit" ) ) {
 STAT("LIT");
 		currentSegment = &segment[LITSEG];
+		RecordLayout( LE_SEGMENT, 0, LITSEG, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1070,6 +1793,7 @@ STAT("EQU");
 		strcpy( name, token );
 		Parse();
 		DefineSymbol( name, atoiNoCap(token) );
+		RecordLayout( LE_EQU, 0, atoiNoCap(token), 0, name );
 		return 1;
 	}
 	return 0;
@@ -1080,8 +1804,12 @@ ASM(ALIGN)
 	int		v;
 	if ( !strcmp( token, "align" ) ) {
 STAT("ALIGN");
+		if ( currentSegment == &segment[CODESEG] ) {
+			FlushInstructions();
+		}
 		v = ParseValue();
 		currentSegment->imageUsed = (currentSegment->imageUsed + v - 1 ) & ~( v - 1 );
+		RecordLayout( LE_ALIGN, 0, v, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1092,8 +1820,12 @@ ASM(SKIP)
 	int		v;
 	if ( !strcmp( token, "skip" ) ) {
 STAT("SKIP");
+		if ( currentSegment == &segment[CODESEG] ) {
+			FlushInstructions();
+		}
 		v = ParseValue();
 		currentSegment->imageUsed += v;
+		RecordLayout( LE_SKIP, 0, v, 0, NULL );
 		return 1;
 	}
 	return 0;
@@ -1138,10 +1870,12 @@ ASM(LABEL)
 STAT("LABEL");
 		Parse();
 		if ( currentSegment == &segment[CODESEG] ) {
+			FlushInstructions();
 			DefineSymbol( token, instructionCount );
 		} else {
 			DefineSymbol( token, currentSegment->imageUsed );
 		}
+		RecordLayout( LE_LABEL, 0, 0, 0, token );
 		return 1;
 	}
 	return 0;
@@ -1156,9 +1890,7 @@ AssembleLine
 ==============
 */
 static void AssembleLine( void ) {
-	hashchain_t *hc;
 	sourceOps_t *op;
-	int		i;
 	int		hash;
 
 	Parse();
@@ -1174,57 +1906,51 @@ static void AssembleLine( void ) {
   Always with the tree :)
  -PH
 */
-	for (hc = hashtable_get(optable, hash); hc; hc = hc->next) {
-		op = (sourceOps_t*)(hc->data);
-		i = op - sourceOps;
-		if ((hash == opcodesHash[i]) && (!strcmp(token, op->name))) {
-			int		opcode;
-			int		expression;
-
-			if ( op->opcode == OP_UNDEF ) {
-				CodeError( "Undefined opcode: %s\n", token );
-			}
-			if ( op->opcode == OP_IGNORE ) {
-				return;		// we ignore most conversions
-			}
+	op = (sourceOps_t*)hashtable_find(optable, hash, token);
+	if (op) {
+		int		opcode;
+		int		expression;
 
-			// sign extensions need to check next parm
-			opcode = op->opcode;
-			if ( opcode == OP_SEX8 ) {
-				Parse();
-				if ( token[0] == '1' ) {
-					opcode = OP_SEX8;
-				} else if ( token[0] == '2' ) {
-					opcode = OP_SEX16;
-				} else {
-					CodeError( "Bad sign extension: %s\n", token );
-					return;
-				}
-			}
+		if ( op->opcode == OP_UNDEF ) {
+			CodeError( "Undefined opcode: %s\n", token );
+		}
+		if ( op->opcode == OP_IGNORE ) {
+			return;		// we ignore most conversions
+		}
 
-			// check for expression
+		// sign extensions need to check next parm
+		opcode = op->opcode;
+		if ( opcode == OP_SEX8 ) {
 			Parse();
-			if ( token[0] && op->opcode != OP_CVIF
-					&& op->opcode != OP_CVFI ) {
-				expression = ParseExpression();
-
-				// code like this can generate non-dword block copies:
-				// auto char buf[2] = " ";
-				// we are just going to round up.  This might conceivably
-				// be incorrect if other initialized chars follow.
-				if ( opcode == OP_BLOCK_COPY ) {
-					expression = ( expression + 3 ) & ~3;
-				}
-
-				EmitByte( &segment[CODESEG], opcode );
-				EmitInt( &segment[CODESEG], expression );
+			if ( token[0] == '1' ) {
+				opcode = OP_SEX8;
+			} else if ( token[0] == '2' ) {
+				opcode = OP_SEX16;
 			} else {
-				EmitByte( &segment[CODESEG], opcode );
+				CodeError( "Bad sign extension: %s\n", token );
+				return;
 			}
+		}
 
-			instructionCount++;
-			return;
+		// check for expression
+		Parse();
+		if ( token[0] && op->opcode != OP_CVIF
+				&& op->opcode != OP_CVFI ) {
+			expression = ParseExpression();
+
+			// code like this can generate non-dword block copies:
+			// auto char buf[2] = " ";
+			// we are just going to round up.  This might conceivably
+			// be incorrect if other initialized chars follow.
+			if ( opcode == OP_BLOCK_COPY ) {
+				expression = ( expression + 3 ) & ~3;
+			}
+
+			EmitInstruction( opcode, expression, 4, expressionLiteral );
+		} else {
+			EmitInstruction( opcode, 0, 0, qtrue );
 		}
+		return;
 	}
 
 /* This falls through if an assembly opcode is not found.  -PH */
@@ -1296,11 +2022,11 @@ void InitTables( void ) {
 	int i;
 
 	symtable = hashtable_new(symtablelen);
-	optable = hashtable_new(100);  /* There's hardly 100 opcodes anyway. */
+	optable = hashtable_new(256);  /* There's hardly 100 opcodes anyway. */
 
 	for ( i = 0 ; i < NUM_SOURCE_OPS ; i++ ) {
 		opcodesHash[i] = HashString( sourceOps[i].name );
-		hashtable_add(optable, opcodesHash[i], sourceOps + i);
+		hashtable_add(optable, opcodesHash[i], sourceOps[i].name, sourceOps + i);
 	}
 }
 
@@ -1425,13 +2151,20 @@ static void Assemble( void ) {
 	int		i;
 	char	filename[MAX_OS_PATH];
 	char		*ptr;
+	unsigned INT64	hash;
+	fileLayout_t	*layout;
+	int		startSegment, startErrors;
 
 	report( "outputFilename: %s\n", outputFilename );
 
 	for ( i = 0 ; i < numAsmFiles ; i++ ) {
 		strcpy( filename, asmFileNames[ i ] );
 		DefaultExtension( filename, ".asm" );
-		LoadFile( filename, (void **)&asmFiles[i] );
+		asmFileLengths[i] = LoadFile( filename, (void **)&asmFiles[i] );
+	}
+
+	if ( options.cacheLayout ) {
+		ReadLayoutCache();
 	}
 
 	// assemble
@@ -1451,11 +2184,27 @@ static void Assemble( void ) {
 			currentFileLine = 0;
 			report("pass %i: %s\n", passNumber, currentFileName );
 			fflush( NULL );
+
+			if ( passNumber == 0 && options.cacheLayout ) {
+				hash = HashFileContents( asmFiles[i], asmFileLengths[i] );
+				startSegment = currentSegment ? currentSegment - segment : -1;
+				layout = FindFileLayout( hash, asmFileLengths[i], startSegment );
+				if ( layout ) {
+					ReplayFileLayout( layout );
+					continue;
+				}
+				BeginFileLayout( hash, asmFileLengths[i], startSegment );
+			}
+			startErrors = errorCount;
+
 			ptr = asmFiles[i];
 			while ( ptr ) {
 				ptr = ExtractLine( ptr );
 				AssembleLine();
 			}
+			FlushInstructions();
+
+			EndFileLayout( errorCount == startErrors );
 		}
 
 		// align all segment
@@ -1467,6 +2216,16 @@ static void Assemble( void ) {
 		}
 	}
 
+	if ( options.cacheLayout ) {
+		report( "%i files laid out from cache, %i parsed\n", filesReplayed, numAsmFiles - filesReplayed );
+		WriteLayoutCache();
+	}
+
+	if ( options.optimize ) {
+		ThreadJumps();
+		ReportOptimization();
+	}
+
 	// reserve the stack in bss
 	DefineSymbol( "_stackStart", segment[BSSSEG].imageUsed );
 	segment[BSSSEG].imageUsed += stackSize;
@@ -1525,6 +2284,8 @@ Assemble LCC bytecode assembly to Q3VM bytecode.\n\
     -b BUCKETS     Set symbol hash table to BUCKETS buckets\n\
     -v             Verbose compilation report\n\
     -vq3           Produce a qvm file compatible with Q3 1.32b\n\
+    -O             Run the peephole optimizer and jump threading\n\
+    -c             Cache the pass 0 layout of each file in OUTPUT.q3asmcache\n\
     -h --help -?   Show this help\n\
 ", argv0);
 }
@@ -1608,6 +2369,16 @@ Motivation: not wanting to scrollback for pages to find asm error.
 			continue;
 		}
 
+		if( !strcmp( argv[ i ], "-O" ) ) {
+			options.optimize = qtrue;
+			continue;
+		}
+
+		if( !strcmp( argv[ i ], "-c" ) ) {
+			options.cacheLayout = qtrue;
+			continue;
+		}
+
 		Error( "Unknown option: %s", argv[i] );
 	}
 
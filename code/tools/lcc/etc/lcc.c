@@ -497,7 +497,7 @@ static void help(void) {
 "-lx	search library `x'\n",
 "-N	do not search the standard directories for #include files\n",
 "-n	emit code to check for dereferencing zero pointers\n",
-"-O	is ignored\n",
+"-O	optimize the generated bytecode\n",
 "-o file	leave the output in `file'\n",
 "-P	print ANSI-style declarations for globals\n",
 "-p -pg	emit profiling code; see prof(1) and gprof(1)\n",
@@ -648,10 +648,7 @@ static void opt(char *arg) {
 		case 'S':
 			Sflag++;
 			return;
-		case 'O':
-			fprintf(stderr, "%s: %s ignored\n", progname, arg);
-			return;
-		case 'A': case 'n': case 'w': case 'P':
+		case 'A': case 'n': case 'w': case 'P': case 'O':
 			clist = append(arg, clist);
 			return;
 		case 'g': case 'b':
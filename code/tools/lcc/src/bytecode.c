@@ -1,6 +1,7 @@
 #include "c.h"
 #define I(f) b_##f
 
+static int optimize;	/* -O */
 
 static void I(segment)(int n) {
 	static int cseg;
@@ -196,12 +197,66 @@ static void gen01(Node p) {
 	}
 }
 
+/*
+ * sexload - is p a sign extension of a 1 or 2 byte load?  The VM
+ * zero extends narrow loads, so the value differs from the loaded
+ * bits only above the loaded size.
+ */
+static int sexload(Node p) {
+	return specific(p->op) == CVI+I
+	    && generic(p->kids[0]->op) == INDIR
+	    && optype(p->kids[0]->op) == I
+	    && opsize(p->kids[0]->op) < 4;
+}
+
+static void optimize01(Node p) {
+	int i, n, bits;
+	long c;
+
+	if (p == NULL)
+		return;
+	optimize01(p->kids[0]);
+	optimize01(p->kids[1]);
+	switch (generic(p->op)) {
+	case MUL:
+		/* x * 2^n => x << n */
+		if (optype(p->op) != I && optype(p->op) != U)
+			break;
+		for (i = 0; i < 2; i++)
+			if (generic(p->kids[i]->op) == CNST
+			&& (optype(p->op) == U || p->kids[i]->syms[0]->u.c.v.i > 0)
+			&& (n = ispow2(p->kids[i]->syms[0]->u.c.v.u)) != 0) {
+				p->op = LSH + (p->op - generic(p->op));
+				p->kids[0] = p->kids[1-i];
+				p->kids[1] = newnode(CNST + ttob(inttype), NULL, NULL, intconst(n));
+				break;
+			}
+		break;
+	case EQ: case NE:
+		/* (int)(char)x == c => x == (c & 0xff), dropping the sign extension */
+		if (optype(p->op) != I || !sexload(p->kids[0])
+		|| generic(p->kids[1]->op) != CNST)
+			break;
+		bits = 8*opsize(p->kids[0]->kids[0]->op);
+		c = p->kids[1]->syms[0]->u.c.v.i;
+		if (c < -(1L<<(bits - 1)) || c >= (1L<<(bits - 1)))
+			break;
+		p->kids[0] = p->kids[0]->kids[0];
+		p->kids[1] = newnode(CNST + ttob(inttype), NULL, NULL,
+			intconst((int)(c & ((1L<<bits) - 1))));
+		break;
+	}
+}
+
 static Node I(gen)(Node p) {
 	Node q;
 
 	assert(p);
-	for (q = p; q; q = q->link)
+	for (q = p; q; q = q->link) {
+		if (optimize)
+			optimize01(q);
 		gen01(q);
+	}
 	return p;
 }
 
@@ -221,7 +276,13 @@ static void I(local)(Symbol p) {
 	offset += p->type->size;
 }
 
-static void I(progbeg)(int argc, char *argv[]) {}
+static void I(progbeg)(int argc, char *argv[]) {
+	int i;
+
+	for (i = 1; i < argc; i++)
+		if (strcmp(argv[i], "-O") == 0)
+			optimize = rematerialize = 1;
+}
 
 static void I(progend)(void) {}
 
@@ -479,6 +479,7 @@ struct field {
 };
 extern int assignargs;
 extern int prunetemps;
+extern int rematerialize;
 extern int nodecount;
 extern Symbol cfunc;
 extern Symbol retv;
@@ -14,12 +14,14 @@ int nodecount;
 static Tree firstarg;
 int assignargs = 1;
 int prunetemps = -1;
+int rematerialize = 0;	/* reload cheap common subexpressions instead of using temps */
 static Node *tail;
 
 static int depth = 0;
 static Node replace(Node);
 static Node prune(Node);
 static Node asgnnode(Symbol, Node);
+static int cheapnode(Node);
 static struct dag *dagnode(int, Node, Node, Symbol);
 static Symbol equated(Symbol);
 static void fixup(Node);
@@ -641,6 +643,14 @@ static Node visit(Node p, int listed) {
 			p->kids[0] = visit(p->kids[0], 0);
 			p->kids[1] = visit(p->kids[1], 0);
 		}
+		else if (rematerialize && !listed && cheapnode(p)) {
+			if (generic(p->op) == INDIR)
+				p = newnode(p->op, newnode(p->kids[0]->op, NULL, NULL,
+					p->kids[0]->syms[0]), NULL, NULL);
+			else
+				p = newnode(p->op, NULL, NULL, p->syms[0]);
+			p->count = 1;
+		}
 		else {
 			p->kids[0] = visit(p->kids[0], 0);
 			p->kids[1] = visit(p->kids[1], 0);
@@ -657,6 +667,16 @@ static Node visit(Node p, int listed) {
 	}
 	return p;
 }
+/* cheapnode - is p no more expensive to recompute than to load from a temporary? */
+static int cheapnode(Node p) {
+	switch (generic(p->op)) {
+	case CNST: case ADDRG:
+		return 1;
+	case INDIR:
+		return optype(p->op) != B && isaddrop(p->kids[0]->op);
+	}
+	return 0;
+}
 static Node tmpnode(Node p) {
 	Symbol tmp = p->syms[2];
 
@@ -621,7 +621,8 @@ typedef struct {
 #define MAX_STATUSLENGTH		64
 #define MAX_LISTBOXWIDTH		59
 #define UI_FONT_THRESHOLD		0.1
-#define MAX_DISPLAY_SERVERS		2048
+#define MAX_DISPLAY_SERVERS		MAX_GLOBAL_SERVERS
+#define MAX_SERVERKEYLENGTH		64
 #define MAX_SERVERSTATUS_LINES	128
 #define MAX_SERVERSTATUS_TEXT	1024
 #define MAX_FOUNDPLAYER_SERVERS	16
@@ -700,6 +701,20 @@ typedef struct {
 } pinglist_t;
 
 
+// local copy of the fields the browser filters and sorts on, so sorting
+// never has to go back through the engine for every comparison
+typedef struct {
+	qboolean	valid;
+	int			ping;
+	int			clients;
+	int			humans;
+	int			maxClients;
+	int			gameType;
+	char		game[MAX_NAME_LENGTH];
+	char		hostKey[MAX_SERVERKEYLENGTH];	// color stripped and lowercased
+	char		mapKey[MAX_NAME_LENGTH];		// lowercased
+} serverEntry_t;
+
 typedef struct serverStatus_s {
 	pinglist_t pingList[MAX_PINGREQUESTS];
 	int		numqueriedservers;
@@ -716,6 +731,9 @@ typedef struct serverStatus_s {
 	int		displayServers[MAX_DISPLAY_SERVERS];
 	int		numDisplayServers;
 	int		numPlayersOnServers;
+	serverEntry_t serverEntries[MAX_DISPLAY_SERVERS];
+	int		serverEntrySource;
+	int		lastSortTime;
 	int		nextDisplayRefresh;
 	int		nextSortTime;
 	qhandle_t currentServerPreview;
@@ -874,6 +874,12 @@ void UI_ParseMenu(const char *menuFile) {
 	int handle;
 	pc_token_t token;
 
+	// already loaded since the last Menu_Reset
+	if (Menu_FileParsed(menuFile)) {
+		return;
+	}
+	Menu_MarkFileParsed(menuFile);
+
 	Com_Printf("Parsing menu file:%s\n", menuFile);
 
 	handle = trap_PC_LoadSource(menuFile);
@@ -2751,13 +2757,73 @@ static float UI_GetValue(int ownerDraw) {
   return 0;
 }
 
+/*
+=================
+UI_ClearServerEntries
+
+Forget the cached sort keys, the server indexes they belong to are about
+to be reused for a different list
+=================
+*/
+static void UI_ClearServerEntries( void ) {
+	memset( uiInfo.serverStatus.serverEntries, 0, sizeof( uiInfo.serverStatus.serverEntries ) );
+	uiInfo.serverStatus.serverEntrySource = ui_netSource.integer;
+}
+
+/*
+=================
+UI_CompareServerEntries
+
+Same ordering the engine's LAN_CompareServers gives, using the keys
+cached when the server was added to the display list
+=================
+*/
+static int UI_CompareServerEntries( int s1, int s2 ) {
+	serverEntry_t	*e1, *e2;
+	int				res;
+
+	e1 = &uiInfo.serverStatus.serverEntries[s1];
+	e2 = &uiInfo.serverStatus.serverEntries[s2];
+
+	switch ( uiInfo.serverStatus.sortKey ) {
+	case SORT_HOST:
+		res = strcmp( e1->hostKey, e2->hostKey );
+		break;
+	case SORT_MAP:
+		res = strcmp( e1->mapKey, e2->mapKey );
+		break;
+	case SORT_CLIENTS:
+		res = e1->clients - e2->clients;
+		break;
+	case SORT_GAME:
+		res = e1->gameType - e2->gameType;
+		break;
+	case SORT_PING:
+		res = e1->ping - e2->ping;
+		break;
+	default:
+		res = 0;
+		break;
+	}
+
+	if ( res < 0 ) {
+		res = -1;
+	} else if ( res > 0 ) {
+		res = 1;
+	}
+	if ( uiInfo.serverStatus.sortDir ) {
+		res = -res;
+	}
+	return res;
+}
+
 /*
 =================
 UI_ServersQsortCompare
 =================
 */
 static int QDECL UI_ServersQsortCompare( const void *arg1, const void *arg2 ) {
-	return trap_LAN_CompareServers( ui_netSource.integer, uiInfo.serverStatus.sortKey, uiInfo.serverStatus.sortDir, *(int*)arg1, *(int*)arg2);
+	return UI_CompareServerEntries( *(int*)arg1, *(int*)arg2 );
 }
 
 
@@ -2767,6 +2833,7 @@ UI_ServersSort
 =================
 */
 void UI_ServersSort(int column, qboolean force) {
+	int		start;
 
 	if ( !force ) {
 		if ( uiInfo.serverStatus.sortKey == column ) {
@@ -2775,7 +2842,13 @@ void UI_ServersSort(int column, qboolean force) {
 	}
 
 	uiInfo.serverStatus.sortKey = column;
+	start = trap_Milliseconds();
 	qsort( &uiInfo.serverStatus.displayServers[0], uiInfo.serverStatus.numDisplayServers, sizeof(int), UI_ServersQsortCompare);
+	uiInfo.serverStatus.lastSortTime = trap_Milliseconds() - start;
+
+	if ( trap_Cvar_VariableValue( "developer" ) ) {
+		Com_Printf( "sorted %i servers in %i msec\n", uiInfo.serverStatus.numDisplayServers, uiInfo.serverStatus.lastSortTime );
+	}
 }
 
 /*
@@ -3452,6 +3525,8 @@ static void UI_RunMenuScript(char **args) {
 				Q_strncpyz(addr, 	Info_ValueForKey(buff, "addr"), MAX_NAME_LENGTH);
 				if (strlen(addr) > 0) {
 					trap_LAN_RemoveServer(AS_FAVORITES, addr);
+					// favorites after the removed one shift down a slot
+					UI_ClearServerEntries();
 				}
 			}
 		} else if (Q_stricmp(name, "createFavorite") == 0) {
@@ -3667,9 +3742,12 @@ static void UI_InsertServerIntoDisplayList(int num, int position) {
 	if (position < 0 || position > uiInfo.serverStatus.numDisplayServers ) {
 		return;
 	}
+	if (uiInfo.serverStatus.numDisplayServers >= MAX_DISPLAY_SERVERS) {
+		return;
+	}
 	//
 	uiInfo.serverStatus.numDisplayServers++;
-	for (i = uiInfo.serverStatus.numDisplayServers; i > position; i--) {
+	for (i = uiInfo.serverStatus.numDisplayServers - 1; i > position; i--) {
 		uiInfo.serverStatus.displayServers[i] = uiInfo.serverStatus.displayServers[i-1];
 	}
 	uiInfo.serverStatus.displayServers[position] = num;
@@ -3710,8 +3788,7 @@ static void UI_BinaryServerInsertion(int num) {
 	while(mid > 0) {
 		mid = len >> 1;
 		//
-		res = trap_LAN_CompareServers( ui_netSource.integer, uiInfo.serverStatus.sortKey,
-					uiInfo.serverStatus.sortDir, num, uiInfo.serverStatus.displayServers[offset+mid]);
+		res = UI_CompareServerEntries( num, uiInfo.serverStatus.displayServers[offset+mid] );
 		// if equal
 		if (res == 0) {
 			UI_InsertServerIntoDisplayList(num, offset+mid);
@@ -3733,14 +3810,49 @@ static void UI_BinaryServerInsertion(int num) {
 	UI_InsertServerIntoDisplayList(num, offset);
 }
 
+/*
+==================
+UI_GetServerEntry
+
+Returns the cached filter and sort fields for a server, only going
+through the engine for the info string when the ping has changed
+since it was last read
+==================
+*/
+static serverEntry_t *UI_GetServerEntry(int num, int ping) {
+	serverEntry_t *entry;
+	char info[MAX_STRING_CHARS];
+
+	entry = &uiInfo.serverStatus.serverEntries[num];
+	if (entry->valid && ping > 0 && entry->ping == ping) {
+		return entry;
+	}
+
+	trap_LAN_GetServerInfo(ui_netSource.integer, num, info, MAX_STRING_CHARS);
+
+	entry->valid = qtrue;
+	entry->ping = ping;
+	entry->clients = atoi(Info_ValueForKey(info, "clients"));
+	entry->humans = atoi(Info_ValueForKey(info, "g_humanplayers"));
+	entry->maxClients = atoi(Info_ValueForKey(info, "sv_maxclients"));
+	entry->gameType = atoi(Info_ValueForKey(info, "gametype"));
+	Q_strncpyz(entry->game, Info_ValueForKey(info, "game"), sizeof(entry->game));
+	Q_strncpyz(entry->hostKey, Info_ValueForKey(info, "hostname"), sizeof(entry->hostKey));
+	Q_CleanStr(entry->hostKey);
+	Q_strlwr(entry->hostKey);
+	Q_strncpyz(entry->mapKey, Info_ValueForKey(info, "mapname"), sizeof(entry->mapKey));
+	Q_strlwr(entry->mapKey);
+	return entry;
+}
+
 /*
 ==================
 UI_BuildServerDisplayList
 ==================
 */
 static void UI_BuildServerDisplayList(qboolean force) {
-	int i, count, clients, maxClients, ping, game, len, visible;
-	char info[MAX_STRING_CHARS];
+	int i, count, clients, ping, len, visible, humansOnly;
+	serverEntry_t *entry;
 //	qboolean startRefresh = qtrue; TTimo: unused
 	static int numinvisible;
 
@@ -3775,6 +3887,11 @@ static void UI_BuildServerDisplayList(qboolean force) {
 		trap_LAN_MarkServerVisible(ui_netSource.integer, -1, qtrue);
 	}
 
+	// cached entries are indexed by server number within one source
+	if (uiInfo.serverStatus.serverEntrySource != ui_netSource.integer) {
+		UI_ClearServerEntries();
+	}
+
 	// get the server count (comes from the master)
 	count = trap_LAN_GetServerCount(ui_netSource.integer);
 	if (count == -1 || (ui_netSource.integer == AS_LOCAL && count == 0) ) {
@@ -3785,6 +3902,11 @@ static void UI_BuildServerDisplayList(qboolean force) {
 		return;
 	}
 
+	if (count > MAX_DISPLAY_SERVERS) {
+		count = MAX_DISPLAY_SERVERS;
+	}
+
+	humansOnly = (int)trap_Cvar_VariableValue("ui_humansonly");
 	visible = qfalse;
 	for (i = 0; i < count; i++) {
 		// if we already got info for this server
@@ -3796,12 +3918,13 @@ static void UI_BuildServerDisplayList(qboolean force) {
 		ping = trap_LAN_GetServerPing(ui_netSource.integer, i);
 		if (ping > 0 || ui_netSource.integer == AS_FAVORITES) {
 
-			trap_LAN_GetServerInfo(ui_netSource.integer, i, info, MAX_STRING_CHARS);
+			entry = UI_GetServerEntry(i, ping);
 
-                        if(trap_Cvar_VariableValue("ui_humansonly"))
-                            clients = atoi(Info_ValueForKey(info, "g_humanplayers"));
-                        else
-                            clients = atoi(Info_ValueForKey(info, "clients"));
+			if (humansOnly) {
+				clients = entry->humans;
+			} else {
+				clients = entry->clients;
+			}
 			uiInfo.serverStatus.numPlayersOnServers += clients;
 
 			if (ui_browserShowEmpty.integer == 0) {
@@ -3812,23 +3935,21 @@ static void UI_BuildServerDisplayList(qboolean force) {
 			}
 
 			if (ui_browserShowFull.integer == 0) {
-				maxClients = atoi(Info_ValueForKey(info, "sv_maxclients"));
-				if (clients == maxClients) {
+				if (clients == entry->maxClients) {
 					trap_LAN_MarkServerVisible(ui_netSource.integer, i, qfalse);
 					continue;
 				}
 			}
 
 			if (uiInfo.joinGameTypes[ui_joinGameType.integer].gtEnum != -1) {
-				game = atoi(Info_ValueForKey(info, "gametype"));
-				if (game != uiInfo.joinGameTypes[ui_joinGameType.integer].gtEnum) {
+				if (entry->gameType != uiInfo.joinGameTypes[ui_joinGameType.integer].gtEnum) {
 					trap_LAN_MarkServerVisible(ui_netSource.integer, i, qfalse);
 					continue;
 				}
 			}
 				
 			if (ui_serverFilterType.integer > 0) {
-				if (Q_stricmp(Info_ValueForKey(info, "game"), serverFilters[ui_serverFilterType.integer].basedir) != 0) {
+				if (Q_stricmp(entry->game, serverFilters[ui_serverFilterType.integer].basedir) != 0) {
 					trap_LAN_MarkServerVisible(ui_netSource.integer, i, qfalse);
 					continue;
 				}
@@ -5977,6 +6098,8 @@ static void UI_StartServerRefresh(qboolean full)
 	trap_LAN_MarkServerVisible(ui_netSource.integer, -1, qtrue);
 	// reset all the pings
 	trap_LAN_ResetPings(ui_netSource.integer);
+	// the list is about to be replaced, so are the cached sort keys
+	UI_ClearServerEntries();
 	//
 	if( ui_netSource.integer == AS_LOCAL ) {
 		trap_Cmd_ExecuteText( EXEC_NOW, "localservers\n" );
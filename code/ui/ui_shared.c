@@ -57,6 +57,13 @@ static itemDef_t *g_editItem = NULL;
 menuDef_t Menus[MAX_MENUS];      // defined menus
 int menuCount = 0;               // how many
 
+#define MENU_HASH_SIZE 64
+static int menuHash[MENU_HASH_SIZE];	// first menu index per name hash, -1 if none
+static int menuHashNext[MAX_MENUS];
+
+static char menuFiles[MAX_MENUFILES][MAX_QPATH];	// files parsed since the last Menu_Reset
+static int menuFileCount = 0;
+
 menuDef_t *menuStack[MAX_OPEN_MENUS];
 int openMenuCount = 0;
 
@@ -66,6 +73,8 @@ static qboolean debugMode = qfalse;
 static int lastListBoxClickTime = 0;
 
 void Item_RunScript(itemDef_t *item, const char *s);
+static void Script_ClearCompiled(void);
+static void Script_Compile(const char *s);
 void Item_SetupKeywordHash(void);
 void Menu_SetupKeywordHash(void);
 int BindingIDFromName(const char *name);
@@ -239,6 +248,8 @@ void String_Init(void) {
 	menuCount = 0;
 	openMenuCount = 0;
 	UI_InitMemory();
+	Script_ClearCompiled();
+	Menu_Reset();
 	Item_SetupKeywordHash();
 	Menu_SetupKeywordHash();
 	if (DC && DC->getBindingBuf) {
@@ -524,6 +535,7 @@ qboolean PC_Script_Parse(int handle, const char **out) {
 
 		if (Q_stricmp(token.string, "}") == 0) {
 			*out = String_Alloc(script);
+			Script_Compile(*out);
 			return qtrue;
 		}
 
@@ -766,10 +778,59 @@ void Menu_UpdatePosition(menuDef_t *menu) {
   }
 }
 
+/*
+=================
+Menu_BuildItemHash
+
+Chains every item under its name and its group so scripts can find
+them without comparing against the whole menu
+=================
+*/
+static void Menu_BuildItemHash(menuDef_t *menu) {
+	itemMatch_t *matches;
+	itemDef_t *item;
+	const char *keys[2];
+	int i, j, hash, count;
+
+	memset(menu->itemHash, 0, sizeof(menu->itemHash));
+	menu->itemHashed = qfalse;
+	if (menu->itemCount == 0) {
+		menu->itemHashed = qtrue;
+		return;
+	}
+
+	matches = UI_Alloc(sizeof(itemMatch_t) * menu->itemCount * 2);
+	if (matches == NULL) {
+		// fall back to scanning the item list
+		return;
+	}
+
+	// add in reverse so every chain ends up in item order
+	count = 0;
+	for (i = menu->itemCount - 1; i >= 0; i--) {
+		item = menu->items[i];
+		keys[0] = item->window.group;
+		keys[1] = item->window.name;
+		for (j = 0; j < 2; j++) {
+			if (keys[j] == NULL || keys[j][0] == '\0') {
+				continue;
+			}
+			hash = hashForString(keys[j]) & (MENU_ITEMHASH_SIZE - 1);
+			matches[count].key = keys[j];
+			matches[count].item = item;
+			matches[count].next = menu->itemHash[hash];
+			menu->itemHash[hash] = &matches[count];
+			count++;
+		}
+	}
+	menu->itemHashed = qtrue;
+}
+
 void Menu_PostParse(menuDef_t *menu) {
 	if (menu == NULL) {
 		return;
 	}
+	Menu_BuildItemHash(menu);
 	if (menu->fullScreen) {
 		menu->window.rect.x = 0;
 		menu->window.rect.y = 0;
@@ -813,29 +874,56 @@ qboolean Rect_ContainsPoint(rectDef_t *rect, float x, float y) {
   return qfalse;
 }
 
-int Menu_ItemsMatchingGroup(menuDef_t *menu, const char *name) {
-  int i;
-  int count = 0;
-  for (i = 0; i < menu->itemCount; i++) {
-    if (Q_stricmp(menu->items[i]->window.name, name) == 0 || (menu->items[i]->window.group && Q_stricmp(menu->items[i]->window.group, name) == 0)) {
-      count++;
-    } 
+/*
+=================
+Menu_FindMatchingItems
+
+Fills out with the items whose name or group is name, in menu order
+=================
+*/
+static int Menu_FindMatchingItems(menuDef_t *menu, const char *name, itemDef_t **out, int max) {
+  itemMatch_t *match;
+  itemDef_t *last;
+  int i, count;
+
+  count = 0;
+  if (menu == NULL || name == NULL) {
+    return 0;
+  }
+
+  if (!menu->itemHashed) {
+    for (i = 0; i < menu->itemCount && count < max; i++) {
+      if (Q_stricmp(menu->items[i]->window.name, name) == 0 || (menu->items[i]->window.group && Q_stricmp(menu->items[i]->window.group, name) == 0)) {
+        out[count++] = menu->items[i];
+      }
+    }
+    return count;
+  }
+
+  last = NULL;
+  match = menu->itemHash[hashForString(name) & (MENU_ITEMHASH_SIZE - 1)];
+  for ( ; match && count < max; match = match->next) {
+    // an item whose name and group both match is chained twice in a row
+    if (match->item != last && Q_stricmp(match->key, name) == 0) {
+      out[count++] = match->item;
+      last = match->item;
+    }
   }
   return count;
 }
 
+int Menu_ItemsMatchingGroup(menuDef_t *menu, const char *name) {
+  itemDef_t *items[MAX_MENUITEMS];
+  return Menu_FindMatchingItems(menu, name, items, MAX_MENUITEMS);
+}
+
 itemDef_t *Menu_GetMatchingItemByNumber(menuDef_t *menu, int index, const char *name) {
-  int i;
-  int count = 0;
-  for (i = 0; i < menu->itemCount; i++) {
-    if (Q_stricmp(menu->items[i]->window.name, name) == 0 || (menu->items[i]->window.group && Q_stricmp(menu->items[i]->window.group, name) == 0)) {
-      if (count == index) {
-        return menu->items[i];
-      }
-      count++;
-    } 
+  itemDef_t *items[MAX_MENUITEMS];
+  int count = Menu_FindMatchingItems(menu, name, items, MAX_MENUITEMS);
+  if (index < 0 || index >= count) {
+    return NULL;
   }
-  return NULL;
+  return items[index];
 }
 
 
@@ -896,6 +984,16 @@ itemDef_t *Menu_FindItemByName(menuDef_t *menu, const char *p) {
     return NULL;
   }
 
+  if (menu->itemHashed) {
+    itemMatch_t *match;
+    for (match = menu->itemHash[hashForString(p) & (MENU_ITEMHASH_SIZE - 1)]; match; match = match->next) {
+      if (match->key == match->item->window.name && Q_stricmp(p, match->key) == 0) {
+        return match->item;
+      }
+    }
+    return NULL;
+  }
+
   for (i = 0; i < menu->itemCount; i++) {
     if (Q_stricmp(p, menu->items[i]->window.name) == 0) {
       return menu->items[i];
@@ -925,15 +1023,16 @@ void Script_SetItemColor(itemDef_t *item, char **args) {
   // expecting type of color to set and 4 args for the color
   if (String_Parse(args, &itemname) && String_Parse(args, &name)) {
     itemDef_t *item2;
+    itemDef_t *matches[MAX_MENUITEMS];
     int j;
-    int count = Menu_ItemsMatchingGroup(item->parent, itemname);
+    int count = Menu_FindMatchingItems(item->parent, itemname, matches, MAX_MENUITEMS);
 
     if (!Color_Parse(args, &color)) {
       return;
     }
 
     for (j = 0; j < count; j++) {
-      item2 = Menu_GetMatchingItemByNumber(item->parent, j, itemname);
+      item2 = matches[j];
       if (item2 != NULL) {
         out = NULL;
         if (Q_stricmp(name, "backcolor") == 0) {
@@ -958,10 +1057,11 @@ void Script_SetItemColor(itemDef_t *item, char **args) {
 
 void Menu_ShowItemByName(menuDef_t *menu, const char *p, qboolean bShow) {
 	itemDef_t *item;
+	itemDef_t *matches[MAX_MENUITEMS];
 	int i;
-	int count = Menu_ItemsMatchingGroup(menu, p);
+	int count = Menu_FindMatchingItems(menu, p, matches, MAX_MENUITEMS);
 	for (i = 0; i < count; i++) {
-		item = Menu_GetMatchingItemByNumber(menu, i, p);
+		item = matches[i];
 		if (item != NULL) {
 			if (bShow) {
 				item->window.flags |= WINDOW_VISIBLE;
@@ -979,10 +1079,11 @@ void Menu_ShowItemByName(menuDef_t *menu, const char *p, qboolean bShow) {
 
 void Menu_FadeItemByName(menuDef_t *menu, const char *p, qboolean fadeOut) {
   itemDef_t *item;
+  itemDef_t *matches[MAX_MENUITEMS];
   int i;
-  int count = Menu_ItemsMatchingGroup(menu, p);
+  int count = Menu_FindMatchingItems(menu, p, matches, MAX_MENUITEMS);
   for (i = 0; i < count; i++) {
-    item = Menu_GetMatchingItemByNumber(menu, i, p);
+    item = matches[i];
     if (item != NULL) {
       if (fadeOut) {
         item->window.flags |= (WINDOW_FADINGOUT | WINDOW_VISIBLE);
@@ -995,9 +1096,45 @@ void Menu_FadeItemByName(menuDef_t *menu, const char *p, qboolean fadeOut) {
   }
 }
 
+/*
+=================
+Menus_HashMenu
+
+Called once a menu has been parsed, keeps the first menu of any name
+so lookups behave like the old front to back scan
+=================
+*/
+static void Menus_HashMenu(int index) {
+  int hash, i;
+
+  menuHashNext[index] = -1;
+  if (Menus[index].window.name == NULL) {
+    return;
+  }
+
+  hash = hashForString(Menus[index].window.name) & (MENU_HASH_SIZE - 1);
+  if (menuHash[hash] < 0) {
+    menuHash[hash] = index;
+    return;
+  }
+  for (i = menuHash[hash]; ; i = menuHashNext[i]) {
+    if (Q_stricmp(Menus[i].window.name, Menus[index].window.name) == 0) {
+      return;
+    }
+    if (menuHashNext[i] < 0) {
+      menuHashNext[i] = index;
+      return;
+    }
+  }
+}
+
 menuDef_t *Menus_FindByName(const char *p) {
   int i;
-  for (i = 0; i < menuCount; i++) {
+
+  if (p == NULL) {
+    return NULL;
+  }
+  for (i = menuHash[hashForString(p) & (MENU_HASH_SIZE - 1)]; i >= 0 && i < menuCount; i = menuHashNext[i]) {
     if (Q_stricmp(Menus[i].window.name, p) == 0) {
       return &Menus[i];
     } 
@@ -1103,10 +1240,11 @@ void Script_Close(itemDef_t *item, char **args) {
 
 void Menu_TransitionItemByName(menuDef_t *menu, const char *p, rectDef_t rectFrom, rectDef_t rectTo, int time, float amt) {
   itemDef_t *item;
+  itemDef_t *matches[MAX_MENUITEMS];
   int i;
-  int count = Menu_ItemsMatchingGroup(menu, p);
+  int count = Menu_FindMatchingItems(menu, p, matches, MAX_MENUITEMS);
   for (i = 0; i < count; i++) {
-    item = Menu_GetMatchingItemByNumber(menu, i, p);
+    item = matches[i];
     if (item != NULL) {
       item->window.flags |= (WINDOW_INTRANSITION | WINDOW_VISIBLE);
       item->window.offsetTime = time;
@@ -1138,10 +1276,11 @@ void Script_Transition(itemDef_t *item, char **args) {
 
 void Menu_OrbitItemByName(menuDef_t *menu, const char *p, float x, float y, float cx, float cy, int time) {
   itemDef_t *item;
+  itemDef_t *matches[MAX_MENUITEMS];
   int i;
-  int count = Menu_ItemsMatchingGroup(menu, p);
+  int count = Menu_FindMatchingItems(menu, p, matches, MAX_MENUITEMS);
   for (i = 0; i < count; i++) {
-    item = Menu_GetMatchingItemByNumber(menu, i, p);
+    item = matches[i];
     if (item != NULL) {
       item->window.flags |= (WINDOW_ORBITING | WINDOW_VISIBLE);
       item->window.offsetTime = time;
@@ -1261,37 +1400,208 @@ commandDef_t commandList[] =
 int scriptCommandCount = sizeof(commandList) / sizeof(commandDef_t);
 
 
+/*
+===============
+Compiled scripts
+
+Scripts are split into commands once, when they are parsed, with each
+command already resolved to its handler.  Arguments are still read by
+the handlers themselves, straight from the script text.
+===============
+*/
+
+#define SCRIPT_HASH_SIZE	256
+#define MAX_SCRIPT_OPS		64
+
+typedef struct {
+	commandDef_t	*command;	// NULL passes the command to DC->runScript
+	short			args;		// offset of the first argument
+	short			end;		// offset just past the last argument
+} scriptOp_t;
+
+typedef struct compiledScript_s {
+	const char		*text;
+	int				numOps;
+	scriptOp_t		*ops;
+	struct compiledScript_s *next;
+} compiledScript_t;
+
+static compiledScript_t *compiledScripts[SCRIPT_HASH_SIZE];
+static int scriptGeneration;
+
+static int Script_Hash(const char *s) {
+	return (int)(((size_t)s >> 4) & (SCRIPT_HASH_SIZE - 1));
+}
+
+static commandDef_t *Script_FindCommand(const char *name) {
+	int i;
+
+	for (i = 0; i < scriptCommandCount; i++) {
+		if (Q_stricmp(name, commandList[i].name) == 0) {
+			return &commandList[i];
+		}
+	}
+	return NULL;
+}
+
+static compiledScript_t *Script_FindCompiled(const char *s) {
+	compiledScript_t *script;
+
+	for (script = compiledScripts[Script_Hash(s)]; script; script = script->next) {
+		if (script->text == s) {
+			return script;
+		}
+	}
+	return NULL;
+}
+
+/*
+=================
+Script_ClearCompiled
+
+The compiled scripts live in the UI memory pool and point into the
+string pool, so they go whenever those are reset
+=================
+*/
+static void Script_ClearCompiled(void) {
+	memset(compiledScripts, 0, sizeof(compiledScripts));
+	scriptGeneration++;
+}
+
+/*
+=================
+Script_Compile
+=================
+*/
+static void Script_Compile(const char *s) {
+	scriptOp_t ops[MAX_SCRIPT_OPS];
+	compiledScript_t *script;
+	char *p, *last, *token;
+	int numOps, hash;
+
+	if (s == NULL || s[0] == '\0' || strlen(s) >= 1024 || Script_FindCompiled(s)) {
+		return;
+	}
+
+	numOps = 0;
+	p = (char *)s;
+	while (1) {
+		// expect command then arguments, ; ends command
+		token = COM_ParseExt(&p, qfalse);
+		if (!p || token[0] == '\0') {
+			break;
+		}
+		if (token[0] == ';' && token[1] == '\0') {
+			continue;
+		}
+		if (numOps == MAX_SCRIPT_OPS) {
+			// leave it to the interpreter
+			return;
+		}
+
+		ops[numOps].command = Script_FindCommand(token);
+		ops[numOps].args = p - s;
+		last = p;
+		while (1) {
+			token = COM_ParseExt(&p, qfalse);
+			if (!p || (token[0] == ';' && token[1] == '\0')) {
+				break;
+			}
+			if (token[0] == '\0') {
+				// an empty argument stops the interpreter wherever it lands
+				return;
+			}
+			last = p;
+		}
+		ops[numOps].end = last - s;
+		numOps++;
+
+		if (!p) {
+			break;
+		}
+	}
+
+	script = UI_Alloc(sizeof(compiledScript_t) + numOps * sizeof(scriptOp_t));
+	if (script == NULL) {
+		return;
+	}
+	script->text = s;
+	script->numOps = numOps;
+	script->ops = (scriptOp_t *)(script + 1);
+	memcpy(script->ops, ops, numOps * sizeof(scriptOp_t));
+
+	hash = Script_Hash(s);
+	script->next = compiledScripts[hash];
+	compiledScripts[hash] = script;
+}
+
+/*
+=================
+Item_InterpretScript
+
+Runs a script straight from its text
+=================
+*/
+static void Item_InterpretScript(itemDef_t *item, char *p) {
+  commandDef_t *command;
+
+  while (1) {
+    const char *name;
+    // expect command then arguments, ; ends command, NULL ends script
+    if (!String_Parse(&p, &name)) {
+      return;
+    }
+
+    if (name[0] == ';' && name[1] == '\0') {
+      continue;
+    }
+
+    command = Script_FindCommand(name);
+    if (command) {
+      command->handler(item, &p);
+    } else {
+      // not in our auto list, pass to handler
+      DC->runScript(&p);
+    }
+  }
+}
+
 void Item_RunScript(itemDef_t *item, const char *s) {
   char script[1024], *p;
-  int i;
-  qboolean bRan;
-  memset(script, 0, sizeof(script));
+  compiledScript_t *compiled;
+  int i, generation;
+
   if (item && s && s[0]) {
-    Q_strcat(script, 1024, s);
-    p = script;
-    while (1) {
-      const char *command;
-      // expect command then arguments, ; ends command, NULL ends script
-      if (!String_Parse(&p, &command)) {
+    // commands may reload the menus, so always run from a copy
+    Q_strncpyz(script, s, sizeof(script));
+
+    compiled = Script_FindCompiled(s);
+    if (!compiled) {
+      Script_Compile(s);
+      compiled = Script_FindCompiled(s);
+      if (!compiled) {
+        Item_InterpretScript(item, script);
         return;
       }
+    }
 
-      if (command[0] == ';' && command[1] == '\0') {
-        continue;
-      }
+    generation = scriptGeneration;
+    for (i = 0; i < compiled->numOps; i++) {
+      scriptOp_t *op = &compiled->ops[i];
 
-      bRan = qfalse;
-      for (i = 0; i < scriptCommandCount; i++) {
-        if (Q_stricmp(command, commandList[i].name) == 0) {
-          (commandList[i].handler(item, &p));
-          bRan = qtrue;
-          break;
-        }
-      }
-      // not in our auto list, pass to handler
-      if (!bRan) {
+      p = script + op->args;
+      if (op->command) {
+        op->command->handler(item, &p);
+      } else {
         DC->runScript(&p);
       }
+
+      // a handler that did not take exactly its own arguments, or that
+      // reloaded the menus, leaves the rest of the script to the interpreter
+      if (p != script + op->end || generation != scriptGeneration) {
+        Item_InterpretScript(item, p);
+        return;
+      }
     }
   }
 }
@@ -5604,6 +5914,7 @@ void Menu_New(int handle) {
 		Menu_Init(menu);
 		if (Menu_Parse(handle, menu)) {
 			Menu_PostParse(menu);
+			Menus_HashMenu(menuCount);
 			menuCount++;
 		}
 	}
@@ -5630,7 +5941,45 @@ void Menu_PaintAll(void) {
 }
 
 void Menu_Reset(void) {
+	int i;
+
 	menuCount = 0;
+	for (i = 0; i < MENU_HASH_SIZE; i++) {
+		menuHash[i] = -1;
+	}
+	menuFileCount = 0;
+}
+
+/*
+=================
+Menu_FileParsed
+
+Menu files are only read between resets, so one that has already been
+parsed can be skipped rather than adding its menus a second time
+=================
+*/
+qboolean Menu_FileParsed(const char *menuFile) {
+	int i;
+
+	for (i = 0; i < menuFileCount; i++) {
+		if (Q_stricmp(menuFiles[i], menuFile) == 0) {
+			return qtrue;
+		}
+	}
+	return qfalse;
+}
+
+/*
+=================
+Menu_MarkFileParsed
+=================
+*/
+void Menu_MarkFileParsed(const char *menuFile) {
+	if (menuFileCount >= MAX_MENUFILES || Menu_FileParsed(menuFile)) {
+		return;
+	}
+	Q_strncpyz(menuFiles[menuFileCount], menuFile, sizeof(menuFiles[0]));
+	menuFileCount++;
 }
 
 displayContextDef_t *Display_GetContext(void) {
@@ -38,6 +38,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #define MAX_MENUITEMS 96
 #define MAX_COLOR_RANGES 10
 #define MAX_OPEN_MENUS 16
+#define MAX_MENUFILES 32
+#define MENU_ITEMHASH_SIZE 32
 
 #define WINDOW_MOUSEOVER			0x00000001	// mouse is over it, non exclusive
 #define WINDOW_HASFOCUS				0x00000002	// has cursor focus, exclusive
@@ -250,6 +252,13 @@ typedef struct itemDef_s {
 	void *typeData;								 // type specific data ptr's	
 } itemDef_t;
 
+// one per item name and group, chained by name hash within a menu
+typedef struct itemMatch_s {
+  const char *key;                 // item name or group
+  itemDef_t *item;
+  struct itemMatch_s *next;
+} itemMatch_t;
+
 typedef struct {
   Window window;
   const char  *font;								// font
@@ -268,6 +277,8 @@ typedef struct {
   vec4_t focusColor;								// focus color for items
   vec4_t disableColor;							// focus color for items
   itemDef_t *items[MAX_MENUITEMS];	// items this menu contains   
+  itemMatch_t *itemHash[MENU_ITEMHASH_SIZE];	// built by Menu_PostParse
+  qboolean itemHashed;
 } menuDef_t;
 
 typedef struct {
@@ -414,6 +425,8 @@ void Menu_New(int handle);
 void Menu_PaintAll( void );
 menuDef_t *Menus_ActivateByName(const char *p);
 void Menu_Reset( void );
+qboolean Menu_FileParsed(const char *menuFile);
+void Menu_MarkFileParsed(const char *menuFile);
 qboolean Menus_AnyFullScreenVisible( void );
 void  Menus_Activate(menuDef_t *menu);
 